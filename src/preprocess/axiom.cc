@@ -1,6 +1,7 @@
 #include "helper_functions.h"
 #include "axiom.h"
 #include "variable.h"
+#include "task_writer.h"
 
 #include <iostream>
 #include <fstream>
@@ -53,14 +54,14 @@ int Axiom::get_encoding_size() const {
     return 1 + conditions.size();
 }
 
-void Axiom::generate_cpp_input(ofstream &outfile) const {
+void Axiom::generate_cpp_input(TaskWriter &outfile) const {
     assert(effect_var->get_level() != -1);
     outfile << "begin_rule" << endl;
     outfile << conditions.size() << endl;
     for (int i = 0; i < conditions.size(); i++) {
         assert(conditions[i].var->get_level() != -1);
-        outfile << conditions[i].var->get_level() << " " << conditions[i].cond << endl;
+        outfile << conditions[i].var->get_level() << conditions[i].cond << endl;
     }
-    outfile << effect_var->get_level() << " " << old_val << " " << effect_val << endl;
+    outfile << effect_var->get_level() << old_val << effect_val << endl;
     outfile << "end_rule" << endl;
 }
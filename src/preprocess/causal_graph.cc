@@ -28,6 +28,7 @@
 #include "axiom.h"
 #include "scc.h"
 #include "variable.h"
+#include "task_writer.h"
 
 #include <iostream>
 #include <cassert>
@@ -284,7 +285,7 @@ void CausalGraph::dump() const {
             cout << "  [" << it->first->get_name() << ", " << it->second << "]" << endl;
     }
 }
-void CausalGraph::generate_cpp_input(ofstream &outfile,
+void CausalGraph::generate_cpp_input(TaskWriter &outfile,
                                      const vector<Variable *> &ordered_vars)
 const {
     //TODO: use const iterator!
@@ -321,7 +322,7 @@ const {
                 )
                 // the variable it->first is important and influenced by variable i
                 // print level and weight of influence
-                outfile << it->first->get_level() << " " << it->second << endl;
+                outfile << it->first->get_level() << it->second << endl;
         }
     }
 }
@@ -8,6 +8,7 @@ using namespace std;
 
 class Operator;
 class Axiom;
+class TaskWriter;
 class Variable;
 
 class CausalGraph {
@@ -48,7 +49,7 @@ public:
     const vector<Variable *> &get_variable_ordering() const;
     bool is_acyclic() const;
     void dump() const;
-    void generate_cpp_input(ofstream &outfile,
+    void generate_cpp_input(TaskWriter &outfile,
                             const vector<Variable *> &ordered_vars) const;
 };
 
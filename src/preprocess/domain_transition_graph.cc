@@ -13,6 +13,7 @@
 #include "axiom.h"
 #include "variable.h"
 #include "scc.h"
+#include "task_writer.h"
 
 #include <algorithm>
 #include <cassert>
@@ -244,7 +245,7 @@ void DomainTransitionGraph::dump() const {
     }
 }
 
-void DomainTransitionGraph::generate_cpp_input(ofstream &outfile) const {
+void DomainTransitionGraph::generate_cpp_input(TaskWriter &outfile) const {
     //outfile << vertices.size() << endl; // the variable's range
     for (int i = 0; i < vertices.size(); i++) {
         outfile << vertices[i].size() << endl; // number of transitions from this value
@@ -260,8 +261,8 @@ void DomainTransitionGraph::generate_cpp_input(ofstream &outfile) const {
             outfile << number << endl;
             for (int k = 0; k < trans.condition.size(); k++)
                 if (trans.condition[k].first->get_level() != -1)
-                    outfile << trans.condition[k].first->get_level() <<
-                    " " << trans.condition[k].second << endl;  // condition: var, val
+                    outfile << trans.condition[k].first->get_level()
+                            << trans.condition[k].second << endl;  // condition: var, val
         }
     }
 }
@@ -8,6 +8,7 @@ using namespace std;
 #include "operator.h"
 
 class Axiom;
+class TaskWriter;
 class Variable;
 
 class DomainTransitionGraph {
@@ -37,7 +38,7 @@ public:
     void addAxTransition(int from, int to, const Axiom &ax, int ax_index);
     void finalize();
     void dump() const;
-    void generate_cpp_input(ofstream &outfile) const;
+    void generate_cpp_input(TaskWriter &outfile) const;
     bool is_strongly_connected() const;
 };
 
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
@@ -14,6 +15,7 @@ using namespace std;
 #include "variable.h"
 #include "successor_generator.h"
 #include "domain_transition_graph.h"
+#include "task_writer.h"
 
 
 static const int SAS_FILE_VERSION = 3;
@@ -166,12 +168,20 @@ void generate_cpp_input(bool /*solvable_in_poly_time*/,
                         const vector<Axiom> &axioms,
                         const SuccessorGenerator &sg,
                         const vector<DomainTransitionGraph> transition_graphs,
-                        const CausalGraph &cg) {
+                        const CausalGraph &cg,
+                        bool binary) {
     /* NOTE: solvable_in_poly_time flag is no longer included in output,
        since the planner doesn't handle it specially any more anyway. */
 
-    ofstream outfile;
-    outfile.open("output", ios::out);
+    TaskWriter outfile("output", binary);
+    int max_range = 0;
+    for (int i = 0; i < ordered_vars.size(); i++)
+        max_range = max(max_range, ordered_vars[i]->get_range());
+    bool unit_cost = true;
+    for (int i = 0; i < operators.size(); i++)
+        if (operators[i].get_cost() != 1)
+            unit_cost = false;
+    outfile.write_header(max_range, !metric || unit_cost);
 
     outfile << "begin_version" << endl;
     outfile << PRE_FILE_VERSION << endl;
@@ -205,7 +215,7 @@ void generate_cpp_input(bool /*solvable_in_poly_time*/,
     outfile << goals.size() << endl;
     for (int i = 0; i < var_count; i++)
         if (ordered_goal_values[i] != -1)
-            outfile << i << " " << ordered_goal_values[i] << endl;
+            outfile << i << ordered_goal_values[i] << endl;
     outfile << "end_goal" << endl;
 
     outfile << operators.size() << endl;
@@ -229,6 +239,4 @@ void generate_cpp_input(bool /*solvable_in_poly_time*/,
     outfile << "begin_CG" << endl;
     cg.generate_cpp_input(outfile, ordered_vars);
     outfile << "end_CG" << endl;
-
-    outfile.close();
 }
@@ -48,7 +48,8 @@ void generate_cpp_input(bool causal_graph_acyclic,
                         const vector<Axiom> &axioms,
                         const SuccessorGenerator &sg,
                         const vector<DomainTransitionGraph> transition_graphs,
-                        const CausalGraph &cg);
+                        const CausalGraph &cg,
+                        bool binary);
 void check_magic(istream &in, string magic);
 
 #endif
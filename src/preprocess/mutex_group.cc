@@ -2,6 +2,7 @@
 
 #include "helper_functions.h"
 #include "variable.h"
+#include "task_writer.h"
 
 MutexGroup::MutexGroup(istream &in, const vector<Variable *> &variables) {
     int size;
@@ -29,12 +30,12 @@ void MutexGroup::dump() const {
     }
 }
 
-void MutexGroup::generate_cpp_input(ofstream &outfile) const {
+void MutexGroup::generate_cpp_input(TaskWriter &outfile) const {
     outfile << "begin_mutex_group" << endl
             << facts.size() << endl;
     for (size_t i = 0; i < facts.size(); ++i) {
         outfile << facts[i].first->get_level()
-                << " " << facts[i].second << endl;
+                << facts[i].second << endl;
     }
     outfile << "end_mutex_group" << endl;
 }
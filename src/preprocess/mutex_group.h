@@ -5,6 +5,7 @@
 #include <vector>
 using namespace std;
 
+class TaskWriter;
 class Variable;
 
 class MutexGroup {
@@ -16,7 +17,7 @@ public:
     bool is_redundant() const;
 
     int get_encoding_size() const;
-    void generate_cpp_input(ofstream &outfile) const;
+    void generate_cpp_input(TaskWriter &outfile) const;
     void dump() const;
 };
 
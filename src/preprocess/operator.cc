@@ -1,6 +1,7 @@
 #include "helper_functions.h"
 #include "operator.h"
 #include "variable.h"
+#include "task_writer.h"
 
 #include <cassert>
 #include <iostream>
@@ -96,7 +97,7 @@ void strip_operators(vector<Operator> &operators) {
     cout << operators.size() << " of " << old_count << " operators necessary." << endl;
 }
 
-void Operator::generate_cpp_input(ofstream &outfile) const {
+void Operator::generate_cpp_input(TaskWriter &outfile) const {
     //TODO: beim Einlesen in search feststellen, ob leerer Operator
     outfile << "begin_operator" << endl;
     outfile << name << endl;
@@ -105,7 +106,7 @@ void Operator::generate_cpp_input(ofstream &outfile) const {
     for (int i = 0; i < prevail.size(); i++) {
         assert(prevail[i].var->get_level() != -1);
         if (prevail[i].var->get_level() != -1)
-            outfile << prevail[i].var->get_level() << " " << prevail[i].prev << endl;
+            outfile << prevail[i].var->get_level() << prevail[i].prev << endl;
     }
 
     outfile << pre_post.size() << endl;
@@ -113,11 +114,11 @@ void Operator::generate_cpp_input(ofstream &outfile) const {
         assert(pre_post[i].var->get_level() != -1);
         outfile << pre_post[i].effect_conds.size();
         for (int j = 0; j < pre_post[i].effect_conds.size(); j++)
-            outfile << " " << pre_post[i].effect_conds[j].var->get_level()
-                    << " " << pre_post[i].effect_conds[j].cond;
-        outfile << " " << pre_post[i].var->get_level()
-                << " " << pre_post[i].pre
-                << " " << pre_post[i].post << endl;
+            outfile << pre_post[i].effect_conds[j].var->get_level()
+                    << pre_post[i].effect_conds[j].cond;
+        outfile << pre_post[i].var->get_level()
+                << pre_post[i].pre
+                << pre_post[i].post << endl;
     }
     outfile << cost << endl;
     outfile << "end_operator" << endl;
@@ -7,6 +7,7 @@
 #include <vector>
 using namespace std;
 
+class TaskWriter;
 class Variable;
 
 class Operator {
@@ -46,7 +47,7 @@ public:
 
     void dump() const;
     int get_encoding_size() const;
-    void generate_cpp_input(ofstream &outfile) const;
+    void generate_cpp_input(TaskWriter &outfile) const;
     int get_cost() const {return cost; }
     string get_name() const {return name; }
     const vector<Prevail> &get_prevail() const {return prevail; }
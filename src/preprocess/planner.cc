@@ -18,7 +18,7 @@
 #include <iostream>
 using namespace std;
 
-int main(int argc, const char **) {
+int main(int argc, const char **argv) {
     bool metric;
     vector<Variable *> variables;
     vector<Variable> internal_variables;
@@ -29,9 +29,16 @@ int main(int argc, const char **) {
     vector<Axiom> axioms;
     vector<DomainTransitionGraph> transition_graphs;
 
-    if (argc != 1) {
-        cout << "*** do not perform relevance analysis ***" << endl;
-        g_do_not_prune_variables = true;
+    // --binary writes a binary task image (see TaskWriter). Any other
+    // argument disables the relevance analysis.
+    bool binary_output = false;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--binary") {
+            binary_output = true;
+        } else if (!g_do_not_prune_variables) {
+            cout << "*** do not perform relevance analysis ***" << endl;
+            g_do_not_prune_variables = true;
+        }
     }
 
     read_preprocessed_problem_description
@@ -102,6 +109,6 @@ int main(int argc, const char **) {
     generate_cpp_input(solveable_in_poly_time, ordering, metric,
                        mutexes, initial_state, goals,
                        operators, axioms, successor_generator,
-                       transition_graphs, causal_graph);
+                       transition_graphs, causal_graph, binary_output);
     cout << "done" << endl << endl;
 }
@@ -1,6 +1,7 @@
 #include "operator.h"
 #include "successor_generator.h"
 #include "variable.h"
+#include "task_writer.h"
 
 #include <algorithm>
 #include <functional>
@@ -30,7 +31,7 @@ class GeneratorBase {
 public:
     virtual ~GeneratorBase() {}
     virtual void dump(string indent) const = 0;
-    virtual void generate_cpp_input(ofstream &outfile) const = 0;
+    virtual void generate_cpp_input(TaskWriter &outfile) const = 0;
 };
 
 class GeneratorSwitch : public GeneratorBase {
@@ -45,7 +46,7 @@ public:
                     const vector<GeneratorBase *> &gen_for_val,
                     GeneratorBase *default_gen);
     virtual void dump(string indent) const;
-    virtual void generate_cpp_input(ofstream &outfile) const;
+    virtual void generate_cpp_input(TaskWriter &outfile) const;
 };
 
 class GeneratorLeaf : public GeneratorBase {
@@ -53,13 +54,13 @@ class GeneratorLeaf : public GeneratorBase {
 public:
     GeneratorLeaf(list<int> &operators);
     virtual void dump(string indent) const;
-    virtual void generate_cpp_input(ofstream &outfile) const;
+    virtual void generate_cpp_input(TaskWriter &outfile) const;
 };
 
 class GeneratorEmpty : public GeneratorBase {
 public:
     virtual void dump(string indent) const;
-    virtual void generate_cpp_input(ofstream &outfile) const;
+    virtual void generate_cpp_input(TaskWriter &outfile) const;
 };
 
 GeneratorSwitch::GeneratorSwitch(Variable *switch_variable,
@@ -92,11 +93,11 @@ void GeneratorSwitch::dump(string indent) const {
     default_generator->dump(indent + "  ");
 }
 
-void GeneratorSwitch::generate_cpp_input(ofstream &outfile) const {
+void GeneratorSwitch::generate_cpp_input(TaskWriter &outfile) const {
     int level = switch_var->get_level();
     assert(level != -1);
-    outfile << "switch " << level << endl;
-    outfile << "check " << immediate_ops_indices.size() << endl;
+    outfile << "switch" << level << endl;
+    outfile << "check" << immediate_ops_indices.size() << endl;
     for (list<int>::const_iterator op_iter = immediate_ops_indices.begin();
          op_iter != immediate_ops_indices.end(); ++op_iter)
         outfile << *op_iter << endl;
@@ -119,8 +120,8 @@ void GeneratorLeaf::dump(string indent) const {
         cout << indent << *op_iter << endl;
 }
 
-void GeneratorLeaf::generate_cpp_input(ofstream &outfile) const {
-    outfile << "check " << applicable_ops_indices.size() << endl;
+void GeneratorLeaf::generate_cpp_input(TaskWriter &outfile) const {
+    outfile << "check" << applicable_ops_indices.size() << endl;
     for (list<int>::const_iterator op_iter = applicable_ops_indices.begin();
          op_iter != applicable_ops_indices.end(); ++op_iter)
         outfile << *op_iter << endl;
@@ -130,8 +131,8 @@ void GeneratorEmpty::dump(string indent) const {
     cout << indent << "<empty>" << endl;
 }
 
-void GeneratorEmpty::generate_cpp_input(ofstream &outfile) const {
-    outfile << "check 0" << endl;
+void GeneratorEmpty::generate_cpp_input(TaskWriter &outfile) const {
+    outfile << "check" << 0 << endl;
 }
 
 SuccessorGenerator::SuccessorGenerator(const vector<Variable *> &variables,
@@ -241,6 +242,6 @@ void SuccessorGenerator::dump() const {
     cout << "Successor Generator:" << endl;
     root->dump("  ");
 }
-void SuccessorGenerator::generate_cpp_input(ofstream &outfile) const {
+void SuccessorGenerator::generate_cpp_input(TaskWriter &outfile) const {
     root->generate_cpp_input(outfile);
 }
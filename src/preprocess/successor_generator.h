@@ -9,6 +9,7 @@ using namespace std;
 
 class GeneratorBase;
 class Operator;
+class TaskWriter;
 class Variable;
 
 class SuccessorGenerator {
@@ -30,7 +31,7 @@ public:
                        const vector<Operator> &operators);
     ~SuccessorGenerator();
     void dump() const;
-    void generate_cpp_input(ofstream &outfile) const;
+    void generate_cpp_input(TaskWriter &outfile) const;
 };
 
 #endif
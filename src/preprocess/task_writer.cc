@@ -0,0 +1,88 @@
+#include "task_writer.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+using namespace std;
+
+TaskWriter::TaskWriter(const string &filename, bool binary_)
+    : binary(binary_), at_line_start(true) {
+    outfile.open(filename.c_str(), binary ? ios::out | ios::binary : ios::out);
+    if (!outfile) {
+        cerr << "Could not open " << filename << endl;
+        exit(1);
+    }
+}
+
+TaskWriter::~TaskWriter() {
+    outfile.close();
+}
+
+void TaskWriter::write_header(int max_range, bool unit_cost) {
+    if (!binary)
+        return;
+    assert(outfile.tellp() == 0);
+    outfile << "task_image " << TASK_IMAGE_VERSION << " " << max_range << " "
+            << (unit_cost ? "unit" : "nonunit") << "\n";
+    while (outfile.tellp() % 4 != 0)
+        outfile.put(0);
+    write_binary_int(BYTE_ORDER_MARK);
+}
+
+void TaskWriter::write_binary_int(int value) {
+    outfile.write(reinterpret_cast<const char *>(&value), sizeof(int));
+}
+
+void TaskWriter::write_binary_string(const string &value) {
+    write_binary_int(value.size());
+    outfile.write(value.data(), value.size());
+    for (size_t i = value.size(); i % 4 != 0; ++i)
+        outfile.put(0);
+}
+
+void TaskWriter::start_item() {
+    if (!at_line_start)
+        outfile << " ";
+    at_line_start = false;
+}
+
+TaskWriter &TaskWriter::operator<<(int value) {
+    if (binary) {
+        write_binary_int(value);
+    } else {
+        start_item();
+        outfile << value;
+    }
+    return *this;
+}
+
+TaskWriter &TaskWriter::operator<<(size_t value) {
+    return *this << static_cast<int>(value);
+}
+
+TaskWriter &TaskWriter::operator<<(bool value) {
+    return *this << static_cast<int>(value);
+}
+
+TaskWriter &TaskWriter::operator<<(const string &value) {
+    if (binary) {
+        write_binary_string(value);
+    } else {
+        start_item();
+        outfile << value;
+    }
+    return *this;
+}
+
+TaskWriter &TaskWriter::operator<<(const char *value) {
+    return *this << string(value);
+}
+
+TaskWriter &TaskWriter::operator<<(ostream &(*)(ostream &)) {
+    // The only manipulator that is used is endl.
+    if (!binary) {
+        outfile << "\n";
+        at_line_start = true;
+    }
+    return *this;
+}
@@ -0,0 +1,54 @@
+#ifndef TASK_WRITER_H
+#define TASK_WRITER_H
+
+#include <fstream>
+#include <string>
+using namespace std;
+
+/*
+  Writes the preprocessed task for the search component, either in the
+  text format or as a binary task image.
+
+  Text format: items that are written to the same line are separated by
+  single spaces, and endl ends the line.
+
+  Binary task image: the file starts with the text line
+    task_image <TASK_IMAGE_VERSION> <maximal variable range> <unit|nonunit>
+  (so that the scripts that inspect the task do not have to decode the
+  image), followed by zero bytes up to the next multiple of 4 bytes.
+  The rest of the file consists of 32-bit integers in native byte order:
+  first BYTE_ORDER_MARK, then the items of the text format in the same
+  order. Numbers are stored as one integer. Strings (including magic
+  words) are stored as their length followed by their characters,
+  padded with zero bytes to a multiple of 4 bytes. Line breaks are not
+  stored. The search component maps the image into memory and reads it
+  without parsing text (see TaskReader in the search code).
+*/
+class TaskWriter {
+    ofstream outfile;
+    const bool binary;
+    bool at_line_start;
+
+    void write_binary_int(int value);
+    void write_binary_string(const string &value);
+    void start_item();
+public:
+    static const int TASK_IMAGE_VERSION = 1;
+    static const int BYTE_ORDER_MARK = 0x01020304;
+
+    TaskWriter(const string &filename, bool binary);
+    ~TaskWriter();
+
+    // Must be called before anything else is written.
+    void write_header(int max_range, bool unit_cost);
+
+    TaskWriter &operator<<(int value);
+    TaskWriter &operator<<(size_t value);
+    TaskWriter &operator<<(bool value);
+    TaskWriter &operator<<(const string &value);
+    TaskWriter &operator<<(const char *value);
+    // Handles endl.
+    TaskWriter &operator<<(ostream &(*manipulator)(ostream &));
+};
+
+#endif
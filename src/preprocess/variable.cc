@@ -1,6 +1,7 @@
 #include "variable.h"
 
 #include "helper_functions.h"
+#include "task_writer.h"
 
 #include <cassert>
 using namespace std;
@@ -54,7 +55,7 @@ void Variable::dump() const {
     cout << "]" << endl;
 }
 
-void Variable::generate_cpp_input(ofstream &outfile) const {
+void Variable::generate_cpp_input(TaskWriter &outfile) const {
     outfile << "begin_variable" << endl
             << name << endl
             << layer << endl
@@ -5,6 +5,8 @@
 #include <vector>
 using namespace std;
 
+class TaskWriter;
+
 class Variable {
     vector<string> values;
     string name;
@@ -21,7 +23,7 @@ public:
     string get_name() const;
     int get_layer() const {return layer; }
     bool is_derived() const {return layer != -1; }
-    void generate_cpp_input(ofstream &outfile) const;
+    void generate_cpp_input(TaskWriter &outfile) const;
     void dump() const;
     string get_fact_name(int value) const {return values[value]; }
 };
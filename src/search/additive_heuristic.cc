@@ -5,6 +5,7 @@
 #include "plugin.h"
 #include "state.h"
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 using namespace std;
@@ -15,12 +16,39 @@ using namespace std;
 // construction and destruction
 AdditiveHeuristic::AdditiveHeuristic(const Options &opts)
     : RelaxationHeuristic(opts),
-      did_write_overflow_warning(false) {
+      did_write_overflow_warning(false),
+      incremental(opts.get<bool>("incremental")),
+      has_explored_state(false) {
+}
+
+AdditiveHeuristic::AdditiveHeuristic(const AdditiveHeuristic &other)
+    : RelaxationHeuristic(other),
+      did_write_overflow_warning(other.did_write_overflow_warning),
+      incremental(other.incremental),
+      has_explored_state(other.has_explored_state),
+      explored_state(other.explored_state),
+      is_affected(other.is_affected),
+      marked(other.marked) {
 }
 
 AdditiveHeuristic::~AdditiveHeuristic() {
 }
 
+Heuristic *AdditiveHeuristic::create_thread_clone() {
+    return new AdditiveHeuristic(*this);
+}
+
+void AdditiveHeuristic::add_incremental_option(OptionParser &parser) {
+    parser.add_option<bool>(
+        "incremental",
+        "compute the relaxed exploration of a state by updating the "
+        "exploration of the previously evaluated state if the two states "
+        "differ in few variables, as for successors of the same state. "
+        "The h^add values do not change, but relaxed plans (and preferred "
+        "operators) may differ when several achievers are equally cheap.",
+        "false");
+}
+
 void AdditiveHeuristic::write_overflow_warning() {
     if (!did_write_overflow_warning) {
         // TODO: Should have a planner-wide warning mechanism to handle
@@ -37,81 +65,172 @@ void AdditiveHeuristic::write_overflow_warning() {
 void AdditiveHeuristic::initialize() {
     cout << "Initializing additive heuristic..." << endl;
     RelaxationHeuristic::initialize();
+    marked.resize(get_num_propositions(), false);
+    if (incremental) {
+        cout << "Using incremental exploration" << endl;
+        is_affected.resize(get_num_propositions(), false);
+    }
 }
 
 // heuristic computation
 void AdditiveHeuristic::setup_exploration_queue() {
     queue.clear();
 
-    for (int var = 0; var < propositions.size(); var++) {
-        for (int value = 0; value < propositions[var].size(); value++) {
-            Proposition &prop = propositions[var][value];
-            prop.cost = -1;
-            prop.marked = false;
-        }
-    }
+    // Operator costs will be increased by precondition costs.
+    reset_exploration();
 
     // Deal with operators and axioms without preconditions.
-    for (int i = 0; i < unary_operators.size(); i++) {
-        UnaryOperator &op = unary_operators[i];
-        op.unsatisfied_preconditions = op.precondition.size();
-        op.cost = op.base_cost; // will be increased by precondition costs
-
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost, &op);
+    for (int i = 0; i < task->operators_without_preconditions.size(); i++) {
+        int op = task->operators_without_preconditions[i];
+        enqueue_if_necessary(task->effect[op], task->base_cost[op], op);
     }
 }
 
 void AdditiveHeuristic::setup_exploration_queue_state(const State &state) {
-    for (int var = 0; var < propositions.size(); var++) {
-        Proposition *init_prop = &propositions[var][state[var]];
-        enqueue_if_necessary(init_prop, 0, 0);
-    }
+    for (int var = 0; var < task->proposition_offsets.size(); var++)
+        enqueue_if_necessary(get_proposition(var, state[var]), 0, NO_OPERATOR);
 }
 
 void AdditiveHeuristic::relaxed_exploration() {
-    int unsolved_goals = goal_propositions.size();
+    int unsolved_goals = task->goal_propositions.size();
     while (!queue.empty()) {
-        pair<int, Proposition *> top_pair = queue.pop();
+        pair<int, int> top_pair = queue.pop();
         int distance = top_pair.first;
-        Proposition *prop = top_pair.second;
-        int prop_cost = prop->cost;
+        int prop = top_pair.second;
+        int prop_cost = proposition_cost[prop];
         assert(prop_cost >= 0);
         assert(prop_cost <= distance);
         if (prop_cost < distance)
             continue;
-        if (prop->is_goal && --unsolved_goals == 0)
+        if (!incremental && task->is_goal[prop] && --unsolved_goals == 0)
             return;
-        const vector<UnaryOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (int i = 0; i < triggered_operators.size(); i++) {
-            UnaryOperator *unary_op = triggered_operators[i];
-            increase_cost(unary_op->cost, prop_cost);
-            unary_op->unsatisfied_preconditions--;
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect,
-                                     unary_op->cost, unary_op);
+        int end = task->precondition_of_start[prop + 1];
+        for (int i = task->precondition_of_start[prop]; i < end; i++) {
+            int op = task->precondition_of[i];
+            increase_cost(operator_cost[op], prop_cost);
+            int &unsatisfied = unsatisfied_preconditions[op];
+            unsatisfied--;
+            assert(unsatisfied >= 0);
+            if (unsatisfied == 0)
+                enqueue_if_necessary(task->effect[op], operator_cost[op], op);
         }
     }
 }
 
+int AdditiveHeuristic::compute_operator_cost(int op) {
+    // Returns -1 if some precondition is not reached.
+    int cost = task->base_cost[op];
+    int end = task->precondition_start[op + 1];
+    for (int i = task->precondition_start[op]; i < end; i++) {
+        int prop_cost = proposition_cost[task->preconditions[i]];
+        if (prop_cost == -1)
+            return -1;
+        increase_cost(cost, prop_cost);
+    }
+    operator_cost[op] = cost;
+    return cost;
+}
+
+bool AdditiveHeuristic::update_exploration(const State &state) {
+    /*
+      Updates the exploration of explored_state to state, or returns
+      false if too much of it would change (without changing it).
+
+      The costs of the propositions that were reached via facts of
+      explored_state that are false in state (following reached_by) may
+      increase. We forget their costs and compute them anew from their
+      achievers. The costs of all other propositions can only decrease
+      (their supporters are still applicable), which is propagated like
+      in the exploration from scratch, except that operator costs are
+      computed from the current costs of all preconditions.
+    */
+    changed_vars.clear();
+    for (int var = 0; var < explored_state.size(); var++)
+        if (state[var] != explored_state[var])
+            changed_vars.push_back(var);
+    if (changed_vars.size() * 4 > explored_state.size())
+        return false;
+
+    queue.clear();
+    affected_propositions.clear();
+    for (int i = 0; i < changed_vars.size(); i++) {
+        int prop = get_proposition(changed_vars[i], explored_state[changed_vars[i]]);
+        is_affected[prop] = true;
+        affected_propositions.push_back(prop);
+    }
+    for (int i = 0; i < affected_propositions.size(); i++) {
+        int prop = affected_propositions[i];
+        int end = task->precondition_of_start[prop + 1];
+        for (int j = task->precondition_of_start[prop]; j < end; j++) {
+            int op = task->precondition_of[j];
+            int eff = task->effect[op];
+            if (!is_affected[eff] && proposition_cost[eff] != -1 &&
+                reached_by[eff] == op) {
+                is_affected[eff] = true;
+                affected_propositions.push_back(eff);
+            }
+        }
+    }
+    if (affected_propositions.size() * 2 > get_num_propositions()) {
+        // Computing the exploration from scratch is cheaper.
+        for (int i = 0; i < affected_propositions.size(); i++)
+            is_affected[affected_propositions[i]] = false;
+        return false;
+    }
+    for (int i = 0; i < affected_propositions.size(); i++)
+        proposition_cost[affected_propositions[i]] = -1;
+
+    for (int i = 0; i < changed_vars.size(); i++) {
+        int var = changed_vars[i];
+        explored_state[var] = state[var];
+        enqueue_if_necessary(get_proposition(var, state[var]), 0, NO_OPERATOR);
+    }
+    for (int i = 0; i < affected_propositions.size(); i++) {
+        int prop = affected_propositions[i];
+        is_affected[prop] = false;
+        int end = task->achievers_start[prop + 1];
+        for (int j = task->achievers_start[prop]; j < end; j++) {
+            int op = task->achievers[j];
+            int cost = compute_operator_cost(op);
+            if (cost != -1)
+                enqueue_if_necessary(prop, cost, op);
+        }
+    }
+
+    while (!queue.empty()) {
+        pair<int, int> top_pair = queue.pop();
+        int distance = top_pair.first;
+        int prop = top_pair.second;
+        if (proposition_cost[prop] < distance)
+            continue;
+        int end = task->precondition_of_start[prop + 1];
+        for (int i = task->precondition_of_start[prop]; i < end; i++) {
+            int op = task->precondition_of[i];
+            int cost = compute_operator_cost(op);
+            if (cost != -1)
+                enqueue_if_necessary(task->effect[op], cost, op);
+        }
+    }
+    return true;
+}
+
 void AdditiveHeuristic::mark_preferred_operators(
-    const State &state, Proposition *goal) {
-    if (!goal->marked) { // Only consider each subgoal once.
-        goal->marked = true;
-        UnaryOperator *unary_op = goal->reached_by;
-        if (unary_op) { // We have not yet chained back to a start node.
-            for (int i = 0; i < unary_op->precondition.size(); i++)
-                mark_preferred_operators(state, unary_op->precondition[i]);
-            int operator_no = unary_op->operator_no;
-            if (unary_op->cost == unary_op->base_cost && operator_no != -1) {
+    const State &state, int goal) {
+    if (!marked[goal]) { // Only consider each subgoal once.
+        marked[goal] = true;
+        int unary_op = reached_by[goal];
+        if (unary_op != NO_OPERATOR) { // We have not yet chained back to a start node.
+            for (int i = task->precondition_start[unary_op];
+                 i < task->precondition_start[unary_op + 1]; i++)
+                mark_preferred_operators(state, task->preconditions[i]);
+            int op_no = task->operator_no[unary_op];
+            if (operator_cost[unary_op] == task->base_cost[unary_op] && op_no != -1) {
                 // Necessary condition for this being a preferred
                 // operator, which we use as a quick test before the
                 // more expensive applicability test.
                 // If we had no 0-cost operators and axioms to worry
                 // about, this would also be a sufficient condition.
-                const Operator *op = &g_operators[operator_no];
+                const Operator *op = &g_operators[op_no];
                 if (op->is_applicable(state))
                     set_preferred(op);
             }
@@ -120,13 +239,22 @@ void AdditiveHeuristic::mark_preferred_operators(
 }
 
 int AdditiveHeuristic::compute_add_and_ff(const State &state) {
-    setup_exploration_queue();
-    setup_exploration_queue_state(state);
-    relaxed_exploration();
+    fill(marked.begin(), marked.end(), false);
+    if (!has_explored_state || !update_exploration(state)) {
+        setup_exploration_queue();
+        setup_exploration_queue_state(state);
+        relaxed_exploration();
+        if (incremental) {
+            explored_state.resize(task->proposition_offsets.size());
+            for (int var = 0; var < explored_state.size(); var++)
+                explored_state[var] = state[var];
+            has_explored_state = true;
+        }
+    }
 
     int total_cost = 0;
-    for (int i = 0; i < goal_propositions.size(); i++) {
-        int prop_cost = goal_propositions[i]->cost;
+    for (int i = 0; i < task->goal_propositions.size(); i++) {
+        int prop_cost = proposition_cost[task->goal_propositions[i]];
         if (prop_cost == -1)
             return DEAD_END;
         increase_cost(total_cost, prop_cost);
@@ -137,8 +265,8 @@ int AdditiveHeuristic::compute_add_and_ff(const State &state) {
 int AdditiveHeuristic::compute_heuristic(const State &state) {
     int h = compute_add_and_ff(state);
     if (h != DEAD_END) {
-        for (int i = 0; i < goal_propositions.size(); i++)
-            mark_preferred_operators(state, goal_propositions[i]);
+        for (int i = 0; i < task->goal_propositions.size(); i++)
+            mark_preferred_operators(state, task->goal_propositions[i]);
     }
     return h;
 }
@@ -158,6 +286,7 @@ static Heuristic *_parse(OptionParser &parser) {
     parser.document_property("preferred operators", "yes");
 
     Heuristic::add_options_to_parser(parser);
+    AdditiveHeuristic::add_incremental_option(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
         return 0;
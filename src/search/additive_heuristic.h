@@ -15,22 +15,38 @@ class AdditiveHeuristic : public RelaxationHeuristic {
      */
     static const int MAX_COST_VALUE = 100000000;
 
-    AdaptiveQueue<Proposition *> queue;
+    AdaptiveQueue<int> queue;
     bool did_write_overflow_warning;
 
+    /*
+      In incremental mode, the exploration always runs to completion, so
+      that the costs of all propositions are known. The next state is
+      then explored by updating these costs if it differs from the
+      explored state in only a few variables (see update_exploration).
+    */
+    const bool incremental;
+    bool has_explored_state;
+    std::vector<int> explored_state;
+    std::vector<bool> is_affected;
+    std::vector<int> affected_propositions;
+    std::vector<int> changed_vars;
+
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void relaxed_exploration();
-    void mark_preferred_operators(const State &state, Proposition *goal);
+    int compute_operator_cost(int op);
+    bool update_exploration(const State &state);
+    void mark_preferred_operators(const State &state, int goal);
 
-    void enqueue_if_necessary(Proposition *prop, int cost, UnaryOperator *op) {
+    void enqueue_if_necessary(int prop, int cost, int op) {
         assert(cost >= 0);
-        if (prop->cost == -1 || prop->cost > cost) {
-            prop->cost = cost;
-            prop->reached_by = op;
+        int &prop_cost = proposition_cost[prop];
+        if (prop_cost == -1 || prop_cost > cost) {
+            prop_cost = cost;
+            reached_by[prop] = op;
             queue.push(cost, prop);
         }
-        assert(prop->cost != -1 && prop->cost <= cost);
+        assert(prop_cost != -1 && prop_cost <= cost);
     }
 
     void increase_cost(int &cost, int amount) {
@@ -48,14 +64,23 @@ protected:
     virtual void initialize();
     virtual int compute_heuristic(const State &state);
 
+    // Used when computing preferred operators for h^add and h^FF.
+    std::vector<bool> marked;
+
     // Common part of h^add and h^ff computation.
     int compute_add_and_ff(const State &state);
+
+    virtual Heuristic *create_thread_clone();
+    // Used for clones; the queue is only used during evaluation.
+    AdditiveHeuristic(const AdditiveHeuristic &other);
 public:
     AdditiveHeuristic(const Options &options);
     ~AdditiveHeuristic();
 
+    static void add_incremental_option(OptionParser &parser);
+
     int get_cost(int var, int value) {
-        return propositions[var][value].cost;
+        return proposition_cost[get_proposition(var, value)];
     }
 };
 
@@ -0,0 +1,91 @@
+#include "arena_allocator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+using namespace std;
+
+// The blocks grow from the first to the last size, so that small arenas
+// stay small and large ones do not need many blocks.
+static const size_t FIRST_BLOCK_SIZE = 64 * 1024;
+static const size_t LAST_BLOCK_SIZE = 4 * 1024 * 1024;
+
+static vector<const Arena *> &get_named_arenas() {
+    static vector<const Arena *> named_arenas;
+    return named_arenas;
+}
+
+Arena::Arena(const string &name_)
+    : name(name_),
+      next(0),
+      end(0),
+      next_block_size(FIRST_BLOCK_SIZE),
+      used_bytes(0),
+      reserved_bytes(0),
+      num_allocations(0) {
+    if (!name.empty())
+        get_named_arenas().push_back(this);
+}
+
+Arena::~Arena() {
+    if (!name.empty()) {
+        vector<const Arena *> &named_arenas = get_named_arenas();
+        named_arenas.erase(find(named_arenas.begin(), named_arenas.end(), this));
+    }
+    for (size_t i = 0; i < blocks.size(); ++i)
+        delete[] blocks[i];
+}
+
+void Arena::add_block(size_t size) {
+    // Memory from new[] is aligned for all types.
+    blocks.push_back(new char[size]);
+    reserved_bytes += size;
+}
+
+void *Arena::allocate(size_t size, size_t alignment) {
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+    size_t padding = -reinterpret_cast<size_t>(next) & (alignment - 1);
+    if (!next || size + padding > static_cast<size_t>(end - next)) {
+        if (size > next_block_size / 4) {
+            // Large allocations get a block of their own, so that the
+            // rest of the current block can still be used.
+            add_block(size);
+            used_bytes += size;
+            ++num_allocations;
+            return blocks.back();
+        }
+        add_block(next_block_size);
+        next = blocks.back();
+        end = next + next_block_size;
+        next_block_size = min(2 * next_block_size, LAST_BLOCK_SIZE);
+        padding = 0;
+    }
+    char *result = next + padding;
+    next = result + size;
+    used_bytes += size;
+    ++num_allocations;
+    return result;
+}
+
+void Arena::deallocate(void *p, size_t size) {
+    char *start = static_cast<char *>(p);
+    if (start + size == next)
+        next = start;
+    assert(used_bytes >= size && num_allocations > 0);
+    used_bytes -= size;
+    --num_allocations;
+}
+
+void Arena::print_report() const {
+    cout << "Memory of " << name << ": " << used_bytes / 1024 << " KB in "
+         << num_allocations << " allocations, " << reserved_bytes / 1024
+         << " KB reserved in " << blocks.size() << " blocks" << endl;
+}
+
+void Arena::print_reports() {
+    const vector<const Arena *> &named_arenas = get_named_arenas();
+    for (size_t i = 0; i < named_arenas.size(); ++i) {
+        if (named_arenas[i]->reserved_bytes > 0)
+            named_arenas[i]->print_report();
+    }
+}
@@ -0,0 +1,127 @@
+#ifndef ARENA_ALLOCATOR_H
+#define ARENA_ALLOCATOR_H
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+/*
+  Memory for data that is built once and then kept until it is released
+  as a whole, such as the relaxed tasks that heuristics build when they
+  are initialized. Memory is handed out from large blocks by advancing a
+  pointer, which is much faster than allocating many small vectors and
+  objects on the heap one by one, and keeps data that is built together
+  next to each other in memory without per-allocation overhead.
+
+  Deallocating memory only returns it to the arena if it was the last
+  allocation; all other memory is released when the arena is destroyed.
+  So vectors in an arena should be allocated with their final size (or
+  be copied to the arena when they are complete, see copy_to_arena)
+  rather than grown with push_back.
+
+  Arenas with a name are listed in the memory report of the planner (see
+  print_reports). Arenas are not thread-safe.
+*/
+class Arena {
+    std::string name;
+    std::vector<char *> blocks;
+    char *next;
+    char *end;
+    std::size_t next_block_size;
+
+    std::size_t used_bytes;
+    std::size_t reserved_bytes;
+    int num_allocations;
+
+    void add_block(std::size_t size);
+
+    // Not implemented.
+    Arena(const Arena &);
+    Arena &operator=(const Arena &);
+public:
+    explicit Arena(const std::string &name = "");
+    ~Arena();
+
+    void *allocate(std::size_t size, std::size_t alignment);
+    void deallocate(void *p, std::size_t size);
+
+    std::size_t get_used_bytes() const {return used_bytes; }
+    std::size_t get_reserved_bytes() const {return reserved_bytes; }
+    int get_num_allocations() const {return num_allocations; }
+
+    void print_report() const;
+    // Prints the reports of all named arenas that have allocated memory.
+    static void print_reports();
+};
+
+/*
+  Allocator for standard containers that allocates from an arena, or
+  from the heap if no arena is given. Containers that are copied keep
+  the arena of the original.
+*/
+template<class T>
+class ArenaAllocator : public std::allocator<T> {
+    template<class U>
+    friend class ArenaAllocator;
+
+    Arena *arena;
+public:
+    typedef std::allocator<T> base;
+    typedef typename base::pointer pointer;
+    typedef typename base::size_type size_type;
+
+    template<class U>
+    struct rebind {typedef ArenaAllocator<U> other; };
+
+    explicit ArenaAllocator(Arena *arena_ = 0) : arena(arena_) {}
+
+    template<class U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    pointer allocate(size_type n, const void * /*hint*/ = 0) {
+        if (!arena)
+            return base::allocate(n);
+        return static_cast<pointer>(
+            arena->allocate(n * sizeof(T), __alignof__(T)));
+    }
+
+    void deallocate(pointer p, size_type n) {
+        if (arena)
+            arena->deallocate(p, n * sizeof(T));
+        else
+            base::deallocate(p, n);
+    }
+
+    Arena *get_arena() const {return arena; }
+};
+
+template<class T, class U>
+inline bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+    return a.get_arena() == b.get_arena();
+}
+
+template<class T, class U>
+inline bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+    return a.get_arena() != b.get_arena();
+}
+
+/*
+  Moves the entries of a vector that was filled on the heap to exactly as
+  much memory in the arena. The vector allocates from the arena from now
+  on. (Swapping does not exchange the allocators of vectors, so the
+  vector is constructed anew.)
+*/
+template<class T>
+void copy_to_arena(std::vector<T, ArenaAllocator<T> > &vec, Arena &arena) {
+    typedef std::vector<T, ArenaAllocator<T> > Vector;
+    assert(!vec.get_allocator().get_arena());
+    Vector entries;
+    entries.swap(vec);
+    vec.~Vector();
+    new (&vec) Vector(entries.begin(), entries.end(), ArenaAllocator<T>(&arena));
+}
+
+#endif
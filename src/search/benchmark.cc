@@ -0,0 +1,415 @@
+/*
+  Micro-benchmarks for the hot paths of the search component, so that
+  performance changes can be measured without timing whole planner runs.
+
+  Reads a preprocessed task from stdin like the planner and samples
+  states with a breadth-first search from the initial state. On these
+  states, it measures
+  - successor generation (SuccessorGenerator::generate_applicable_ops),
+  - registering the successor states in a new state registry
+    (StateRegistry::get_successor_state), first for new states and then
+    again for states that are already registered,
+  - inserting all states into and removing them from open lists, and
+  - evaluating heuristics.
+
+  Usage: downward-benchmark [--states N] [--heuristic CONFIG]...
+                            [--open-list CONFIG]... [--json FILE] < OUTPUT
+
+  Heuristics and open lists are specified as on the planner command line,
+  e.g. --heuristic "lmcut()" or --open-list "single(g())". Without
+  either option, a default selection of both is benchmarked. States are
+  inserted into open lists in breadth-first order, with the costs of their
+  breadth-first paths as g values. The heuristics that an open list
+  involves are evaluated on all states before the time is measured.
+  Path-dependent heuristics (e.g. lmcount) cannot be benchmarked, since
+  the states are not reached by a search.
+
+  All times are CPU times. The results are printed and, with --json,
+  written to FILE as a JSON object.
+*/
+
+#include "exact_timer.h"
+#include "globals.h"
+#include "heuristic.h"
+#include "int_packer.h"
+#include "operator.h"
+#include "option_parser.h"
+#include "plugin.h"
+#include "state_registry.h"
+#include "successor_generator.h"
+#include "utilities.h"
+#include "open_lists/open_list.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+static const int DEFAULT_NUM_STATES = 10000;
+
+static const char *DEFAULT_HEURISTICS[] = {
+    "blind()", "goalcount()", "hmax()", "add()", "ff()", "cg()", "cea()",
+    "lmcut()"
+};
+
+static const char *DEFAULT_OPEN_LISTS[] = {
+    "single(g())",
+    "tiebreaking([sum([g(), goalcount()]), goalcount()])"
+};
+
+/*
+  The measurements of one benchmark. Values are stored as text so that
+  they can be printed and written as JSON in the same way.
+*/
+class BenchmarkResult {
+    struct Value {
+        string key;
+        string text;
+        bool is_string;
+        Value(const string &key_, const string &text_, bool is_string_)
+            : key(key_), text(text_), is_string(is_string_) {}
+    };
+
+    string name;
+    vector<Value> values;
+public:
+    explicit BenchmarkResult(const string &name_) : name(name_) {}
+
+    template<class T>
+    void add(const string &key, const T &value) {
+        ostringstream out;
+        out << value;
+        values.push_back(Value(key, out.str(), false));
+    }
+
+    void add_string(const string &key, const string &value) {
+        values.push_back(Value(key, value, true));
+    }
+
+    // Adds the total time and the time and rate per operation.
+    void add_times(const string &operation, int count, double nanoseconds) {
+        add("seconds", nanoseconds / 1e9);
+        add("ns_per_" + operation, count ? nanoseconds / count : 0);
+        add(operation + "s_per_second",
+            nanoseconds > 0 ? count * 1e9 / nanoseconds : 0);
+    }
+
+    void print(ostream &out) const;
+    void write_json(ostream &out) const;
+};
+
+static string json_string(const string &text) {
+    ostringstream out;
+    out << '"';
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = text[i];
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (c < 0x20) {
+            char escaped[8];
+            sprintf(escaped, "\\u%04x", c);
+            out << escaped;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+void BenchmarkResult::print(ostream &out) const {
+    out << "Benchmark " << name << ":" << endl;
+    for (size_t i = 0; i < values.size(); ++i)
+        out << "  " << values[i].key << ": " << values[i].text << endl;
+}
+
+void BenchmarkResult::write_json(ostream &out) const {
+    out << "{\"name\": " << json_string(name);
+    for (size_t i = 0; i < values.size(); ++i) {
+        out << ", " << json_string(values[i].key) << ": ";
+        if (values[i].is_string)
+            out << json_string(values[i].text);
+        else
+            out << values[i].text;
+    }
+    out << "}";
+}
+
+/*
+  Registers the first num_states states that a breadth-first search from
+  the initial state reaches in g_state_registry, and the costs of the
+  paths on which they were reached.
+*/
+static void sample_states(size_t num_states, vector<State> &states,
+                          vector<int> &g_values) {
+    StateRegistry &registry = *g_state_registry;
+    states.push_back(g_initial_state());
+    g_values.push_back(0);
+    vector<const Operator *> applicable_ops;
+    for (size_t next = 0; next < states.size() && states.size() < num_states;
+         ++next) {
+        applicable_ops.clear();
+        g_successor_generator->generate_applicable_ops(states[next],
+                                                       applicable_ops);
+        for (size_t i = 0; i < applicable_ops.size(); ++i) {
+            size_t num_registered = registry.size();
+            State succ = registry.get_successor_state(states[next],
+                                                      *applicable_ops[i]);
+            if (registry.size() > num_registered) {
+                states.push_back(succ);
+                g_values.push_back(g_values[next] + applicable_ops[i]->get_cost());
+                if (states.size() == num_states)
+                    break;
+            }
+        }
+    }
+}
+
+/*
+  Generates the applicable operators of all states. The operators of
+  state i are stored in ops[first_op[i]] to ops[first_op[i + 1] - 1].
+*/
+static BenchmarkResult benchmark_successor_generation(
+    const vector<State> &states, vector<const Operator *> &ops,
+    vector<int> &first_op) {
+    vector<const Operator *> applicable_ops;
+    ExactTimer timer;
+    for (size_t i = 0; i < states.size(); ++i) {
+        applicable_ops.clear();
+        g_successor_generator->generate_applicable_ops(states[i],
+                                                       applicable_ops);
+    }
+    double nanoseconds = timer.stop();
+
+    for (size_t i = 0; i < states.size(); ++i) {
+        first_op.push_back(ops.size());
+        g_successor_generator->generate_applicable_ops(states[i], ops);
+    }
+    first_op.push_back(ops.size());
+
+    BenchmarkResult result("successor_generation");
+    result.add("calls", states.size());
+    result.add("applicable_operators", ops.size());
+    result.add_times("call", states.size(), nanoseconds);
+    return result;
+}
+
+/*
+  Registers all successors of the states in a new registry, which
+  measures registering new states and detecting duplicates among them,
+  and then registers them once more, which measures looking up states
+  that are already registered.
+*/
+static void benchmark_successor_registration(
+    const vector<State> &states, const vector<const Operator *> &ops,
+    const vector<int> &first_op, vector<BenchmarkResult> &results) {
+    StateRegistry registry;
+    for (int pass = 0; pass < 2; ++pass) {
+        ExactTimer timer;
+        for (size_t i = 0; i < states.size(); ++i) {
+            for (int j = first_op[i]; j < first_op[i + 1]; ++j)
+                registry.get_successor_state(states[i], *ops[j]);
+        }
+        double nanoseconds = timer.stop();
+
+        BenchmarkResult result(pass == 0 ? "successor_registration" :
+                               "duplicate_lookup");
+        result.add("calls", ops.size());
+        if (pass == 0)
+            result.add("new_states", registry.size());
+        result.add_times("call", ops.size(), nanoseconds);
+        results.push_back(result);
+    }
+}
+
+static BenchmarkResult benchmark_open_list(const string &config,
+                                           const vector<State> &states,
+                                           const vector<int> &g_values) {
+    OptionParser parser(config, false);
+    OpenList<StateID> *open_list = parser.start_parsing<OpenList<StateID> *>();
+
+    set<Heuristic *> hset;
+    open_list->get_involved_heuristics(hset);
+    vector<Heuristic *> heuristics(hset.begin(), hset.end());
+    // The value of heuristic j for state i is values[i * heuristics.size() + j].
+    vector<int> values;
+    values.reserve(states.size() * heuristics.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+        for (size_t j = 0; j < heuristics.size(); ++j) {
+            heuristics[j]->evaluate(states[i]);
+            values.push_back(heuristics[j]->get_value());
+        }
+    }
+
+    ExactTimer insert_timer;
+    for (size_t i = 0; i < states.size(); ++i) {
+        for (size_t j = 0; j < heuristics.size(); ++j)
+            heuristics[j]->set_evaluator_value(values[i * heuristics.size() + j]);
+        open_list->evaluate(g_values[i], false);
+        open_list->insert(states[i].get_id());
+    }
+    double insert_nanoseconds = insert_timer.stop();
+
+    int num_removals = 0;
+    ExactTimer remove_timer;
+    while (!open_list->empty()) {
+        open_list->remove_min();
+        ++num_removals;
+    }
+    double remove_nanoseconds = remove_timer.stop();
+    delete open_list;
+
+    BenchmarkResult result("open_list");
+    result.add_string("config", config);
+    result.add("insertions", states.size());
+    result.add("insertion_seconds", insert_nanoseconds / 1e9);
+    result.add("ns_per_insertion",
+               states.empty() ? 0 : insert_nanoseconds / states.size());
+    result.add("removals", num_removals);
+    result.add("removal_seconds", remove_nanoseconds / 1e9);
+    result.add("ns_per_removal",
+               num_removals ? remove_nanoseconds / num_removals : 0);
+    return result;
+}
+
+static BenchmarkResult benchmark_heuristic(const string &config,
+                                           const vector<State> &states) {
+    // Heuristics do their precomputations when they are created or when
+    // they evaluate their first state.
+    ExactTimer setup_timer;
+    OptionParser parser(config, false);
+    Heuristic *heuristic = parser.start_parsing<Heuristic *>();
+    heuristic->evaluate(states[0]);
+    double setup_nanoseconds = setup_timer.stop();
+
+    int num_dead_ends = 0;
+    ExactTimer timer;
+    for (size_t i = 0; i < states.size(); ++i) {
+        heuristic->evaluate(states[i]);
+        if (heuristic->is_dead_end())
+            ++num_dead_ends;
+    }
+    double nanoseconds = timer.stop();
+    delete heuristic;
+
+    BenchmarkResult result("heuristic");
+    result.add_string("config", config);
+    result.add("setup_seconds", setup_nanoseconds / 1e9);
+    result.add("evaluations", states.size());
+    result.add("dead_ends", num_dead_ends);
+    result.add_times("evaluation", states.size(), nanoseconds);
+    return result;
+}
+
+static void write_json(ostream &out, size_t num_states,
+                       const vector<BenchmarkResult> &results) {
+    out << "{" << endl;
+    out << "  \"task\": {\"variables\": " << g_variable_domain.size()
+        << ", \"operators\": " << g_operators.size()
+        << ", \"axioms\": " << g_axioms.size()
+        << ", \"state_bytes\": "
+        << g_state_packer->get_num_bins() * sizeof(PackedStateBin) << "}," << endl;
+    out << "  \"states\": " << num_states << "," << endl;
+    out << "  \"benchmarks\": [" << endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+        out << "    ";
+        results[i].write_json(out);
+        if (i + 1 < results.size())
+            out << ",";
+        out << endl;
+    }
+    out << "  ]" << endl;
+    out << "}" << endl;
+}
+
+static void usage_error(const char *progname) {
+    cerr << "usage: " << progname << " [--states N] [--heuristic CONFIG]..."
+         << " [--open-list CONFIG]... [--json FILE] < OUTPUT" << endl;
+    exit_with(EXIT_INPUT_ERROR);
+}
+
+// Parses the configurations in dry-run mode to detect errors early.
+template<class T>
+static void check_configs(const vector<string> &configs) {
+    for (size_t i = 0; i < configs.size(); ++i) {
+        try {
+            OptionParser parser(configs[i], true);
+            parser.start_parsing<T>();
+        } catch (ParseError &pe) {
+            cerr << pe << endl;
+            exit_with(EXIT_INPUT_ERROR);
+        }
+    }
+}
+
+int main(int argc, const char **argv) {
+    register_event_handlers();
+
+    int num_states = DEFAULT_NUM_STATES;
+    vector<string> heuristic_configs;
+    vector<string> open_list_configs;
+    string json_filename;
+    for (int i = 1; i < argc; i += 2) {
+        string arg = argv[i];
+        if (i + 1 >= argc)
+            usage_error(argv[0]);
+        if (arg == "--states" && atoi(argv[i + 1]) >= 1)
+            num_states = atoi(argv[i + 1]);
+        else if (arg == "--heuristic")
+            heuristic_configs.push_back(argv[i + 1]);
+        else if (arg == "--open-list")
+            open_list_configs.push_back(argv[i + 1]);
+        else if (arg == "--json")
+            json_filename = argv[i + 1];
+        else
+            usage_error(argv[0]);
+    }
+    if (heuristic_configs.empty() && open_list_configs.empty()) {
+        heuristic_configs.assign(
+            DEFAULT_HEURISTICS,
+            DEFAULT_HEURISTICS + sizeof(DEFAULT_HEURISTICS) / sizeof(char *));
+        open_list_configs.assign(
+            DEFAULT_OPEN_LISTS,
+            DEFAULT_OPEN_LISTS + sizeof(DEFAULT_OPEN_LISTS) / sizeof(char *));
+    }
+
+    read_everything(cin);
+    // Open lists are registered by the search engines that use them.
+    Plugin<OpenList<StateID> >::register_open_lists();
+    check_configs<Heuristic *>(heuristic_configs);
+    check_configs<OpenList<StateID> *>(open_list_configs);
+
+    vector<State> states;
+    vector<int> g_values;
+    sample_states(num_states, states, g_values);
+    cout << "Sampled " << states.size() << " state(s)." << endl;
+
+    vector<BenchmarkResult> results;
+    vector<const Operator *> ops;
+    vector<int> first_op;
+    results.push_back(benchmark_successor_generation(states, ops, first_op));
+    benchmark_successor_registration(states, ops, first_op, results);
+    for (size_t i = 0; i < open_list_configs.size(); ++i)
+        results.push_back(benchmark_open_list(open_list_configs[i], states,
+                                               g_values));
+    for (size_t i = 0; i < heuristic_configs.size(); ++i)
+        results.push_back(benchmark_heuristic(heuristic_configs[i], states));
+
+    for (size_t i = 0; i < results.size(); ++i)
+        results[i].print(cout);
+
+    if (!json_filename.empty()) {
+        ofstream json_file(json_filename.c_str());
+        write_json(json_file, states.size(), results);
+        if (!json_file) {
+            cerr << "could not write " << json_filename << endl;
+            exit_with(EXIT_CRITICAL_ERROR);
+        }
+    }
+    return 0;
+}
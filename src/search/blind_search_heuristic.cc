@@ -21,6 +21,11 @@ BlindSearchHeuristic::BlindSearchHeuristic(const Options &opts)
 BlindSearchHeuristic::~BlindSearchHeuristic() {
 }
 
+Heuristic *BlindSearchHeuristic::create_thread_clone() {
+    // Evaluation only reads the task.
+    return new BlindSearchHeuristic(*this);
+}
+
 void BlindSearchHeuristic::initialize() {
     cout << "Initializing blind search heuristic..." << endl;
 }
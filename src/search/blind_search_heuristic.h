@@ -8,6 +8,7 @@ class BlindSearchHeuristic : public Heuristic {
 protected:
     virtual void initialize();
     virtual int compute_heuristic(const State &state);
+    virtual Heuristic *create_thread_clone();
 public:
     BlindSearchHeuristic(const Options &options);
     ~BlindSearchHeuristic();
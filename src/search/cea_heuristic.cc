@@ -48,6 +48,10 @@ using namespace std;
  */
 
 namespace cea_heuristic {
+// The static parts of the local problems are stored in the arena of the
+// heuristic, see ContextEnhancedAdditiveHeuristic::create_local_problem.
+typedef vector<short, ArenaAllocator<short> > Context;
+
 struct LocalTransition {
     LocalProblemNode *source;
     LocalProblemNode *target;
@@ -75,12 +79,12 @@ struct LocalTransition {
 struct LocalProblemNode {
     // Attributes fixed during initialization.
     LocalProblem *owner;
-    vector<LocalTransition> outgoing_transitions;
+    vector<LocalTransition, ArenaAllocator<LocalTransition> > outgoing_transitions;
 
     // Dynamic attributes (modified during heuristic computation).
     int cost;
     bool expanded;
-    vector<short> context;
+    Context context;
 
     LocalTransition *reached_by;
     /* Before a node is expanded, reached_by is the "current best"
@@ -93,11 +97,14 @@ struct LocalProblemNode {
 
     vector<LocalTransition *> waiting_list;
 
-    LocalProblemNode(LocalProblem *owner_, int context_size)
+    // The transitions and the context are filled after the node has
+    // been stored, so that they are only allocated once.
+    LocalProblemNode(LocalProblem *owner_, Arena &arena)
         : owner(owner_),
+          outgoing_transitions(ArenaAllocator<LocalTransition>(&arena)),
           cost(-1),
           expanded(false),
-          context(context_size, -1),
+          context(ArenaAllocator<short>(&arena)),
           reached_by(0) {
     }
 
@@ -107,11 +114,13 @@ struct LocalProblemNode {
 
 struct LocalProblem {
     int base_priority;
-    vector<LocalProblemNode> nodes;
+    typedef vector<LocalProblemNode, ArenaAllocator<LocalProblemNode> > Nodes;
+    Nodes nodes;
     vector<int> *context_variables;
 public:
-    LocalProblem()
-        : base_priority(-1) {
+    explicit LocalProblem(Arena &arena)
+        : base_priority(-1),
+          nodes(ArenaAllocator<LocalProblemNode>(&arena)) {
     }
 
     ~LocalProblem() {
@@ -128,9 +137,14 @@ LocalProblem *ContextEnhancedAdditiveHeuristic::get_local_problem(
     return table_entry;
 }
 
+LocalProblem *ContextEnhancedAdditiveHeuristic::create_local_problem() {
+    void *memory = arena.allocate(sizeof(LocalProblem), __alignof__(LocalProblem));
+    return new (memory) LocalProblem(arena);
+}
+
 LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_variable(
-    int var_no) const {
-    LocalProblem *problem = new LocalProblem;
+    int var_no) {
+    LocalProblem *problem = create_local_problem();
 
     DomainTransitionGraph *dtg = g_transition_graphs[var_no];
 
@@ -139,13 +153,19 @@ LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_variable(
     int num_parents = problem->context_variables->size();
     size_t num_values = g_variable_domain[var_no];
     problem->nodes.reserve(num_values);
-    for (size_t value = 0; value < num_values; ++value)
-        problem->nodes.push_back(LocalProblemNode(problem, num_parents));
+    for (size_t value = 0; value < num_values; ++value) {
+        problem->nodes.push_back(LocalProblemNode(problem, arena));
+        problem->nodes.back().context.assign(num_parents, -1);
+    }
 
     // Compile the DTG arcs into LocalTransition objects.
     for (size_t value = 0; value < num_values; ++value) {
         LocalProblemNode &node = problem->nodes[value];
         const ValueNode &dtg_node = dtg->nodes[value];
+        size_t num_transitions = 0;
+        for (size_t i = 0; i < dtg_node.transitions.size(); ++i)
+            num_transitions += dtg_node.transitions[i].cea_labels.size();
+        node.outgoing_transitions.reserve(num_transitions);
         for (size_t i = 0; i < dtg_node.transitions.size(); ++i) {
             const ValueTransition &dtg_trans = dtg_node.transitions[i];
             int target_value = dtg_trans.target->value;
@@ -161,15 +181,18 @@ LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_variable(
     return problem;
 }
 
-LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_goal() const {
-    LocalProblem *problem = new LocalProblem;
+LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_goal() {
+    LocalProblem *problem = create_local_problem();
 
     problem->context_variables = new vector<int>;
     for (size_t i = 0; i < g_goal.size(); ++i)
         problem->context_variables->push_back(g_goal[i].first);
 
-    for (size_t value = 0; value < 2; ++value)
-        problem->nodes.push_back(LocalProblemNode(problem, g_goal.size()));
+    problem->nodes.reserve(2);
+    for (size_t value = 0; value < 2; ++value) {
+        problem->nodes.push_back(LocalProblemNode(problem, arena));
+        problem->nodes.back().context.assign(g_goal.size(), -1);
+    }
 
     vector<LocalAssignment> goals;
     for (size_t goal_no = 0; goal_no < g_goal.size(); ++goal_no) {
@@ -215,7 +238,7 @@ void ContextEnhancedAdditiveHeuristic::set_up_local_problem(
     assert(problem->base_priority == -1);
     problem->base_priority = base_priority;
 
-    vector<LocalProblemNode> &nodes = problem->nodes;
+    LocalProblem::Nodes &nodes = problem->nodes;
     for (size_t to_value = 0; to_value < nodes.size(); ++to_value) {
         nodes[to_value].expanded = false;
         nodes[to_value].cost = numeric_limits<int>::max();
@@ -249,7 +272,7 @@ void ContextEnhancedAdditiveHeuristic::expand_node(LocalProblemNode *node) {
     LocalTransition *reached_by = node->reached_by;
     if (reached_by) {
         LocalProblemNode *parent = reached_by->source;
-        vector<short> &context = node->context;
+        Context &context = node->context;
         context = parent->context;
         const vector<LocalAssignment> &precond = reached_by->label->precond;
         for (size_t i = 0; i < precond.size(); ++i)
@@ -418,20 +441,24 @@ int ContextEnhancedAdditiveHeuristic::compute_heuristic(const State &state) {
 }
 
 ContextEnhancedAdditiveHeuristic::ContextEnhancedAdditiveHeuristic(
-    const Options &opts) : Heuristic(opts) {
+    const Options &opts)
+    : Heuristic(opts),
+      arena("context-enhanced additive heuristic") {
     goal_problem = 0;
     goal_node = 0;
 }
 
 ContextEnhancedAdditiveHeuristic::~ContextEnhancedAdditiveHeuristic() {
+    // The local problems are in the arena, which only needs to release
+    // the waiting lists of their nodes.
     if (goal_problem) {
         delete goal_problem->context_variables;
         delete goal_problem->nodes[0].outgoing_transitions[0].label;
+        goal_problem->~LocalProblem();
     }
-    delete goal_problem;
 
     for (size_t i = 0; i < local_problems.size(); ++i)
-        delete local_problems[i];
+        local_problems[i]->~LocalProblem();
 }
 
 bool ContextEnhancedAdditiveHeuristic::dead_ends_are_reliable() const {
@@ -1,6 +1,7 @@
 #ifndef CEA_HEURISTIC_H
 #define CEA_HEURISTIC_H
 
+#include "arena_allocator.h"
 #include "heuristic.h"
 #include "priority_queue.h"
 
@@ -13,6 +14,8 @@ struct LocalProblemNode;
 struct LocalTransition;
 
 class ContextEnhancedAdditiveHeuristic : public Heuristic {
+    // Holds the local problems, which are built once when first needed.
+    Arena arena;
     std::vector<LocalProblem *> local_problems;
     std::vector<std::vector<LocalProblem *> > local_problem_index;
     LocalProblem *goal_problem;
@@ -21,8 +24,9 @@ class ContextEnhancedAdditiveHeuristic : public Heuristic {
     AdaptiveQueue<LocalProblemNode *> node_queue;
 
     LocalProblem *get_local_problem(int var_no, int value);
-    LocalProblem *build_problem_for_variable(int var_no) const;
-    LocalProblem *build_problem_for_goal() const;
+    LocalProblem *create_local_problem();
+    LocalProblem *build_problem_for_variable(int var_no);
+    LocalProblem *build_problem_for_goal();
 
     int get_priority(LocalProblemNode *node) const;
     void initialize_heap();
@@ -400,6 +400,7 @@ void Abstraction::restrict_splits(State &conc_state, Splits &splits) const {
         Options opts;
         opts.set<int>("cost_type", 0);
         opts.set<int>("memory_padding", 75);
+        opts.set<bool>("incremental", false);
         AdditiveHeuristic hadd(opts);
         hadd.evaluate(conc_state);
         int min_hadd = INF;
@@ -13,6 +13,7 @@
 #include "../operator.h"
 #include "../option_parser.h"
 #include "../state.h"
+#include "../task_reader.h"
 #include "../timer.h"
 #include "../utilities.h"
 #include "../landmarks/h_m_landmarks.h"
@@ -28,7 +29,8 @@ static std::vector<int> CAUSAL_GRAPH_ORDERING_POS;
 
 Operator create_op(const string desc) {
     istringstream iss("begin_operator\n" + desc + "\nend_operator");
-    return Operator(iss, false);
+    TaskReader reader(iss);
+    return Operator(reader, false);
 }
 
 Operator create_op(const string name, vector<string> prevail, vector<string> pre_post, int cost) {
@@ -70,6 +70,7 @@ public:
     ConditionalEffectIncrementalLandmarkCutHeuristic(const Options &opts);
     virtual ~ConditionalEffectIncrementalLandmarkCutHeuristic();
     virtual void free_up_memory(SearchSpace &search_space);
+    virtual bool is_path_dependent() const {return true; }
 };
 
 
@@ -8,8 +8,9 @@ using namespace __gnu_cxx;
 #include "domain_transition_graph.h"
 #include "globals.h"
 #include "operator.h"
+#include "task_reader.h"
 
-void DomainTransitionGraph::read_all(istream &in) {
+void DomainTransitionGraph::read_all(TaskReader &in) {
     int var_count = g_variable_domain.size();
 
     // First step: Allocate graphs and nodes.
@@ -48,7 +49,7 @@ DomainTransitionGraph::DomainTransitionGraph(int var_index, int node_count) {
     last_helpful_transition_extraction_time = -1;
 }
 
-void DomainTransitionGraph::read_data(istream &in) {
+void DomainTransitionGraph::read_data(TaskReader &in) {
     check_magic(in, "begin_DTG");
 
     map<int, int> global_to_local_child;
@@ -10,6 +10,7 @@ using namespace std;
 class CGHeuristic;
 class State;
 class Operator;
+class TaskReader;
 
 class ValueNode;
 class ValueTransition;
@@ -101,14 +102,14 @@ class DomainTransitionGraph {
     DomainTransitionGraph(const DomainTransitionGraph &other); // copying forbidden
 public:
     DomainTransitionGraph(int var_index, int node_count);
-    void read_data(istream &in);
+    void read_data(TaskReader &in);
 
     void dump() const;
 
     void get_successors(int value, vector<int> &result) const;
     // Build vector of values v' such that there is a transition from value to v'.
 
-    static void read_all(istream &in);
+    static void read_all(TaskReader &in);
 };
 
 #endif
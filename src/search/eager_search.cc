@@ -1,5 +1,6 @@
 #include "eager_search.h"
 
+#include "evaluation_pool.h"
 #include "globals.h"
 #include "heuristic.h"
 #include "option_parser.h"
@@ -12,8 +13,10 @@
 
 #include <cassert>
 #include <cstdlib>
+#include <ext/hash_map>
 #include <set>
 using namespace std;
+using namespace __gnu_cxx;
 
 EagerSearch::EagerSearch(
     const Options &opts)
@@ -22,13 +25,18 @@ EagerSearch::EagerSearch(
       do_pathmax(opts.get<bool>("pathmax")),
       use_multi_path_dependence(opts.get<bool>("mpd")),
       open_list(opts.get<OpenList<StateID> *>("open")),
+      bound_at_start(0),
       partial_order_reduction_method(opts.get<POR::PORMethod*>("partial_order_reduction")),
+      num_evaluation_threads(opts.get<int>("eval_threads")),
+      evaluation_pool(0),
       yahsp2(opts.get<YAHSP2 *>("yahsp2")) {
     if (opts.contains("f_eval")) {
         f_evaluator = opts.get<ScalarEvaluator *>("f_eval");
     } else {
         f_evaluator = 0;
     }
+    if (yahsp2 && !yahsp2->lookahead_is_greedy())
+        search_space.track_lengths();
     if (opts.contains("preferred")) {
         preferred_operator_heuristics =
             opts.get_list<Heuristic *>("preferred");
@@ -45,7 +53,10 @@ void EagerSearch::initialize() {
         cout << "Using pathmax correction" << endl;
     if (use_multi_path_dependence)
         cout << "Using multi-path dependence (LM-A*)" << endl;
+    if (!bound_heuristics.empty())
+        cout << "Pruning states whose g+h reaches the bound" << endl;
     assert(open_list != NULL);
+    bound_at_start = bound;
 
     set<Heuristic *> hset;
     open_list->get_involved_heuristics(hset);
@@ -59,6 +70,7 @@ void EagerSearch::initialize() {
     // not also used in the open list)
     hset.insert(preferred_operator_heuristics.begin(),
                 preferred_operator_heuristics.end());
+    hset.insert(bound_heuristics.begin(), bound_heuristics.end());
 
     // add heuristics that are used in the f_evaluator. They are usually also
     // used in the open list and hence already be included, but we want to be
@@ -80,8 +92,30 @@ void EagerSearch::initialize() {
     search_progress.inc_evaluated_states();
     search_progress.inc_evaluations(heuristics.size());
 
+    // Create the pool after the first evaluation, so that the heuristics
+    // are copied in their initialized state.
+    if (num_evaluation_threads > 1) {
+        if (use_multi_path_dependence || yahsp2) {
+            cout << "Parallel evaluation is not supported with multi-path "
+                 << "dependence or lookahead" << endl;
+        } else {
+            evaluation_pool = EvaluationPool::create(heuristics,
+                                                     num_evaluation_threads);
+            if (!evaluation_pool)
+                cout << "Some heuristics cannot be evaluated in parallel" << endl;
+        }
+        if (evaluation_pool)
+            cout << "Evaluating successors with " << num_evaluation_threads
+                 << " threads" << endl;
+        else
+            cout << "Evaluating successors one at a time" << endl;
+    }
+
     if (open_list->is_dead_end()) {
         cout << "Initial state is a dead end." << endl;
+    } else if (exceeds_bound(0)) {
+        cout << "Initial state is pruned by the bound." << endl;
+        search_progress.inc_bound_pruned();
     } else {
         search_progress.get_initial_h_values();
         if (f_evaluator) {
@@ -100,6 +134,7 @@ void EagerSearch::initialize() {
 }
 
 EagerSearch::~EagerSearch() {
+    delete evaluation_pool;
     delete partial_order_reduction_method;
 }
 
@@ -126,6 +161,22 @@ int EagerSearch::step() {
         return SOLVED;
     }
 
+    /*
+      If a better plan has been found since the search started, the
+      state may have been generated with a larger bound than the current
+      one. We do not store the values of the bound heuristics, so we
+      evaluate them again.
+    */
+    if (!bound_heuristics.empty() && bound < bound_at_start) {
+        for (size_t i = 0; i < bound_heuristics.size(); ++i)
+            bound_heuristics[i]->evaluate(s);
+        search_progress.inc_evaluations(bound_heuristics.size());
+        if (exceeds_bound(node.get_real_g())) {
+            search_progress.inc_bound_pruned();
+            return IN_PROGRESS;
+        }
+    }
+
     vector<const Operator *> applicable_ops;
     set<const Operator *> preferred_ops;
 
@@ -149,6 +200,9 @@ int EagerSearch::step() {
     }
     search_progress.inc_evaluations(preferred_operator_heuristics.size());
 
+    if (evaluation_pool)
+        generate_and_evaluate_successors(s, node, applicable_ops);
+
     for (int i = 0; i < applicable_ops.size(); i++) {
         // HACK: should call this whenever memory is about to run out
         for (int j = 0; j < heuristics.size(); j++) {
@@ -161,7 +215,9 @@ int EagerSearch::step() {
         if ((node.get_real_g() + op->get_cost()) >= bound)
             continue;
 
-        State succ_state = g_state_registry->get_successor_state(s, *op);
+        State succ_state = evaluation_pool ?
+            g_state_registry->lookup_state(batch_successor_ids[i]) :
+            g_state_registry->get_successor_state(s, *op);
         search_progress.inc_generated();
         bool is_preferred = (preferred_ops.find(op) != preferred_ops.end());
 
@@ -191,8 +247,16 @@ int EagerSearch::step() {
         if (succ_node.is_new()) {
             // We have not seen this state before.
             // Evaluate and create a new node.
-            for (size_t i = 0; i < heuristics.size(); i++)
-                heuristics[i]->evaluate(succ_state);
+            if (evaluation_pool) {
+                int slot = batch_slots[i];
+                assert(slot != -1);
+                for (size_t j = 0; j < heuristics.size(); j++)
+                    heuristics[j]->set_heuristic_value(
+                        batch_values[slot * heuristics.size() + j]);
+            } else {
+                for (size_t i = 0; i < heuristics.size(); i++)
+                    heuristics[i]->evaluate(succ_state);
+            }
             succ_node.clear_h_dirty();
             search_progress.inc_evaluated_states();
             search_progress.inc_evaluations(heuristics.size());
@@ -209,6 +273,12 @@ int EagerSearch::step() {
                 search_progress.inc_dead_ends();
                 continue;
             }
+            // The state stays new, so it is evaluated again if it is
+            // reached on a cheaper path.
+            if (exceeds_bound(node.get_real_g() + op->get_cost())) {
+                search_progress.inc_bound_pruned();
+                continue;
+            }
 
             //TODO:CR - add an ID to each state, and then we can use a vector to save per-state information
             int succ_h = heuristics[0]->get_heuristic();
@@ -292,6 +362,38 @@ int EagerSearch::step() {
     return IN_PROGRESS;
 }
 
+void EagerSearch::generate_and_evaluate_successors(
+    const State &state, const SearchNode &node,
+    const vector<const Operator *> &ops) {
+    /*
+      Register the successors in the same order as step() would, so that
+      state IDs do not depend on the number of threads. States that are
+      reached by several operators are only evaluated once.
+    */
+    batch_successor_ids.clear();
+    batch_slots.assign(ops.size(), -1);
+    vector<State> new_states;
+    hash_map<StateID, int> slot_of_state;
+    for (size_t i = 0; i < ops.size(); ++i) {
+        const Operator *op = ops[i];
+        if ((node.get_real_g() + op->get_cost()) >= bound) {
+            batch_successor_ids.push_back(StateID::no_state);
+            continue;
+        }
+        State succ_state = g_state_registry->get_successor_state(state, *op);
+        StateID succ_id = succ_state.get_id();
+        batch_successor_ids.push_back(succ_id);
+        if (!search_space.get_node(succ_id).is_new())
+            continue;
+        pair<hash_map<StateID, int>::iterator, bool> result =
+            slot_of_state.insert(make_pair(succ_id, new_states.size()));
+        if (result.second)
+            new_states.push_back(succ_state);
+        batch_slots[i] = result.first->second;
+    }
+    evaluation_pool->evaluate(new_states, batch_values);
+}
+
 pair<SearchNode, bool> EagerSearch::fetch_next_node() {
     /* TODO: The bulk of this code deals with multi-path dependence,
        which is a bit unfortunate since that is a special case that
@@ -384,6 +486,18 @@ void EagerSearch::print_heuristic_values(const vector<int> &values) const {
     }
 }
 
+static void add_evaluation_threads_option(OptionParser &parser) {
+    parser.add_option<int>(
+        "eval_threads",
+        "number of threads used to evaluate the successors of an expanded "
+        "state. With more than one thread, all successors are generated "
+        "first and the new ones are evaluated in parallel. This does not "
+        "change the search, but requires that all heuristics support "
+        "evaluation in several threads (otherwise the successors are "
+        "evaluated one at a time).",
+        "1");
+}
+
 static SearchEngine *_parse(OptionParser &parser) {
     //open lists are currently registered with the parser on demand,
     //because for templated classes the usual method of registering
@@ -408,8 +522,10 @@ static SearchEngine *_parse(OptionParser &parser) {
         ("preferred",
         "use preferred operators of these heuristics", "[]");
 
+    add_evaluation_threads_option(parser);
     YAHSP2::add_options_to_parser(parser);
     SearchEngine::add_options_to_parser(parser);
+    SearchEngine::add_bound_pruning_option(parser);
     Options opts = parser.parse();
 
     EagerSearch *engine = 0;
@@ -446,7 +562,9 @@ static SearchEngine *_parse_astar(OptionParser &parser) {
     parser.add_option<POR::PORMethod*>("partial_order_reduction",
                                        "partial order reduction method",
                                        "none");
+    add_evaluation_threads_option(parser);
     SearchEngine::add_options_to_parser(parser);
+    SearchEngine::add_bound_pruning_option(parser);
     Options opts = parser.parse();
 
     EagerSearch *engine = 0;
@@ -500,9 +618,11 @@ static SearchEngine *_parse_greedy(OptionParser &parser) {
     parser.add_option<POR::PORMethod*>("partial_order_reduction",
                                        "partial order reduction method",
                                        "none");
+    add_evaluation_threads_option(parser);
     // lookahead (YAHSP2)
     YAHSP2::add_options_to_parser(parser);
     SearchEngine::add_options_to_parser(parser);
+    SearchEngine::add_bound_pruning_option(parser);
 
     Options opts = parser.parse();
     opts.verify_list_non_empty<ScalarEvaluator *>("evals");
@@ -11,6 +11,7 @@
 #include "evaluator.h"
 #include "search_progress.h"
 
+class EvaluationPool;
 class Heuristic;
 class Operator;
 class ScalarEvaluator;
@@ -30,10 +31,30 @@ protected: // TODO: Remove this hack (added for POR integration)
 
     OpenList<StateID> *open_list;
     ScalarEvaluator *f_evaluator;
+    // Once the bound drops below this, expanded states are checked again
+    // with the bound heuristics.
+    int bound_at_start;
 
     POR::PORMethod *partial_order_reduction_method;
+
+    /*
+      With more than one evaluation thread, step() first generates all
+      successors of the expanded state and evaluates the new ones with
+      evaluation_pool. batch_successor_ids[i] is the successor for the
+      i-th applicable operator (no_state if it exceeds the bound) and
+      batch_slots[i] is the index of its heuristic values in batch_values
+      (-1 if it was not evaluated).
+    */
+    int num_evaluation_threads;
+    EvaluationPool *evaluation_pool;
+    std::vector<StateID> batch_successor_ids;
+    std::vector<int> batch_slots;
+    std::vector<int> batch_values;
 protected:
     int step();
+    void generate_and_evaluate_successors(
+        const State &state, const SearchNode &node,
+        const std::vector<const Operator *> &ops);
     std::pair<SearchNode, bool> fetch_next_node();
     bool check_goal(const SearchNode &node);
     void update_jump_statistic(const SearchNode &node);
@@ -0,0 +1,137 @@
+#include "evaluation_pool.h"
+
+#include "heuristic.h"
+#include "utilities.h"
+
+#include <cassert>
+#include <iostream>
+using namespace std;
+
+EvaluationPool::EvaluationPool(
+    const vector<Heuristic *> &heuristics_,
+    const vector<vector<Heuristic *> > &thread_heuristics)
+    : heuristics(heuristics_),
+      threads(thread_heuristics.size()),
+      batch_number(0),
+      shutting_down(false),
+      num_busy_threads(0),
+      batch_states(0),
+      batch_values(0),
+      next_state(0) {
+    pthread_mutex_init(&mutex, 0);
+    pthread_cond_init(&batch_started, 0);
+    pthread_cond_init(&batch_finished, 0);
+    for (size_t i = 0; i < threads.size(); ++i) {
+        Thread &thread = threads[i];
+        thread.pool = this;
+        thread.heuristics = thread_heuristics[i];
+        if (pthread_create(&thread.thread, 0, run_thread, &thread) != 0) {
+            cerr << "Could not create evaluation thread." << endl;
+            exit_with(EXIT_CRITICAL_ERROR);
+        }
+    }
+}
+
+EvaluationPool::~EvaluationPool() {
+    pthread_mutex_lock(&mutex);
+    shutting_down = true;
+    pthread_cond_broadcast(&batch_started);
+    pthread_mutex_unlock(&mutex);
+    for (size_t i = 0; i < threads.size(); ++i) {
+        pthread_join(threads[i].thread, 0);
+        for (size_t j = 0; j < threads[i].heuristics.size(); ++j)
+            delete threads[i].heuristics[j];
+    }
+    pthread_cond_destroy(&batch_finished);
+    pthread_cond_destroy(&batch_started);
+    pthread_mutex_destroy(&mutex);
+}
+
+EvaluationPool *EvaluationPool::create(const vector<Heuristic *> &heuristics,
+                                       int num_threads) {
+    assert(num_threads >= 1);
+    vector<vector<Heuristic *> > thread_heuristics(num_threads - 1);
+    for (size_t i = 0; i < thread_heuristics.size(); ++i) {
+        for (size_t j = 0; j < heuristics.size(); ++j) {
+            Heuristic *copy = heuristics[j]->clone_for_thread();
+            if (!copy) {
+                for (size_t k = 0; k <= i; ++k) {
+                    for (size_t l = 0; l < thread_heuristics[k].size(); ++l)
+                        delete thread_heuristics[k][l];
+                }
+                return 0;
+            }
+            thread_heuristics[i].push_back(copy);
+        }
+    }
+    return new EvaluationPool(heuristics, thread_heuristics);
+}
+
+void EvaluationPool::evaluate_batch_states(
+    const vector<Heuristic *> &evaluated_heuristics) {
+    const vector<State> &states = *batch_states;
+    vector<int> &values = *batch_values;
+    int num_states = states.size();
+    int num_heuristics = evaluated_heuristics.size();
+    while (true) {
+        int index = __sync_fetch_and_add(&next_state, 1);
+        if (index >= num_states)
+            break;
+        for (int i = 0; i < num_heuristics; ++i) {
+            Heuristic *h = evaluated_heuristics[i];
+            h->evaluate(states[index]);
+            values[index * num_heuristics + i] = h->get_value();
+        }
+    }
+}
+
+void EvaluationPool::run(Thread &thread) {
+    int last_batch_number = 0;
+    pthread_mutex_lock(&mutex);
+    while (true) {
+        while (batch_number == last_batch_number && !shutting_down)
+            pthread_cond_wait(&batch_started, &mutex);
+        if (shutting_down)
+            break;
+        last_batch_number = batch_number;
+        pthread_mutex_unlock(&mutex);
+
+        evaluate_batch_states(thread.heuristics);
+
+        pthread_mutex_lock(&mutex);
+        if (--num_busy_threads == 0)
+            pthread_cond_signal(&batch_finished);
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+void *EvaluationPool::run_thread(void *thread) {
+    Thread *t = static_cast<Thread *>(thread);
+    t->pool->run(*t);
+    return 0;
+}
+
+void EvaluationPool::evaluate(const vector<State> &states, vector<int> &values) {
+    values.resize(states.size() * heuristics.size());
+    batch_states = &states;
+    batch_values = &values;
+    next_state = 0;
+    if (states.size() <= 1 || threads.empty()) {
+        // Not worth waking up the other threads.
+        evaluate_batch_states(heuristics);
+        return;
+    }
+
+    pthread_mutex_lock(&mutex);
+    ++batch_number;
+    num_busy_threads = threads.size();
+    pthread_cond_broadcast(&batch_started);
+    pthread_mutex_unlock(&mutex);
+
+    evaluate_batch_states(heuristics);
+
+    pthread_mutex_lock(&mutex);
+    while (num_busy_threads > 0)
+        pthread_cond_wait(&batch_finished, &mutex);
+    pthread_mutex_unlock(&mutex);
+}
@@ -0,0 +1,72 @@
+#ifndef EVALUATION_POOL_H
+#define EVALUATION_POOL_H
+
+#include "state.h"
+
+#include <pthread.h>
+#include <vector>
+
+class Heuristic;
+
+/*
+  Evaluates a fixed list of heuristics on batches of states with several
+  threads. Every thread except the calling one evaluates copies of the
+  heuristics (see Heuristic::clone_for_thread), the calling thread uses
+  the heuristics themselves. The states of a batch are handed out to the
+  threads one at a time, so expensive states do not stall the others.
+
+  The result of evaluating heuristic j on state i of the batch is stored
+  in values[i * num_heuristics + j] and can be restored with
+  Heuristic::set_heuristic_value. Since the results do not depend on the
+  thread that computed them, searches that use the stored values behave
+  exactly like searches that evaluate the states one at a time.
+*/
+class EvaluationPool {
+    struct Thread {
+        EvaluationPool *pool;
+        // Copies of the heuristics of the pool.
+        std::vector<Heuristic *> heuristics;
+        pthread_t thread;
+    };
+
+    const std::vector<Heuristic *> heuristics;
+    std::vector<Thread> threads;
+
+    // Protects the following members up to num_busy_threads.
+    pthread_mutex_t mutex;
+    pthread_cond_t batch_started;
+    pthread_cond_t batch_finished;
+    int batch_number;
+    bool shutting_down;
+    int num_busy_threads;
+
+    const std::vector<State> *batch_states;
+    std::vector<int> *batch_values;
+    // Index of the next state of the batch that is not evaluated yet.
+    volatile int next_state;
+
+    void evaluate_batch_states(const std::vector<Heuristic *> &evaluated_heuristics);
+    void run(Thread &thread);
+    static void *run_thread(void *thread);
+
+    EvaluationPool(const std::vector<Heuristic *> &heuristics_,
+                   const std::vector<std::vector<Heuristic *> > &thread_heuristics);
+public:
+    ~EvaluationPool();
+
+    /*
+      Returns a pool with num_threads threads (including the calling
+      thread) for the given heuristics, or 0 if one of the heuristics
+      cannot be copied for other threads.
+    */
+    static EvaluationPool *create(const std::vector<Heuristic *> &heuristics,
+                                  int num_threads);
+
+    int get_num_threads() const {
+        return threads.size() + 1;
+    }
+
+    void evaluate(const std::vector<State> &states, std::vector<int> &values);
+};
+
+#endif
@@ -0,0 +1,503 @@
+#include "external_search.h"
+
+#include "globals.h"
+#include "heuristic.h"
+#include "option_parser.h"
+#include "plugin.h"
+#include "scalar_evaluator.h"
+#include "state_registry.h"
+#include "successor_generator.h"
+#include "utilities.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+using namespace std;
+
+const PackedStateBin ExternalSearch::NO_ID;
+
+static void exit_with_file_error(const string &action, const string &path) {
+    cerr << "Could not " << action << " " << path << endl;
+    exit_with(EXIT_CRITICAL_ERROR);
+}
+
+static int compare_states(const PackedStateBin *lhs, const PackedStateBin *rhs,
+                          int num_bins) {
+    for (int i = 0; i < num_bins; ++i) {
+        if (lhs[i] != rhs[i])
+            return lhs[i] < rhs[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+/*
+  Writes records to a file. Compressed files store each record as one
+  byte with the number of leading state bins that equal those of the
+  previous record, followed by the remaining bins.
+*/
+class ExternalSearch::RecordWriter {
+    FILE *file;
+    const string path;
+    const int record_size;
+    const int num_state_bins;
+    const bool compressed;
+    vector<PackedStateBin> last_record;
+public:
+    RecordWriter(const string &path_, const char *mode, int record_size_,
+                 int num_state_bins_, bool compressed_)
+        : path(path_), record_size(record_size_),
+          num_state_bins(num_state_bins_), compressed(compressed_) {
+        file = fopen(path.c_str(), mode);
+        if (!file)
+            exit_with_file_error("open", path);
+    }
+
+    ~RecordWriter() {
+        if (fclose(file) != 0)
+            exit_with_file_error("write", path);
+    }
+
+    void write(const PackedStateBin *record) {
+        int prefix = 0;
+        if (compressed) {
+            if (!last_record.empty()) {
+                while (prefix < num_state_bins && prefix < 255 &&
+                       record[prefix] == last_record[prefix])
+                    ++prefix;
+            }
+            last_record.assign(record, record + record_size);
+            unsigned char prefix_byte = prefix;
+            if (fwrite(&prefix_byte, 1, 1, file) != 1)
+                exit_with_file_error("write", path);
+        }
+        int size = record_size - prefix;
+        if (fwrite(record + prefix, sizeof(PackedStateBin), size, file) != size)
+            exit_with_file_error("write", path);
+    }
+};
+
+class ExternalSearch::RecordReader {
+    FILE *file;
+    const string path;
+    const int record_size;
+    const bool compressed;
+    vector<PackedStateBin> record;
+    bool at_end;
+public:
+    RecordReader(const string &path_, int record_size_, bool compressed_)
+        : path(path_), record_size(record_size_), compressed(compressed_),
+          record(record_size_), at_end(false) {
+        file = fopen(path.c_str(), "rb");
+        if (!file)
+            exit_with_file_error("open", path);
+        advance();
+    }
+
+    ~RecordReader() {
+        fclose(file);
+    }
+
+    bool done() const {
+        return at_end;
+    }
+
+    const PackedStateBin *get() const {
+        assert(!at_end);
+        return &record[0];
+    }
+
+    void advance() {
+        int prefix = 0;
+        if (compressed) {
+            unsigned char prefix_byte;
+            if (fread(&prefix_byte, 1, 1, file) != 1) {
+                at_end = true;
+                return;
+            }
+            prefix = prefix_byte;
+        }
+        int size = record_size - prefix;
+        int num_read = fread(&record[prefix], sizeof(PackedStateBin), size, file);
+        if (num_read != size) {
+            if (num_read != 0 || compressed)
+                exit_with_file_error("read", path);
+            at_end = true;
+        }
+    }
+};
+
+// Orders offsets of records in data by their state data.
+class RecordLess {
+    const vector<PackedStateBin> &data;
+    const int num_state_bins;
+public:
+    RecordLess(const vector<PackedStateBin> &data_, int num_state_bins_)
+        : data(data_), num_state_bins(num_state_bins_) {
+    }
+
+    bool operator()(int lhs, int rhs) const {
+        return compare_states(&data[lhs], &data[rhs], num_state_bins) < 0;
+    }
+};
+
+static string get_file_prefix(const string &directory) {
+    ostringstream prefix;
+    prefix << directory << "/external-" << getpid() << "-";
+    return prefix.str();
+}
+
+ExternalSearch::ExternalSearch(const Options &opts)
+    : SearchEngine(opts),
+      heuristic_evaluator(opts.get<ScalarEvaluator *>("eval")),
+      file_prefix(get_file_prefix(opts.get<string>("directory"))),
+      buffer_size(opts.get<int>("buffer_size")),
+      num_state_bins(g_state_packer->get_num_bins()),
+      record_size(num_state_bins + NUM_INFO_BINS),
+      num_pending_records(0),
+      next_id(0) {
+}
+
+ExternalSearch::~ExternalSearch() {
+}
+
+string ExternalSearch::get_open_path(int g, int h) const {
+    ostringstream path;
+    path << file_prefix << "open-" << g << "-" << h;
+    return path.str();
+}
+
+string ExternalSearch::get_closed_path(int h) const {
+    ostringstream path;
+    path << file_prefix << "closed-" << h;
+    return path.str();
+}
+
+string ExternalSearch::get_run_path(int run) const {
+    ostringstream path;
+    path << file_prefix << "run-" << run;
+    return path.str();
+}
+
+void ExternalSearch::initialize() {
+    cout << "Conducting external A* search, bound = " << bound << endl;
+    cout << "Storing states in files " << file_prefix << "*" << endl;
+
+    set<Heuristic *> hset;
+    heuristic_evaluator->get_involved_heuristics(hset);
+    heuristics.assign(hset.begin(), hset.end());
+    search_progress.add_heuristic(heuristics[0]);
+
+    StateRegistry registry;
+    const State &initial_state = registry.get_initial_state();
+    int h = 0;
+    if (evaluate(initial_state, 0, h)) {
+        search_progress.get_initial_h_values();
+        vector<PackedStateBin> buffer(num_state_bins);
+        registry.compute_initial_state_data(&buffer[0]);
+        add_record(&buffer[0], -1, 0, 0, NO_ID, h);
+    } else {
+        cout << "Initial state is a dead end." << endl;
+    }
+}
+
+bool ExternalSearch::evaluate(const State &state, int g, int &h) {
+    // Returns false if state is a dead end.
+    for (size_t i = 0; i < heuristics.size(); ++i)
+        heuristics[i]->evaluate(state);
+    heuristic_evaluator->evaluate(g, false);
+    search_progress.inc_evaluated_states();
+    search_progress.inc_evaluations(heuristics.size());
+    if (heuristic_evaluator->is_dead_end())
+        return false;
+    h = heuristic_evaluator->get_value();
+    return true;
+}
+
+void ExternalSearch::add_record(const PackedStateBin *state_data, int op_no,
+                                int g, int real_g, PackedStateBin parent_id,
+                                int h) {
+    vector<PackedStateBin> &records = pending_records[make_pair(g, h)];
+    records.insert(records.end(), state_data, state_data + num_state_bins);
+    records.push_back(op_no);
+    records.push_back(g);
+    records.push_back(real_g);
+    records.push_back(parent_id);
+    records.push_back(NO_ID);
+    open_buckets.insert(make_pair(g + h, g));
+    if (++num_pending_records >= buffer_size)
+        flush_pending_records();
+}
+
+void ExternalSearch::flush_pending_records() {
+    map<pair<int, int>, vector<PackedStateBin> >::iterator it;
+    for (it = pending_records.begin(); it != pending_records.end(); ++it) {
+        const vector<PackedStateBin> &records = it->second;
+        RecordWriter writer(get_open_path(it->first.first, it->first.second),
+                            "ab", record_size, num_state_bins, false);
+        for (size_t i = 0; i < records.size(); i += record_size)
+            writer.write(&records[i]);
+    }
+    pending_records.clear();
+    num_pending_records = 0;
+}
+
+int ExternalSearch::sort_into_runs(const string &path) {
+    // Writes the records of the file into sorted runs without duplicates
+    // and returns the number of runs.
+    int num_runs = 0;
+    RecordReader reader(path, record_size, false);
+    vector<PackedStateBin> records;
+    vector<int> offsets;
+    while (!reader.done()) {
+        records.clear();
+        for (int i = 0; i < buffer_size && !reader.done(); ++i) {
+            records.insert(records.end(), reader.get(), reader.get() + record_size);
+            reader.advance();
+        }
+        offsets.clear();
+        for (size_t offset = 0; offset < records.size(); offset += record_size)
+            offsets.push_back(offset);
+        sort(offsets.begin(), offsets.end(), RecordLess(records, num_state_bins));
+
+        RecordWriter writer(get_run_path(num_runs), "wb", record_size,
+                            num_state_bins, true);
+        for (size_t i = 0; i < offsets.size(); ++i) {
+            const PackedStateBin *record = &records[offsets[i]];
+            if (i == 0 || compare_states(record, &records[offsets[i - 1]],
+                                         num_state_bins) != 0)
+                writer.write(record);
+        }
+        ++num_runs;
+    }
+    return num_runs;
+}
+
+void ExternalSearch::expand_batch() {
+    // Successors are registered in a temporary registry for evaluation.
+    StateRegistry registry;
+    // Heuristic values of the registered states (-1 for dead ends).
+    const int UNKNOWN = -2;
+    vector<int> h_values;
+    vector<PackedStateBin> buffer(num_state_bins);
+    vector<const Operator *> applicable_ops;
+    for (size_t i = 0; i < expansion_batch.size(); i += record_size) {
+        const PackedStateBin *record = &expansion_batch[i];
+        State state = registry.register_state(record);
+        if (test_goal(state)) {
+            goal_record.assign(record, record + record_size);
+            break;
+        }
+        search_progress.inc_expanded();
+        int g = record[num_state_bins + G];
+        int real_g = record[num_state_bins + REAL_G];
+        PackedStateBin id = record[num_state_bins + ID];
+
+        applicable_ops.clear();
+        g_successor_generator->generate_applicable_ops(state, applicable_ops);
+        for (size_t j = 0; j < applicable_ops.size(); ++j) {
+            const Operator *op = applicable_ops[j];
+            if (real_g + op->get_cost() >= bound)
+                continue;
+            registry.compute_successor_data(state, *op, &buffer[0]);
+            State succ_state = registry.register_state(&buffer[0]);
+            search_progress.inc_generated();
+            int succ_g = g + get_adjusted_cost(*op);
+            size_t succ_id = succ_state.get_id().hash();
+            if (succ_id >= h_values.size())
+                h_values.resize(succ_id + 1, UNKNOWN);
+            if (h_values[succ_id] == UNKNOWN) {
+                int h = -1;
+                if (!evaluate(succ_state, succ_g, h))
+                    search_progress.inc_dead_ends();
+                h_values[succ_id] = h;
+            }
+            if (h_values[succ_id] != -1)
+                add_record(&buffer[0], op - &*g_operators.begin(), succ_g,
+                           real_g + op->get_cost(), id, h_values[succ_id]);
+        }
+    }
+    expansion_batch.clear();
+}
+
+void ExternalSearch::process_bucket(int g, int h) {
+    flush_pending_records();
+    // Rename the bucket, so that its successors (via operators of cost 0)
+    // start a new file.
+    string open_path = get_open_path(g, h);
+    string sorting_path = file_prefix + "sorting";
+    if (rename(open_path.c_str(), sorting_path.c_str()) != 0)
+        exit_with_file_error("rename", open_path);
+    int num_runs = sort_into_runs(sorting_path);
+    remove(sorting_path.c_str());
+
+    vector<RecordReader *> runs;
+    for (int i = 0; i < num_runs; ++i)
+        runs.push_back(new RecordReader(get_run_path(i), record_size, true));
+    RecordReader *closed = 0;
+    string closed_path = get_closed_path(h);
+    if (closed_h_values.count(h))
+        closed = new RecordReader(closed_path, record_size, true);
+    string new_closed_path = file_prefix + "closed";
+    RecordWriter *new_closed = new RecordWriter(
+        new_closed_path, "wb", record_size, num_state_bins, true);
+
+    // Merge the runs with the closed states.
+    vector<PackedStateBin> record(record_size);
+    for (;;) {
+        int min_run = -1;
+        for (int i = 0; i < num_runs; ++i) {
+            if (!runs[i]->done() &&
+                (min_run == -1 || compare_states(runs[i]->get(), runs[min_run]->get(),
+                                                 num_state_bins) < 0))
+                min_run = i;
+        }
+        if (min_run == -1)
+            break;
+        record.assign(runs[min_run]->get(), runs[min_run]->get() + record_size);
+        for (int i = 0; i < num_runs; ++i) {
+            if (!runs[i]->done() &&
+                compare_states(runs[i]->get(), &record[0], num_state_bins) == 0)
+                runs[i]->advance();
+        }
+
+        int cmp = 1;
+        while (closed && !closed->done() &&
+               (cmp = compare_states(closed->get(), &record[0], num_state_bins)) < 0) {
+            new_closed->write(closed->get());
+            closed->advance();
+        }
+        if (closed && !closed->done() && cmp == 0)
+            continue;
+
+        if (next_id == NO_ID) {
+            cerr << "Too many closed states." << endl;
+            exit_with(EXIT_OUT_OF_MEMORY);
+        }
+        record[num_state_bins + ID] = next_id++;
+        new_closed->write(&record[0]);
+        if (goal_record.empty()) {
+            expansion_batch.insert(expansion_batch.end(), record.begin(), record.end());
+            if (expansion_batch.size() >= buffer_size * record_size)
+                expand_batch();
+        }
+    }
+    while (closed && !closed->done()) {
+        new_closed->write(closed->get());
+        closed->advance();
+    }
+    if (goal_record.empty())
+        expand_batch();
+    expansion_batch.clear();
+
+    delete closed;
+    delete new_closed;
+    for (int i = 0; i < num_runs; ++i) {
+        delete runs[i];
+        remove(get_run_path(i).c_str());
+    }
+    if (rename(new_closed_path.c_str(), closed_path.c_str()) != 0)
+        exit_with_file_error("rename", new_closed_path);
+    closed_h_values.insert(h);
+}
+
+void ExternalSearch::trace_path(Plan &plan) const {
+    // Looks up the parent of each state in the closed files.
+    assert(plan.empty());
+    vector<PackedStateBin> record(goal_record);
+    while (record[num_state_bins + PARENT_ID] != NO_ID) {
+        plan.push_back(&g_operators[record[num_state_bins + OPERATOR]]);
+        PackedStateBin parent_id = record[num_state_bins + PARENT_ID];
+        bool found = false;
+        for (set<int>::const_iterator it = closed_h_values.begin();
+             !found && it != closed_h_values.end(); ++it) {
+            RecordReader reader(get_closed_path(*it), record_size, true);
+            for (; !reader.done(); reader.advance()) {
+                if (reader.get()[num_state_bins + ID] == parent_id) {
+                    record.assign(reader.get(), reader.get() + record_size);
+                    found = true;
+                    break;
+                }
+            }
+        }
+        if (!found) {
+            cerr << "Parent of closed state not found." << endl;
+            exit_with(EXIT_CRITICAL_ERROR);
+        }
+    }
+    reverse(plan.begin(), plan.end());
+}
+
+void ExternalSearch::remove_files() {
+    flush_pending_records();
+    set<pair<int, int> >::const_iterator open_it;
+    for (open_it = open_buckets.begin(); open_it != open_buckets.end(); ++open_it) {
+        int g = open_it->second;
+        remove(get_open_path(g, open_it->first - g).c_str());
+    }
+    set<int>::const_iterator closed_it;
+    for (closed_it = closed_h_values.begin(); closed_it != closed_h_values.end(); ++closed_it)
+        remove(get_closed_path(*closed_it).c_str());
+}
+
+int ExternalSearch::step() {
+    if (open_buckets.empty()) {
+        cout << "Completely explored state space -- no solution!" << endl;
+        remove_files();
+        return FAILED;
+    }
+    pair<int, int> bucket = *open_buckets.begin();
+    open_buckets.erase(open_buckets.begin());
+    int f = bucket.first;
+    int g = bucket.second;
+    search_progress.report_f_value(f);
+    process_bucket(g, f - g);
+    if (!goal_record.empty()) {
+        cout << "Solution found!" << endl;
+        Plan plan;
+        trace_path(plan);
+        set_plan(plan);
+        remove_files();
+        return SOLVED;
+    }
+    return IN_PROGRESS;
+}
+
+void ExternalSearch::statistics() const {
+    search_progress.print_statistics();
+    cout << "Closed states: " << next_id << endl;
+}
+
+static SearchEngine *_parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "External A* search",
+        "A* search with delayed duplicate detection that stores open and "
+        "closed states in files, so that it can explore more states than "
+        "fit into main memory. States are expanded in order of increasing "
+        "f = g + h, breaking ties by low g.");
+    parser.document_note(
+        "Heuristic",
+        "eval must compute a heuristic value (not an f value) that depends "
+        "only on the state. The solution is optimal if it is consistent. "
+        "Heuristics are evaluated on states of temporary state registries, "
+        "so heuristics that store information per state cannot be used.");
+    parser.add_option<ScalarEvaluator *>("eval", "heuristic");
+    parser.add_option<string>(
+        "directory", "directory for the files of the search", ".");
+    parser.add_option<int>(
+        "buffer_size",
+        "maximal number of records that are sorted, expanded or buffered "
+        "for writing at a time", "1000000");
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+    if (opts.get<int>("buffer_size") < 1)
+        parser.error("buffer_size must be at least 1");
+
+    if (parser.dry_run())
+        return 0;
+    else
+        return new ExternalSearch(opts);
+}
+
+static Plugin<SearchEngine> _plugin("external_astar", _parse);
@@ -0,0 +1,98 @@
+#ifndef EXTERNAL_SEARCH_H
+#define EXTERNAL_SEARCH_H
+
+#include "search_engine.h"
+#include "state.h"
+
+#include <cstdio>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Heuristic;
+class Options;
+class ScalarEvaluator;
+class StateRegistry;
+
+/*
+  External A* (Edelkamp, Jabbar and Schroedl, 2004): A* with open and
+  closed lists that are stored in files, so that the number of states
+  is limited by disk space rather than main memory.
+
+  Generated states are stored in buckets by their g and h values. Each
+  bucket is a file of records that consist of the packed state data (see
+  IntPacker) followed by NUM_INFO_BINS bins for plan reconstruction.
+  Buckets are expanded in order of increasing f value and, for equal
+  f values, increasing g value.
+
+  Duplicates are not detected when states are generated but when their
+  bucket is expanded ("delayed duplicate detection"): the bucket is
+  sorted by state data in runs of at most buffer_size records, and the
+  runs are merged with the sorted file of all closed states with the
+  same h value (the heuristic value of a state does not depend on the
+  path to it). States that are not closed yet are added to this file
+  and expanded. With a consistent heuristic, every state is closed with
+  its optimal g value first, so the solution is optimal.
+
+  Sorted files are compressed by omitting the leading bins of the state
+  data that equal those of the previous record. Every closed state gets
+  a unique ID, and records contain the ID of the parent, which is used
+  to trace the plan through the closed files.
+
+  Main memory holds one run of a bucket, the states of an expansion
+  batch of at most buffer_size states and their successors (registered
+  in a temporary StateRegistry to evaluate them) and at most
+  buffer_size successors that are not written to their bucket yet.
+*/
+class ExternalSearch : public SearchEngine {
+    enum {OPERATOR, G, REAL_G, PARENT_ID, ID, NUM_INFO_BINS};
+    static const PackedStateBin NO_ID = ~PackedStateBin(0);
+
+    class RecordWriter;
+    class RecordReader;
+
+    ScalarEvaluator *heuristic_evaluator;
+    std::vector<Heuristic *> heuristics;
+    const std::string file_prefix;
+    const int buffer_size;
+    const int num_state_bins;
+    const int record_size;
+
+    // Buckets with unprocessed records, as (f, g) pairs.
+    std::set<std::pair<int, int> > open_buckets;
+    // Records that are not written to their buckets yet, by (g, h).
+    std::map<std::pair<int, int>, std::vector<PackedStateBin> > pending_records;
+    int num_pending_records;
+    // h values of the states in closed files.
+    std::set<int> closed_h_values;
+    PackedStateBin next_id;
+
+    std::vector<PackedStateBin> expansion_batch;
+    // Record of the first expanded goal state.
+    std::vector<PackedStateBin> goal_record;
+
+    std::string get_open_path(int g, int h) const;
+    std::string get_closed_path(int h) const;
+    std::string get_run_path(int run) const;
+
+    bool evaluate(const State &state, int g, int &h);
+    void add_record(const PackedStateBin *state_data, int op_no, int g,
+                    int real_g, PackedStateBin parent_id, int h);
+    void flush_pending_records();
+    int sort_into_runs(const std::string &path);
+    void expand_batch();
+    void process_bucket(int g, int h);
+    void trace_path(Plan &plan) const;
+    void remove_files();
+protected:
+    virtual void initialize();
+    virtual int step();
+public:
+    explicit ExternalSearch(const Options &opts);
+    virtual ~ExternalSearch();
+    virtual void statistics() const;
+};
+
+#endif
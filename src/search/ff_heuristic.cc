@@ -24,6 +24,10 @@ FFHeuristic::FFHeuristic(const Options &opts)
 FFHeuristic::~FFHeuristic() {
 }
 
+Heuristic *FFHeuristic::create_thread_clone() {
+    return new FFHeuristic(*this);
+}
+
 // initialization
 void FFHeuristic::initialize() {
     cout << "Initializing FF heuristic..." << endl;
@@ -32,26 +36,27 @@ void FFHeuristic::initialize() {
 }
 
 void FFHeuristic::mark_preferred_operators_and_relaxed_plan(
-    const State &state, Proposition *goal) {
-    if (!goal->marked) { // Only consider each subgoal once.
-        goal->marked = true;
-        UnaryOperator *unary_op = goal->reached_by;
-        if (unary_op) { // We have not yet chained back to a start node.
-            for (int i = 0; i < unary_op->precondition.size(); i++)
+    const State &state, int goal) {
+    if (!marked[goal]) { // Only consider each subgoal once.
+        marked[goal] = true;
+        int unary_op = reached_by[goal];
+        if (unary_op != NO_OPERATOR) { // We have not yet chained back to a start node.
+            for (int i = task->precondition_start[unary_op];
+                 i < task->precondition_start[unary_op + 1]; i++)
                 mark_preferred_operators_and_relaxed_plan(
-                    state, unary_op->precondition[i]);
-            int operator_no = unary_op->operator_no;
-            if (operator_no != -1) {
+                    state, task->preconditions[i]);
+            int op_no = task->operator_no[unary_op];
+            if (op_no != -1) {
                 // This is not an axiom.
-                relaxed_plan[operator_no] = true;
-                add_to_op_bucket(&g_operators[operator_no]);
+                relaxed_plan[op_no] = true;
+                add_to_op_bucket(&g_operators[op_no]);
 
-                if (unary_op->cost == unary_op->base_cost) {
+                if (operator_cost[unary_op] == task->base_cost[unary_op]) {
                     // This test is implied by the next but cheaper,
                     // so we perform it to save work.
                     // If we had no 0-cost operators and axioms to worry
                     // about, it would also imply applicability.
-                    const Operator *op = &g_operators[operator_no];
+                    const Operator *op = &g_operators[op_no];
                     if (op->is_applicable(state))
                         set_preferred(op);
                 }
@@ -66,8 +71,8 @@ int FFHeuristic::compute_heuristic(const State &state) {
         return h_add;
 
     // Collecting the relaxed plan also sets the preferred operators.
-    for (int i = 0; i < goal_propositions.size(); i++)
-        mark_preferred_operators_and_relaxed_plan(state, goal_propositions[i]);
+    for (int i = 0; i < task->goal_propositions.size(); i++)
+        mark_preferred_operators_and_relaxed_plan(state, task->goal_propositions[i]);
 
     int h_ff = 0;
     for (int op_no = 0; op_no < relaxed_plan.size(); op_no++) {
@@ -95,6 +100,7 @@ static Heuristic *_parse(OptionParser &parser) {
     parser.document_property("preferred operators", "yes");
 
     Heuristic::add_options_to_parser(parser);
+    AdditiveHeuristic::add_incremental_option(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
         return 0;
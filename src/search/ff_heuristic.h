@@ -21,10 +21,11 @@ class FFHeuristic : public AdditiveHeuristic {
     typedef std::vector<bool> RelaxedPlan;
     RelaxedPlan relaxed_plan;
     void mark_preferred_operators_and_relaxed_plan(
-        const State &state, Proposition *goal);
+        const State &state, int goal);
 protected:
     virtual void initialize();
     virtual int compute_heuristic(const State &state);
+    virtual Heuristic *create_thread_clone();
 public:
     FFHeuristic(const Options &options);
     ~FFHeuristic();
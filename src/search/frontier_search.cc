@@ -0,0 +1,458 @@
+#include "frontier_search.h"
+
+#include "globals.h"
+#include "heuristic.h"
+#include "int_hash_set.h"
+#include "option_parser.h"
+#include "plugin.h"
+#include "scalar_evaluator.h"
+#include "segmented_vector.h"
+#include "state_registry.h"
+#include "successor_generator.h"
+#include "utilities.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+using namespace std;
+
+/*
+  The states of one g value. Like the StateRegistry, a layer stores the
+  packed state data of its states in one SegmentedArrayVector and
+  detects duplicates with an IntHashSet of indices into it.
+*/
+class FrontierSearch::Layer {
+    struct StateHash {
+        const SegmentedArrayVector<PackedStateBin> &state_data;
+        const int num_bins;
+        StateHash(const SegmentedArrayVector<PackedStateBin> &state_data_,
+                  int num_bins_)
+            : state_data(state_data_), num_bins(num_bins_) {
+        }
+        size_t operator()(int id) const {
+            return ::hash_number_sequence(state_data[id], num_bins);
+        }
+    };
+
+    struct StateEqual {
+        const SegmentedArrayVector<PackedStateBin> &state_data;
+        const int num_bins;
+        StateEqual(const SegmentedArrayVector<PackedStateBin> &state_data_,
+                   int num_bins_)
+            : state_data(state_data_), num_bins(num_bins_) {
+        }
+        bool operator()(int lhs, int rhs) const {
+            const PackedStateBin *lhs_data = state_data[lhs];
+            return equal(lhs_data, lhs_data + num_bins, state_data[rhs]);
+        }
+    };
+
+    SegmentedArrayVector<PackedStateBin> state_data;
+    IntHashSet<StateHash, StateEqual> ids;
+public:
+    enum {NONE = -2, SELF = -1};
+
+    /*
+      relay_low and relay_high are the last state with g <= M and the
+      first state with g >= M on the path of the node (see
+      FrontierSearch): SELF if this is the node itself, NONE if there is
+      no such state (yet) or M is undefined, and otherwise an index into
+      the relays of the search.
+    */
+    struct Node {
+        int real_g;
+        int relay_low;
+        int relay_high;
+        bool is_stale; // Also stored in a layer with a lower g value.
+    };
+
+    std::vector<Node> nodes;
+
+    explicit Layer(int num_bins)
+        : state_data(num_bins),
+          ids(StateHash(state_data, num_bins),
+              StateEqual(state_data, num_bins)) {
+    }
+
+    int size() const {
+        return nodes.size();
+    }
+
+    const PackedStateBin *get_state_data(int id) const {
+        return state_data[id];
+    }
+
+    // Returns the ID of the state with the given data or -1 if there is none.
+    int find(const PackedStateBin *data) {
+        state_data.push_back(data);
+        int id = ids.find(state_data.size() - 1);
+        state_data.pop_back();
+        return id;
+    }
+
+    // The state must not be in the layer yet.
+    void insert(const PackedStateBin *data, const Node &node) {
+        state_data.push_back(data);
+#ifndef NDEBUG
+        bool inserted = ids.insert(state_data.size() - 1).second;
+        assert(inserted);
+#else
+        ids.insert(state_data.size() - 1);
+#endif
+        nodes.push_back(node);
+    }
+};
+
+FrontierSearch::FrontierSearch(const Options &opts)
+    : SearchEngine(opts),
+      heuristic_evaluator(0),
+      num_state_bins(g_state_packer->get_num_bins()),
+      locality(opts.get<int>("locality")),
+      f_bound(NO_BOUND),
+      next_f_bound(NO_BOUND),
+      num_stored_states(0),
+      max_num_stored_states(0),
+      num_reconstruction_searches(0) {
+    if (opts.contains("eval"))
+        heuristic_evaluator = opts.get<ScalarEvaluator *>("eval");
+}
+
+FrontierSearch::~FrontierSearch() {
+}
+
+void FrontierSearch::initialize() {
+    cout << "Conducting frontier search";
+    if (heuristic_evaluator)
+        cout << " with iterative deepening on f";
+    cout << ", bound = " << bound << endl;
+
+    int max_cost = 0;
+    for (size_t i = 0; i < g_operators.size(); ++i) {
+        int cost = get_adjusted_cost(g_operators[i]);
+        if (cost == 0) {
+            cerr << "Frontier search does not support operators of cost 0; "
+                 << "use cost_type=PLUSONE." << endl;
+            exit_with(EXIT_UNSUPPORTED);
+        }
+        max_cost = max(max_cost, cost);
+    }
+    if (locality == -1)
+        locality = max_cost;
+    cout << "Duplicate detection locality: " << locality << endl;
+
+    StateRegistry registry;
+    const State &initial_state = registry.get_initial_state();
+    initial_path_state.data.resize(num_state_bins);
+    registry.compute_initial_state_data(&initial_path_state.data[0]);
+    initial_path_state.g = 0;
+    initial_path_state.real_g = 0;
+
+    if (heuristic_evaluator) {
+        set<Heuristic *> hset;
+        heuristic_evaluator->get_involved_heuristics(hset);
+        heuristics.assign(hset.begin(), hset.end());
+        search_progress.add_heuristic(heuristics[0]);
+        int h = 0;
+        if (evaluate(initial_state, 0, h)) {
+            search_progress.get_initial_h_values();
+            f_bound = h;
+        } else {
+            cout << "Initial state is a dead end." << endl;
+            initial_path_state.data.clear();
+        }
+    }
+}
+
+bool FrontierSearch::evaluate(const State &state, int g, int &h) {
+    // Returns false if state is a dead end.
+    for (size_t i = 0; i < heuristics.size(); ++i)
+        heuristics[i]->evaluate(state);
+    heuristic_evaluator->evaluate(g, false);
+    search_progress.inc_evaluated_states();
+    search_progress.inc_evaluations(heuristics.size());
+    if (heuristic_evaluator->is_dead_end())
+        return false;
+    h = heuristic_evaluator->get_value();
+    return true;
+}
+
+bool FrontierSearch::search(const PathState &start, const PathState *target,
+                            int relay_g, SearchResult &result) {
+    /*
+      Searches from start for target or, if target is 0, for a goal
+      state. States with g values above that of target are pruned. If
+      relay_g is not NO_BOUND, it is M (see class comment).
+    */
+    typedef Layer::Node Node;
+    map<int, Layer *> layers;
+    vector<PathState> relays;
+
+    Node start_node;
+    start_node.real_g = start.real_g;
+    start_node.relay_low = Layer::NONE;
+    start_node.relay_high = Layer::NONE;
+    start_node.is_stale = false;
+    if (relay_g != NO_BOUND) {
+        if (start.g <= relay_g)
+            start_node.relay_low = Layer::SELF;
+        if (start.g >= relay_g)
+            start_node.relay_high = Layer::SELF;
+    }
+    layers[start.g] = new Layer(num_state_bins);
+    layers[start.g]->insert(&start.data[0], start_node);
+    ++num_stored_states;
+    max_num_stored_states = max(max_num_stored_states, num_stored_states);
+
+    bool found = false;
+    vector<PackedStateBin> buffer(num_state_bins);
+    vector<const Operator *> applicable_ops;
+    vector<pair<Layer *, int> > superseded;
+    map<int, Layer *>::iterator current = layers.begin();
+    for (; !found && current != layers.end(); ++current) {
+        int g = current->first;
+        Layer &layer = *current->second;
+        while (layers.begin()->first < g - locality) {
+            num_stored_states -= layers.begin()->second->size();
+            delete layers.begin()->second;
+            layers.erase(layers.begin());
+        }
+        if (!target && !heuristic_evaluator)
+            search_progress.report_f_value(g);
+
+        // Expanded states and their successors are registered in a
+        // temporary registry to generate and evaluate successors.
+        StateRegistry registry;
+        for (int id = 0; id < layer.size(); ++id) {
+            // Successors are stored in other layers, so node stays valid.
+            const Node &node = layer.nodes[id];
+            if (node.is_stale)
+                continue;
+            const PackedStateBin *data = layer.get_state_data(id);
+            State state = registry.register_state(data);
+            bool is_goal;
+            if (target)
+                is_goal = equal(data, data + num_state_bins, &target->data[0]);
+            else
+                is_goal = test_goal(state);
+            if (is_goal) {
+                found = true;
+                result.goal.data.assign(data, data + num_state_bins);
+                result.goal.g = g;
+                result.goal.real_g = node.real_g;
+                int candidates[] = {node.relay_low, node.relay_high};
+                for (int i = 0; i < 2; ++i) {
+                    if (candidates[i] >= 0) {
+                        const PathState &relay = relays[candidates[i]];
+                        if (relay.g > start.g && relay.g < g) {
+                            result.relay = relay;
+                            break;
+                        }
+                    }
+                }
+                break;
+            }
+            search_progress.inc_expanded();
+
+            // Index of this state in relays once it is stored there.
+            int relay_id = -1;
+            applicable_ops.clear();
+            g_successor_generator->generate_applicable_ops(state, applicable_ops);
+            for (size_t i = 0; i < applicable_ops.size(); ++i) {
+                const Operator *op = applicable_ops[i];
+                int succ_g = g + get_adjusted_cost(*op);
+                int succ_real_g = node.real_g + op->get_cost();
+                if (succ_real_g >= bound || (target && succ_g > target->g))
+                    continue;
+                registry.compute_successor_data(state, *op, &buffer[0]);
+                search_progress.inc_generated();
+
+                bool is_duplicate = false;
+                superseded.clear();
+                map<int, Layer *>::iterator it;
+                for (it = layers.begin(); it != layers.end(); ++it) {
+                    int dup_id = it->second->find(&buffer[0]);
+                    if (dup_id == -1)
+                        continue;
+                    if (it->first <= succ_g) {
+                        is_duplicate = true;
+                        break;
+                    }
+                    superseded.push_back(make_pair(it->second, dup_id));
+                }
+                if (is_duplicate)
+                    continue;
+
+                if (heuristic_evaluator) {
+                    State succ_state = registry.register_state(&buffer[0]);
+                    int h = 0;
+                    if (!evaluate(succ_state, succ_g, h)) {
+                        search_progress.inc_dead_ends();
+                        continue;
+                    }
+                    int f = succ_g + h;
+                    if (f_bound != NO_BOUND && f > f_bound) {
+                        if (next_f_bound == NO_BOUND || f < next_f_bound)
+                            next_f_bound = f;
+                        continue;
+                    }
+                }
+                for (size_t j = 0; j < superseded.size(); ++j)
+                    superseded[j].first->nodes[superseded[j].second].is_stale = true;
+
+                Node succ_node;
+                succ_node.real_g = succ_real_g;
+                succ_node.relay_low = Layer::NONE;
+                succ_node.relay_high = Layer::NONE;
+                succ_node.is_stale = false;
+                if (relay_g != NO_BOUND) {
+                    bool stores_self = (succ_g > relay_g && g <= relay_g) ||
+                                       node.relay_high == Layer::SELF;
+                    if (stores_self && relay_id == -1) {
+                        relay_id = relays.size();
+                        relays.push_back(PathState());
+                        relays.back().data.assign(data, data + num_state_bins);
+                        relays.back().g = g;
+                        relays.back().real_g = node.real_g;
+                    }
+                    if (succ_g <= relay_g)
+                        succ_node.relay_low = Layer::SELF;
+                    else if (g <= relay_g)
+                        succ_node.relay_low = relay_id;
+                    else
+                        succ_node.relay_low = node.relay_low;
+                    if (node.relay_high == Layer::SELF)
+                        succ_node.relay_high = relay_id;
+                    else if (node.relay_high != Layer::NONE)
+                        succ_node.relay_high = node.relay_high;
+                    else if (succ_g >= relay_g)
+                        succ_node.relay_high = Layer::SELF;
+                }
+
+                Layer *&succ_layer = layers[succ_g];
+                if (!succ_layer)
+                    succ_layer = new Layer(num_state_bins);
+                succ_layer->insert(&buffer[0], succ_node);
+                ++num_stored_states;
+                max_num_stored_states = max(max_num_stored_states,
+                                            num_stored_states);
+            }
+        }
+    }
+
+    for (map<int, Layer *>::iterator it = layers.begin(); it != layers.end(); ++it) {
+        num_stored_states -= it->second->size();
+        delete it->second;
+    }
+    return found;
+}
+
+void FrontierSearch::reconstruct_path(const PathState &start,
+                                      const PathState &target, Plan &plan) {
+    // Appends a path from start to target with cost target.g - start.g.
+    if (start.g == target.g) {
+        assert(start.data == target.data);
+        return;
+    }
+
+    // Paths with one operator have no relay.
+    StateRegistry registry;
+    State state = registry.register_state(&start.data[0]);
+    vector<const Operator *> applicable_ops;
+    g_successor_generator->generate_applicable_ops(state, applicable_ops);
+    vector<PackedStateBin> buffer(num_state_bins);
+    for (size_t i = 0; i < applicable_ops.size(); ++i) {
+        const Operator *op = applicable_ops[i];
+        if (start.g + get_adjusted_cost(*op) != target.g)
+            continue;
+        registry.compute_successor_data(state, *op, &buffer[0]);
+        if (buffer == target.data) {
+            plan.push_back(op);
+            return;
+        }
+    }
+
+    ++num_reconstruction_searches;
+    SearchResult result;
+    if (!search(start, &target, (start.g + target.g) / 2, result) ||
+        result.goal.g != target.g || result.relay.data.empty()) {
+        cerr << "Could not reconstruct the path to the goal." << endl;
+        exit_with(EXIT_CRITICAL_ERROR);
+    }
+    reconstruct_path(start, result.relay, plan);
+    reconstruct_path(result.relay, target, plan);
+}
+
+int FrontierSearch::step() {
+    if (initial_path_state.data.empty())
+        return FAILED;
+    int relay_g = NO_BOUND;
+    if (f_bound != NO_BOUND) {
+        search_progress.report_f_value(f_bound);
+        relay_g = f_bound / 2;
+    }
+    next_f_bound = NO_BOUND;
+    SearchResult result;
+    if (!search(initial_path_state, 0, relay_g, result)) {
+        if (next_f_bound == NO_BOUND) {
+            cout << "Completely explored state space -- no solution!" << endl;
+            return FAILED;
+        }
+        f_bound = next_f_bound;
+        return IN_PROGRESS;
+    }
+
+    cout << "Solution found!" << endl;
+    Plan plan;
+    if (result.relay.data.empty()) {
+        reconstruct_path(initial_path_state, result.goal, plan);
+    } else {
+        reconstruct_path(initial_path_state, result.relay, plan);
+        reconstruct_path(result.relay, result.goal, plan);
+    }
+    set_plan(plan);
+    return SOLVED;
+}
+
+void FrontierSearch::statistics() const {
+    search_progress.print_statistics();
+    cout << "Maximal number of stored states: " << max_num_stored_states << endl;
+    cout << "Reconstruction searches: " << num_reconstruction_searches << endl;
+}
+
+static SearchEngine *_parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Frontier search",
+        "Uniform-cost (for unit costs: breadth-first) search that stores "
+        "only the frontier of the search instead of all generated states "
+        "and reconstructs the plan by divide and conquer. With a "
+        "heuristic, breadth-first iterative deepening A* is performed.");
+    parser.document_note(
+        "Heuristic",
+        "eval must compute a heuristic value (not an f value). The solution "
+        "is optimal if it is admissible. Heuristics are evaluated on states "
+        "of temporary state registries, so heuristics that store "
+        "information per state cannot be used.");
+    parser.document_note(
+        "Termination",
+        "If the locality is too low to detect all duplicates, states may "
+        "be expanded several times, and without a heuristic or bound, the "
+        "search does not terminate on unsolvable tasks with cycles.");
+    parser.add_option<ScalarEvaluator *>(
+        "eval", "heuristic for pruning", "", OptionFlags(false));
+    parser.add_option<int>(
+        "locality",
+        "expanded layers with a g value of at least g - locality are kept "
+        "for duplicate detection when expanding the layer of g; "
+        "-1 for the maximal operator cost", "-1");
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+    if (opts.get<int>("locality") < -1)
+        parser.error("locality must be at least -1");
+
+    if (parser.dry_run())
+        return 0;
+    else
+        return new FrontierSearch(opts);
+}
+
+static Plugin<SearchEngine> _plugin("frontier_search", _parse);
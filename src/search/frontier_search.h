@@ -0,0 +1,97 @@
+#ifndef FRONTIER_SEARCH_H
+#define FRONTIER_SEARCH_H
+
+#include "search_engine.h"
+#include "state.h"
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+class Heuristic;
+class Options;
+class ScalarEvaluator;
+class StateRegistry;
+
+/*
+  Frontier search (Korf, Zhang, Thayer and Hohwald, 2005) with layered
+  duplicate detection as in breadth-first heuristic search (Zhou and
+  Hansen, 2006): uniform-cost search that does not keep a closed list.
+
+  States are stored in layers by their g value, and layers are expanded
+  in order of increasing g (breadth-first search for unit costs).
+  Successors are checked for duplicates against all layers in memory:
+  the layers that are not expanded yet, the current layer and the
+  expanded layers with a g value of at least g - locality. Older layers
+  are deleted. With unit costs and the default locality of 1, only the
+  previous, current and next layer are stored. In state spaces where
+  every operator can be undone at the same cost, a locality of the
+  maximal operator cost detects all duplicates. Otherwise, states whose
+  layer was deleted may be generated and expanded again with a higher g
+  value; this costs time, but the first goal state that is expanded
+  still has an optimal g value.
+
+  Since nodes have no parent pointers, the plan is reconstructed by
+  divide and conquer: every node stores a relay, a state on its path
+  near a middle g value M (the last one with g <= M, and the first one
+  with g >= M). When the goal is found, a path from the start to the
+  relay and from the relay to the goal are found recursively by
+  searches towards the relay and the goal state with known g values.
+
+  With a heuristic, the search performs breadth-first iterative
+  deepening A* (BFIDA*): it prunes states with f = g + h > f_bound,
+  starting with f_bound = h(initial state) and increasing f_bound to the
+  lowest pruned f value when a search fails. With an admissible
+  heuristic, the solution is optimal, and M is set to f_bound / 2, so
+  that the relay of the goal is known after the last iteration.
+  Without a heuristic, the first search only finds the goal state, and
+  the plan is reconstructed with a second search from the initial
+  state.
+*/
+class FrontierSearch : public SearchEngine {
+    class Layer;
+
+    // A state outside the layers, with its path costs.
+    struct PathState {
+        std::vector<PackedStateBin> data;
+        int g;
+        int real_g;
+    };
+
+    struct SearchResult {
+        PathState goal;
+        // Relay of the goal with a g value strictly between the start and
+        // the goal; relay.data is empty if there is none.
+        PathState relay;
+    };
+
+    ScalarEvaluator *heuristic_evaluator;
+    std::vector<Heuristic *> heuristics;
+    const int num_state_bins;
+    int locality;
+    // Empty data if the initial state is a dead end.
+    PathState initial_path_state;
+
+    enum {NO_BOUND = -1};
+    int f_bound;
+    int next_f_bound;
+
+    std::size_t num_stored_states;
+    std::size_t max_num_stored_states;
+    int num_reconstruction_searches;
+
+    bool evaluate(const State &state, int g, int &h);
+    bool search(const PathState &start, const PathState *target, int relay_g,
+                SearchResult &result);
+    void reconstruct_path(const PathState &start, const PathState &target,
+                          Plan &plan);
+protected:
+    virtual void initialize();
+    virtual int step();
+public:
+    explicit FrontierSearch(const Options &opts);
+    virtual ~FrontierSearch();
+    virtual void statistics() const;
+};
+
+#endif
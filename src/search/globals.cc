@@ -4,12 +4,15 @@
 #include "causal_graph.h"
 #include "domain_transition_graph.h"
 #include "heuristic.h"
+#include "int_packer.h"
 #include "legacy_causal_graph.h"
 #include "operator.h"
 #include "rng.h"
+#include "shared_plan_bound.h"
 #include "state.h"
 #include "state_registry.h"
 #include "successor_generator.h"
+#include "task_reader.h"
 #include "timer.h"
 #include "utilities.h"
 
@@ -62,6 +65,13 @@ int calculate_plan_cost(const vector<const Operator *> &plan) {
 void save_plan(const vector<const Operator *> &plan, int iter) {
     // TODO: Refactor: this is only used by the SearchEngine classes
     //       and hence should maybe be moved into the SearchEngine.
+    int plan_cost = calculate_plan_cost(plan);
+    if (g_shared_plan_bound &&
+        !g_shared_plan_bound->register_plan(plan_cost, iter)) {
+        cout << "Plan cost " << plan_cost << " is not better than the best "
+             << "plan of the portfolio; not saving the plan." << endl;
+        return;
+    }
     ofstream outfile;
     if (iter == 0) {
         outfile.open(g_plan_filename.c_str(), ios::out);
@@ -75,7 +85,6 @@ void save_plan(const vector<const Operator *> &plan, int iter) {
         outfile << "(" << plan[i]->get_name() << ")" << endl;
     }
     outfile.close();
-    int plan_cost = calculate_plan_cost(plan);
     ofstream statusfile;
     statusfile.open("plan_numbers_and_cost", ios::out | ios::app);
     statusfile << iter << " " << plan_cost << endl;
@@ -93,7 +102,7 @@ bool peek_magic(istream &in, string magic) {
     return result;
 }
 
-void check_magic(istream &in, string magic) {
+void check_magic(TaskReader &in, string magic) {
     string word;
     in >> word;
     if (word != magic) {
@@ -108,7 +117,7 @@ void check_magic(istream &in, string magic) {
     }
 }
 
-void read_and_verify_version(istream &in) {
+void read_and_verify_version(TaskReader &in) {
     int version;
     check_magic(in, "begin_version");
     in >> version;
@@ -121,13 +130,13 @@ void read_and_verify_version(istream &in) {
     }
 }
 
-void read_metric(istream &in) {
+void read_metric(TaskReader &in) {
     check_magic(in, "begin_metric");
     in >> g_use_metric;
     check_magic(in, "end_metric");
 }
 
-void read_variables(istream &in) {
+void read_variables(TaskReader &in) {
     int count;
     in >> count;
     for (int i = 0; i < count; i++) {
@@ -148,16 +157,15 @@ void read_variables(istream &in) {
             exit_with(EXIT_INPUT_ERROR);
         }
 
-        in >> ws;
         vector<string> fact_names(range);
         for (size_t i = 0; i < fact_names.size(); i++)
-            getline(in, fact_names[i]);
+            in.read_line(fact_names[i]);
         g_fact_names.push_back(fact_names);
         check_magic(in, "end_variable");
     }
 }
 
-void read_mutexes(istream &in) {
+void read_mutexes(TaskReader &in) {
     g_inconsistent_facts.resize(g_variable_domain.size());
     for (size_t i = 0; i < g_variable_domain.size(); ++i)
         g_inconsistent_facts[i].resize(g_variable_domain[i]);
@@ -207,7 +215,7 @@ void read_mutexes(istream &in) {
     }
 }
 
-void read_goal(istream &in) {
+void read_goal(TaskReader &in) {
     check_magic(in, "begin_goal");
     int count;
     in >> count;
@@ -226,14 +234,14 @@ void dump_goal() {
              << g_goal[i].second << endl;
 }
 
-void read_operators(istream &in) {
+void read_operators(TaskReader &in) {
     int count;
     in >> count;
     for (int i = 0; i < count; i++)
         g_operators.push_back(Operator(in, false));
 }
 
-void read_axioms(istream &in) {
+void read_axioms(TaskReader &in) {
     int count;
     in >> count;
     for (int i = 0; i < count; i++)
@@ -242,7 +250,8 @@ void read_axioms(istream &in) {
     g_axiom_evaluator = new AxiomEvaluator;
 }
 
-void read_everything(istream &in) {
+void read_everything(istream &input) {
+    TaskReader in(input);
     read_and_verify_version(in);
     read_metric(in);
     read_variables(in);
@@ -257,6 +266,7 @@ void read_everything(istream &in) {
     check_magic(in, "end_state");
     g_default_axiom_values.assign(g_initial_state_buffer,
                                   g_initial_state_buffer + g_variable_domain.size());
+    g_state_packer = new IntPacker(g_variable_domain);
 
     read_goal(in);
     read_operators(in);
@@ -360,6 +370,7 @@ vector<vector<string> > g_fact_names;
 vector<int> g_axiom_layers;
 vector<int> g_default_axiom_values;
 state_var_t *g_initial_state_buffer;
+IntPacker *g_state_packer;
 vector<pair<int, int> > g_goal;
 vector<Operator> g_operators;
 vector<Operator> g_axioms;
@@ -12,11 +12,13 @@ class Axiom;
 class AxiomEvaluator;
 class CausalGraph;
 class DomainTransitionGraph;
+class IntPacker;
 class LegacyCausalGraph;
 class Operator;
 class RandomNumberGenerator;
 class State;
 class SuccessorGenerator;
+class TaskReader;
 class Timer;
 class StateRegistry;
 
@@ -34,7 +36,7 @@ bool has_cond_effects();
 void verify_no_cond_effects();
 void verify_no_axioms_no_cond_effects();
 
-void check_magic(std::istream &in, std::string magic);
+void check_magic(TaskReader &in, std::string magic);
 
 bool are_mutex(const std::pair<int, int> &a, const std::pair<int, int> &b);
 
@@ -50,6 +52,8 @@ extern std::vector<int> g_axiom_layers;
 extern std::vector<int> g_default_axiom_values;
 
 extern state_var_t *g_initial_state_buffer;
+// Packs the variable values of registered states (see StateRegistry).
+extern IntPacker *g_state_packer;
 // TODO The following function returns the initial state that is registered
 //      in g_state_registry. This is only a short-term solution. In the
 //      medium term, we should get rid of the global registry.
@@ -15,6 +15,11 @@ GoalCountHeuristic::GoalCountHeuristic(const Options &opts)
 GoalCountHeuristic::~GoalCountHeuristic() {
 }
 
+Heuristic *GoalCountHeuristic::create_thread_clone() {
+    // Evaluation only reads the task.
+    return new GoalCountHeuristic(*this);
+}
+
 void GoalCountHeuristic::initialize() {
     cout << "Initializing goal count heuristic..." << endl;
 }
@@ -7,6 +7,7 @@ class GoalCountHeuristic : public Heuristic {
 protected:
     virtual void initialize();
     virtual int compute_heuristic(const State &state);
+    virtual Heuristic *create_thread_clone();
 public:
     GoalCountHeuristic(const Options &options);
     ~GoalCountHeuristic();
@@ -0,0 +1,677 @@
+#include "hda_search.h"
+
+#include "axioms.h"
+#include "g_evaluator.h"
+#include "globals.h"
+#include "heuristic.h"
+#include "per_state_information.h"
+#include "plugin.h"
+#include "search_progress.h"
+#include "search_space.h"
+#include "state_registry.h"
+#include "successor_generator.h"
+#include "sum_evaluator.h"
+#include "utilities.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sched.h>
+#include <set>
+using namespace std;
+
+/*
+  A worker owns the states with a given owner index (see get_owner). All
+  its members are only accessed by its own thread, except for incoming,
+  and by the main thread before and after the search.
+*/
+class HDASearch::Worker {
+public:
+    HDASearch &engine;
+    const int index;
+
+    AxiomEvaluator axiom_evaluator;
+    StateRegistry state_registry;
+    SearchSpace search_space;
+    // Worker that owns the parent of each state.
+    PerStateInformation<int> parent_workers;
+    PerStateInformation<int> f_values;
+
+    OpenList<StateID> *open_list;
+    ScalarEvaluator *f_evaluator;
+    vector<Heuristic *> heuristics;
+    vector<Heuristic *> preferred_operator_heuristics;
+    SearchProgress search_progress;
+
+    /*
+      How heuristics[i] is evaluated (see setup_evaluation): if
+      needs_lock[i], heuristics[i] is evaluated while holding the
+      evaluation lock. Otherwise evaluated_heuristics[i] is evaluated
+      without the lock; if this is a clone of a heuristic that is shared
+      with other workers, its value is copied to heuristics[i] while
+      holding the lock.
+    */
+    vector<Heuristic *> evaluated_heuristics;
+    vector<bool> needs_lock;
+    bool uses_evaluation_lock;
+
+    MessageQueue incoming;
+    // Batches that have not been sent yet, by receiver.
+    vector<MessageBatch *> outgoing;
+
+    pthread_t thread;
+
+    Worker(HDASearch &engine_, int index_);
+    ~Worker();
+
+    void setup_evaluation(const map<Heuristic *, int> &num_users);
+    void lock_evaluation() {
+        if (uses_evaluation_lock)
+            pthread_mutex_lock(&engine.evaluation_lock);
+    }
+    void unlock_evaluation() {
+        if (uses_evaluation_lock)
+            pthread_mutex_unlock(&engine.evaluation_lock);
+    }
+    bool evaluate_preferred_operator_heuristic(
+        Heuristic *heuristic, const State &state,
+        vector<const Operator *> &preferred);
+    bool evaluate(const State &state, int g, bool is_preferred, int &h, int &f);
+    void process(const Message &message, const PackedStateBin *state_data);
+    bool receive_messages();
+    void expand_next_node();
+    void flush_outgoing();
+    void run();
+};
+
+HDASearch::Worker::Worker(HDASearch &engine_, int index_)
+    : engine(engine_),
+      index(index_),
+      state_registry(axiom_evaluator),
+      search_space(engine.cost_type, state_registry),
+      parent_workers(-1, state_registry),
+      f_values(0, state_registry),
+      f_evaluator(0),
+      uses_evaluation_lock(true),
+      outgoing(engine.num_workers, static_cast<MessageBatch *>(0)) {
+    if (!engine.eval_config.empty()) {
+        // hdastar: build the open list like astar.
+        OptionParser eval_parser(engine.eval_config, false);
+        ScalarEvaluator *eval = eval_parser.start_parsing<ScalarEvaluator *>();
+        vector<ScalarEvaluator *> sum_evals;
+        sum_evals.push_back(new GEvaluator());
+        sum_evals.push_back(eval);
+        f_evaluator = new SumEvaluator(sum_evals);
+
+        // use eval for tiebreaking
+        vector<ScalarEvaluator *> evals;
+        evals.push_back(f_evaluator);
+        evals.push_back(eval);
+        open_list = new TieBreakingOpenList<StateID>(evals, false, false);
+    } else {
+        OptionParser open_parser(engine.open_list_config, false);
+        open_list = open_parser.start_parsing<OpenList<StateID> *>();
+        if (!engine.f_evaluator_config.empty()) {
+            OptionParser f_parser(engine.f_evaluator_config, false);
+            f_evaluator = f_parser.start_parsing<ScalarEvaluator *>();
+        }
+    }
+    for (size_t i = 0; i < engine.preferred_configs.size(); ++i) {
+        OptionParser preferred_parser(engine.preferred_configs[i], false);
+        preferred_operator_heuristics.push_back(
+            preferred_parser.start_parsing<Heuristic *>());
+    }
+
+    // Collect the heuristics as in EagerSearch::initialize.
+    set<Heuristic *> hset;
+    open_list->get_involved_heuristics(hset);
+    hset.insert(preferred_operator_heuristics.begin(),
+                preferred_operator_heuristics.end());
+    if (f_evaluator)
+        f_evaluator->get_involved_heuristics(hset);
+    heuristics.assign(hset.begin(), hset.end());
+    assert(!heuristics.empty());
+}
+
+HDASearch::Worker::~Worker() {
+    for (size_t i = 0; i < evaluated_heuristics.size(); ++i)
+        if (evaluated_heuristics[i] != heuristics[i])
+            delete evaluated_heuristics[i];
+    // Batches that were still in transit when the search ended.
+    for (size_t i = 0; i < outgoing.size(); ++i)
+        delete outgoing[i];
+    MessageBatch *batch = incoming.pop_all();
+    while (batch) {
+        MessageBatch *next = batch->next;
+        delete batch;
+        batch = next;
+    }
+}
+
+void HDASearch::Worker::setup_evaluation(const map<Heuristic *, int> &num_users) {
+    // Called by the main thread; num_users counts the workers that use
+    // each heuristic.
+    uses_evaluation_lock = false;
+    for (size_t i = 0; i < heuristics.size(); ++i) {
+        Heuristic *heuristic = heuristics[i];
+        if (heuristic->is_path_dependent()) {
+            cerr << "hda does not support path-dependent heuristics." << endl;
+            exit_with(EXIT_UNSUPPORTED);
+        }
+        Heuristic *clone = heuristic->clone_for_thread();
+        if (!clone) {
+            // Might modify data that is shared with other instances.
+            evaluated_heuristics.push_back(heuristic);
+            needs_lock.push_back(true);
+            uses_evaluation_lock = true;
+        } else if (num_users.find(heuristic)->second > 1) {
+            evaluated_heuristics.push_back(clone);
+            needs_lock.push_back(false);
+            uses_evaluation_lock = true;
+        } else {
+            // Only used by this worker, so it can be evaluated directly.
+            delete clone;
+            evaluated_heuristics.push_back(heuristic);
+            needs_lock.push_back(false);
+        }
+    }
+}
+
+bool HDASearch::Worker::evaluate_preferred_operator_heuristic(
+    Heuristic *heuristic, const State &state,
+    vector<const Operator *> &preferred) {
+    /*
+      Returns false if state is a dead end. The result is read before
+      the evaluation lock is released, since other workers may evaluate
+      a heuristic that needs the lock as soon as we release it.
+    */
+    size_t i = find(heuristics.begin(), heuristics.end(), heuristic)
+               - heuristics.begin();
+    assert(i < heuristics.size());
+    Heuristic *evaluated = evaluated_heuristics[i];
+    if (needs_lock[i])
+        pthread_mutex_lock(&engine.evaluation_lock);
+    evaluated->evaluate(state);
+    bool dead_end = evaluated->is_dead_end();
+    if (!dead_end)
+        evaluated->get_preferred_operators(preferred);
+    if (needs_lock[i])
+        pthread_mutex_unlock(&engine.evaluation_lock);
+    return !dead_end;
+}
+
+bool HDASearch::Worker::evaluate(const State &state, int g, bool is_preferred,
+                                 int &h, int &f) {
+    // Returns false if state is a dead end.
+    for (size_t i = 0; i < heuristics.size(); ++i)
+        if (!needs_lock[i])
+            evaluated_heuristics[i]->evaluate(state);
+    lock_evaluation();
+    for (size_t i = 0; i < heuristics.size(); ++i) {
+        if (needs_lock[i])
+            heuristics[i]->evaluate(state);
+        else if (evaluated_heuristics[i] != heuristics[i])
+            heuristics[i]->set_heuristic_value(
+                evaluated_heuristics[i]->get_value());
+    }
+    open_list->evaluate(g, is_preferred);
+    bool dead_end = open_list->is_dead_end();
+    if (!dead_end) {
+        h = heuristics[0]->get_heuristic();
+        f = g;
+        if (f_evaluator) {
+            f_evaluator->evaluate(g, is_preferred);
+            if (f_evaluator->is_dead_end())
+                dead_end = true;
+            else
+                f = f_evaluator->get_value();
+        }
+    }
+    unlock_evaluation();
+    search_progress.inc_evaluated_states();
+    search_progress.inc_evaluations(heuristics.size());
+    return !dead_end;
+}
+
+void HDASearch::Worker::process(const Message &message,
+                                const PackedStateBin *state_data) {
+    State state = state_registry.register_state(state_data);
+    StateID id = state.get_id();
+    SearchNode node = search_space.get_node(id);
+
+    // Previously encountered dead end. Don't re-evaluate.
+    if (node.is_dead_end())
+        return;
+
+    if (node.is_new()) {
+        int h = 0;
+        int f = 0;
+        if (!evaluate(state, message.g, message.is_preferred, h, f)) {
+            node.mark_as_dead_end();
+            search_progress.inc_dead_ends();
+            return;
+        }
+        if (engine.prune_by_f_value && f >= engine.best_solution_g)
+            return;
+        node.open(h, message.g, message.real_g,
+                  message.parent_state_id, message.creating_operator);
+        parent_workers[id] = message.parent_worker;
+        f_values[id] = f;
+        open_list->insert(id);
+    } else if (node.get_g() > message.g) {
+        // We found a new cheapest path to an open or closed state.
+        if (engine.reopen_closed_nodes) {
+            if (node.is_closed())
+                search_progress.inc_reopened();
+            node.reopen(message.g, message.real_g,
+                        message.parent_state_id, message.creating_operator);
+            parent_workers[id] = message.parent_worker;
+            // As in EagerSearch, only heuristics[0] is updated here.
+            lock_evaluation();
+            heuristics[0]->set_evaluator_value(node.get_h());
+            open_list->evaluate(node.get_g(), message.is_preferred);
+            int f = node.get_g();
+            if (f_evaluator) {
+                f_evaluator->evaluate(node.get_g(), message.is_preferred);
+                f = f_evaluator->get_value();
+            }
+            unlock_evaluation();
+            f_values[id] = f;
+            if (!engine.prune_by_f_value || f < engine.best_solution_g)
+                open_list->insert(id);
+        } else {
+            // if we do not reopen closed nodes, we just update the parent pointers
+            node.update_parent(message.g, message.real_g,
+                               message.parent_state_id, message.creating_operator);
+            parent_workers[id] = message.parent_worker;
+        }
+    }
+}
+
+bool HDASearch::Worker::receive_messages() {
+    MessageBatch *batch = incoming.pop_all();
+    if (!batch)
+        return false;
+    int num_bins = g_state_packer->get_num_bins();
+    int num_batches = 0;
+    while (batch) {
+        for (size_t i = 0; i < batch->messages.size(); ++i)
+            process(batch->messages[i], &batch->state_data[i * num_bins]);
+        MessageBatch *next = batch->next;
+        delete batch;
+        batch = next;
+        ++num_batches;
+    }
+    __sync_sub_and_fetch(&engine.pending_work, num_batches);
+    return true;
+}
+
+void HDASearch::Worker::expand_next_node() {
+    StateID id = open_list->remove_min();
+    SearchNode node = search_space.get_node(id);
+    if (node.is_closed())
+        return;
+    if (engine.prune_by_f_value && f_values[id] >= engine.best_solution_g)
+        return;
+    node.close();
+    search_progress.inc_expanded();
+
+    State state = node.get_state();
+    if (test_goal(state)) {
+        engine.report_solution(index, id, node.get_g());
+        return;
+    }
+
+    vector<const Operator *> applicable_ops;
+    g_successor_generator->generate_applicable_ops(state, applicable_ops);
+
+    set<const Operator *> preferred_ops;
+    if (!preferred_operator_heuristics.empty()) {
+        for (size_t i = 0; i < preferred_operator_heuristics.size(); ++i) {
+            vector<const Operator *> preferred;
+            if (evaluate_preferred_operator_heuristic(
+                    preferred_operator_heuristics[i], state, preferred))
+                preferred_ops.insert(preferred.begin(), preferred.end());
+        }
+        search_progress.inc_evaluations(preferred_operator_heuristics.size());
+    }
+
+    int num_bins = g_state_packer->get_num_bins();
+    vector<PackedStateBin> buffer(num_bins);
+    for (size_t i = 0; i < applicable_ops.size(); ++i) {
+        const Operator *op = applicable_ops[i];
+        if ((node.get_real_g() + op->get_cost()) >= engine.bound)
+            continue;
+        state_registry.compute_successor_data(state, *op, &buffer[0]);
+        search_progress.inc_generated();
+
+        Message message(index, id, op,
+                        node.get_g() + engine.get_adjusted_cost(*op),
+                        node.get_real_g() + op->get_cost(),
+                        preferred_ops.find(op) != preferred_ops.end());
+
+        int receiver = engine.get_owner(&buffer[0]);
+        if (receiver == index) {
+            process(message, &buffer[0]);
+        } else {
+            MessageBatch *&batch = outgoing[receiver];
+            if (!batch)
+                batch = new MessageBatch;
+            batch->messages.push_back(message);
+            batch->state_data.insert(batch->state_data.end(),
+                                     buffer.begin(), buffer.end());
+        }
+    }
+    flush_outgoing();
+}
+
+void HDASearch::Worker::flush_outgoing() {
+    for (size_t i = 0; i < outgoing.size(); ++i) {
+        if (outgoing[i]) {
+            engine.send(i, outgoing[i]);
+            outgoing[i] = 0;
+        }
+    }
+}
+
+void HDASearch::Worker::run() {
+    // The worker is counted as active in pending_work when it starts.
+    while (!engine.terminated) {
+        receive_messages();
+        if (!open_list->empty()) {
+            expand_next_node();
+            continue;
+        }
+        // Idle until we receive messages or the search ends.
+        if (__sync_sub_and_fetch(&engine.pending_work, 1) == 0) {
+            engine.terminated = true;
+            break;
+        }
+        while (incoming.empty() && !engine.terminated)
+            sched_yield();
+        __sync_add_and_fetch(&engine.pending_work, 1);
+    }
+}
+
+
+HDASearch::HDASearch(const Options &opts)
+    : SearchEngine(opts),
+      open_list_config(opts.contains("open") ?
+                       opts.get<ParseTree>("open") : ParseTree()),
+      f_evaluator_config(opts.contains("f_eval") ?
+                         opts.get<ParseTree>("f_eval") : ParseTree()),
+      eval_config(opts.contains("eval") ?
+                  opts.get<ParseTree>("eval") : ParseTree()),
+      preferred_configs(opts.get_list<ParseTree>("preferred")),
+      prune_by_f_value(opts.contains("f_eval") || opts.contains("eval")),
+      reopen_closed_nodes(opts.get<bool>("reopen_closed")),
+      num_workers(opts.get<int>("threads")),
+      pending_work(0),
+      terminated(false),
+      best_solution_g(numeric_limits<int>::max()),
+      goal_worker(-1),
+      goal_state_id(StateID::no_state) {
+    pthread_mutex_init(&solution_lock, 0);
+    pthread_mutex_init(&evaluation_lock, 0);
+}
+
+HDASearch::~HDASearch() {
+    for (size_t i = 0; i < workers.size(); ++i)
+        delete workers[i];
+    pthread_mutex_destroy(&solution_lock);
+    pthread_mutex_destroy(&evaluation_lock);
+}
+
+void HDASearch::initialize() {
+    cout << "Conducting hash-distributed best first search with "
+         << num_workers << " threads"
+         << (reopen_closed_nodes ? " with" : " without")
+         << " reopening closed nodes, (real) bound = " << bound
+         << endl;
+    if (!prune_by_f_value)
+        cout << "No f evaluator given: stopping at the first solution" << endl;
+
+    for (int i = 0; i < num_workers; ++i)
+        workers.push_back(new Worker(*this, i));
+
+    map<Heuristic *, int> num_users;
+    for (int i = 0; i < num_workers; ++i) {
+        const vector<Heuristic *> &heuristics = workers[i]->heuristics;
+        for (size_t j = 0; j < heuristics.size(); ++j)
+            ++num_users[heuristics[j]];
+    }
+    bool serialized = false;
+    for (int i = 0; i < num_workers; ++i) {
+        Worker &worker = *workers[i];
+        worker.setup_evaluation(num_users);
+        serialized |= find(worker.needs_lock.begin(), worker.needs_lock.end(),
+                           true) != worker.needs_lock.end();
+    }
+    if (serialized && num_workers > 1)
+        cout << "Some heuristics cannot be cloned for threads: "
+             << "their evaluations are serialized" << endl;
+
+    vector<PackedStateBin> buffer(g_state_packer->get_num_bins());
+    workers[0]->state_registry.compute_initial_state_data(&buffer[0]);
+    Message message(-1, StateID::no_state, 0, 0, 0, false);
+    Worker &initial_owner = *workers[get_owner(&buffer[0])];
+    initial_owner.process(message, &buffer[0]);
+    if (initial_owner.open_list->empty())
+        cout << "Initial state is a dead end." << endl;
+
+    // All workers start out active.
+    pending_work = num_workers;
+}
+
+int HDASearch::get_owner(const PackedStateBin *buffer) const {
+    size_t hash = ::hash_number_sequence(buffer, g_state_packer->get_num_bins());
+    /*
+      The registries of the workers use the low bits of (a different
+      mixing of) the same hash value as bucket index, so we must not
+      simply take the hash value modulo num_workers: every worker would
+      only use a fraction of its buckets.
+    */
+    unsigned int mixed = static_cast<unsigned int>(hash);
+    mixed *= 0x9e3779b1;
+    mixed ^= mixed >> 15;
+    mixed *= 0x85ebca6b;
+    mixed ^= mixed >> 13;
+    return mixed % num_workers;
+}
+
+void HDASearch::send(int receiver, MessageBatch *batch) {
+    // Count the batch before it can be received (see class comment).
+    __sync_add_and_fetch(&pending_work, 1);
+    workers[receiver]->incoming.push(batch);
+}
+
+void HDASearch::report_solution(int worker, StateID state_id, int g) {
+    pthread_mutex_lock(&solution_lock);
+    if (g < best_solution_g) {
+        best_solution_g = g;
+        goal_worker = worker;
+        goal_state_id = state_id;
+        cout << "Solution with cost " << g << " found by thread " << worker
+             << " [t=" << g_timer << "]" << endl;
+        if (!prune_by_f_value)
+            terminated = true;
+    }
+    pthread_mutex_unlock(&solution_lock);
+}
+
+void HDASearch::trace_path(Plan &plan) const {
+    assert(plan.empty());
+    int worker = goal_worker;
+    StateID id = goal_state_id;
+    for (;;) {
+        Worker &owner = *workers[worker];
+        SearchNode node = owner.search_space.get_node(id);
+        const Operator *op = node.get_creating_operator();
+        if (op == 0) {
+            assert(node.get_parent_state_id() == StateID::no_state);
+            break;
+        }
+        plan.push_back(op);
+        worker = owner.parent_workers[id];
+        id = node.get_parent_state_id();
+    }
+    reverse(plan.begin(), plan.end());
+}
+
+void *HDASearch::run_worker(void *worker) {
+    static_cast<Worker *>(worker)->run();
+    return 0;
+}
+
+int HDASearch::step() {
+    for (int i = 0; i < num_workers; ++i) {
+        if (pthread_create(&workers[i]->thread, 0, run_worker, workers[i]) != 0) {
+            cerr << "Could not create worker thread." << endl;
+            exit_with(EXIT_CRITICAL_ERROR);
+        }
+    }
+    for (int i = 0; i < num_workers; ++i)
+        pthread_join(workers[i]->thread, 0);
+
+    for (int i = 0; i < num_workers; ++i) {
+        const SearchProgress &progress = workers[i]->search_progress;
+        search_progress.inc_expanded(progress.get_expanded());
+        search_progress.inc_evaluated_states(progress.get_evaluated_states());
+        search_progress.inc_evaluations(progress.get_evaluations());
+        search_progress.inc_generated(progress.get_generated());
+        search_progress.inc_reopened(progress.get_reopened());
+        search_progress.inc_dead_ends(progress.get_dead_ends());
+    }
+
+    if (goal_worker == -1) {
+        cout << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+    cout << "Solution found!" << endl;
+    Plan plan;
+    trace_path(plan);
+    set_plan(plan);
+    return SOLVED;
+}
+
+void HDASearch::statistics() const {
+    search_progress.print_statistics();
+    size_t num_registered_states = 0;
+    for (int i = 0; i < num_workers; ++i) {
+        const Worker &worker = *workers[i];
+        cout << "Thread " << i << ": expanded "
+             << worker.search_progress.get_expanded() << " state(s), "
+             << worker.state_registry.size() << " registered state(s)."
+             << endl;
+        num_registered_states += worker.state_registry.size();
+    }
+    cout << "Number of registered states: " << num_registered_states << endl;
+}
+
+static void add_thread_option(OptionParser &parser) {
+    parser.add_option<int>("threads", "number of worker threads", "1");
+}
+
+static void check_thread_option(OptionParser &parser, const Options &opts) {
+    if (opts.get<int>("threads") < 1)
+        parser.error("threads must be at least 1");
+}
+
+static SearchEngine *_parse(OptionParser &parser) {
+    //open lists are currently registered with the parser on demand,
+    //because for templated classes the usual method of registering
+    //does not work:
+    Plugin<OpenList<StateID> >::register_open_lists();
+
+    parser.document_synopsis(
+        "Hash-distributed best first search (HDA*)",
+        "Eager best first search where the states are distributed among "
+        "worker threads by their hash values. Each thread has its own "
+        "open list (and evaluators), which are parsed from the given "
+        "configurations once per thread.");
+    parser.document_note(
+        "Termination",
+        "If f_eval is given, the search continues after the first solution "
+        "until all nodes with lower f values have been expanded, so the "
+        "solution is optimal if f_eval is admissible (e.g. sum([g(),h]) for "
+        "an admissible heuristic h). Otherwise it stops with the first "
+        "solution.");
+    parser.document_note(
+        "Heuristics",
+        "Heuristics that are predefined with --heuristic are shared between "
+        "all threads, other heuristics are created once per thread. "
+        "Threads evaluate their own copies of shared heuristics if the "
+        "heuristic supports this (e.g. hadd, hff, hmax, lmcut, PDBs and "
+        "merge-and-shrink; the copies share pattern databases and "
+        "abstractions), so predefining a heuristic saves memory and "
+        "precomputation. Evaluations of other heuristics are serialized. "
+        "Path-dependent heuristics (e.g. landmark count or incremental "
+        "LM-cut) are not supported.");
+
+    parser.add_option<ParseTree>("open", "open list");
+    parser.add_option<bool>("reopen_closed",
+                            "reopen closed nodes", "false");
+    parser.add_option<ParseTree>("f_eval",
+                                 "evaluator for pruning and termination",
+                                 "",
+                                 OptionFlags(false));
+    parser.add_list_option<ParseTree>
+        ("preferred",
+        "use preferred operators of these heuristics", "[]");
+    add_thread_option(parser);
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    if (parser.help_mode()) {
+        return 0;
+    }
+    check_thread_option(parser, opts);
+    if (parser.dry_run()) {
+        // check if the supplied evaluators can be parsed
+        OptionParser open_parser(opts.get<ParseTree>("open"), true);
+        open_parser.start_parsing<OpenList<StateID> *>();
+        if (opts.contains("f_eval")) {
+            OptionParser f_parser(opts.get<ParseTree>("f_eval"), true);
+            f_parser.start_parsing<ScalarEvaluator *>();
+        }
+        vector<ParseTree> preferred = opts.get_list<ParseTree>("preferred");
+        for (size_t i = 0; i < preferred.size(); ++i) {
+            OptionParser preferred_parser(preferred[i], true);
+            preferred_parser.start_parsing<Heuristic *>();
+        }
+        return 0;
+    } else {
+        return new HDASearch(opts);
+    }
+}
+
+static SearchEngine *_parse_astar(OptionParser &parser) {
+    parser.document_synopsis(
+        "HDA* search",
+        "Hash-distributed version of astar: every thread uses g+h as "
+        "f-function and breaks ties using the evaluator. Closed nodes are "
+        "re-opened. The result is optimal if the evaluator is admissible.");
+    parser.add_option<ParseTree>("eval", "evaluator for h-value");
+    add_thread_option(parser);
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    if (parser.help_mode()) {
+        return 0;
+    }
+    check_thread_option(parser, opts);
+    if (parser.dry_run()) {
+        OptionParser eval_parser(opts.get<ParseTree>("eval"), true);
+        eval_parser.start_parsing<ScalarEvaluator *>();
+        return 0;
+    } else {
+        opts.set("reopen_closed", true);
+        opts.set("preferred", vector<ParseTree>());
+        return new HDASearch(opts);
+    }
+}
+
+static Plugin<SearchEngine> _plugin("hda", _parse);
+static Plugin<SearchEngine> _plugin_astar("hdastar", _parse_astar);
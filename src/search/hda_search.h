@@ -0,0 +1,155 @@
+#ifndef HDA_SEARCH_H
+#define HDA_SEARCH_H
+
+#include "option_parser.h"
+#include "search_engine.h"
+#include "state.h"
+#include "state_id.h"
+
+#include <pthread.h>
+#include <vector>
+
+class Options;
+
+/*
+  Hash-distributed A* (HDA*, Kishimoto, Fukunaga and Botea, 2009).
+
+  The state space is partitioned among a number of worker threads by the
+  hash value of the (packed) state data. Each worker owns the states of
+  its partition: it has its own StateRegistry, SearchSpace and open list
+  and is the only thread that ever touches them. A worker repeatedly
+  expands the best node of its open list; successors that belong to
+  another worker are sent to that worker as messages (which contain the
+  state data, the path costs and a reference to the parent node), which
+  the receiver registers, evaluates and inserts into its own open list.
+  Since duplicates always end up at the same worker, duplicate detection
+  needs no synchronization.
+
+  Messages are collected per receiver and sent in batches (one per
+  receiver and expansion) through lock-free queues.
+
+  Termination: a solution found by a worker is not necessarily optimal
+  because other workers may still have nodes with lower f values. If an
+  f evaluator is given, the cost of the best solution found so far is
+  used to prune all nodes with an f value that is not lower, and the
+  search ends when all open lists are exhausted and no messages are in
+  transit. With an admissible f evaluator, the solution is then optimal.
+  Without an f evaluator, the search ends with the first solution, like
+  eager search.
+
+  All worker threads are idle and no messages are in transit exactly
+  when pending_work, the number of active workers plus the number of
+  batches that have been sent but not processed, is zero: workers only
+  send batches while they are active, and an idle worker becomes active
+  before it processes a batch, so pending_work can only become zero
+  when there is no work left, and never increases after that.
+
+  The open list, f evaluator and preferred operator heuristics are parsed
+  separately for every worker, so that each worker has its own evaluator
+  objects. Heuristics that are predefined with --heuristic are shared
+  between all workers, though. A worker evaluates a clone of each shared
+  heuristic (see Heuristic::clone_for_thread) and only copies the
+  resulting value into the shared heuristic, and evaluates the open list
+  and f evaluator, while holding evaluation_lock. Heuristics that
+  do not support clones are evaluated while holding the lock.
+*/
+class HDASearch : public SearchEngine {
+    class Worker;
+
+    struct Message {
+        // Reference to the parent node (in the search space of its worker).
+        int parent_worker;
+        StateID parent_state_id;
+        const Operator *creating_operator;
+        int g;
+        int real_g;
+        bool is_preferred;
+
+        Message(int parent_worker_, StateID parent_state_id_,
+                const Operator *creating_operator_, int g_, int real_g_,
+                bool is_preferred_)
+            : parent_worker(parent_worker_),
+              parent_state_id(parent_state_id_),
+              creating_operator(creating_operator_),
+              g(g_),
+              real_g(real_g_),
+              is_preferred(is_preferred_) {
+        }
+    };
+
+    /*
+      The messages of a batch are sent together. The state data of message
+      i is stored in state_data[i * num_bins, (i + 1) * num_bins).
+    */
+    struct MessageBatch {
+        std::vector<Message> messages;
+        std::vector<PackedStateBin> state_data;
+        MessageBatch *next;
+    };
+
+    /*
+      Lock-free queue of message batches with many senders and one
+      receiver. Senders push batches onto a linked stack with
+      compare-and-swap. The receiver always takes the whole stack at once
+      with an atomic exchange, which avoids the ABA problem of popping
+      single entries. The order in which batches are received does not
+      matter.
+    */
+    class MessageQueue {
+        MessageBatch *volatile head;
+    public:
+        MessageQueue() : head(0) {}
+        void push(MessageBatch *batch) {
+            MessageBatch *old_head;
+            do {
+                old_head = head;
+                batch->next = old_head;
+            } while (!__sync_bool_compare_and_swap(&head, old_head, batch));
+        }
+        MessageBatch *pop_all() {
+            if (head == 0)
+                return 0;
+            return __sync_lock_test_and_set(&head, static_cast<MessageBatch *>(0));
+        }
+        bool empty() const {return head == 0; }
+    };
+
+    // Configuration of the evaluators of each worker (see Worker).
+    const ParseTree open_list_config;
+    const ParseTree f_evaluator_config;
+    // Only used by hdastar, which builds the open list from eval.
+    const ParseTree eval_config;
+    const std::vector<ParseTree> preferred_configs;
+    const bool prune_by_f_value;
+    const bool reopen_closed_nodes;
+    const int num_workers;
+
+    std::vector<Worker *> workers;
+
+    // See the class comment.
+    volatile int pending_work;
+    volatile bool terminated;
+
+    // Best solution found so far, protected by solution_lock.
+    pthread_mutex_t solution_lock;
+    volatile int best_solution_g;
+    int goal_worker;
+    StateID goal_state_id;
+
+    pthread_mutex_t evaluation_lock;
+
+    int get_owner(const PackedStateBin *buffer) const;
+    void send(int receiver, MessageBatch *batch);
+    void report_solution(int worker, StateID state_id, int g);
+    void trace_path(Plan &plan) const;
+    static void *run_worker(void *worker);
+protected:
+    virtual void initialize();
+    virtual int step();
+public:
+    explicit HDASearch(const Options &opts);
+    virtual ~HDASearch();
+    virtual void statistics() const;
+};
+
+#endif
@@ -12,7 +12,9 @@ using namespace std;
 
 Heuristic::Heuristic(const Options &opts)
     : cost_type(OperatorCost(opts.get_enum("cost_type"))) {
+    initialized = false;
     heuristic = NOT_INITIALIZED;
+    preferred_operator_marker.resize(g_operators.size(), false);
     operator_marker1.resize(g_operators.size(), false);
 
     is_unit_cost = true;
@@ -28,8 +30,10 @@ Heuristic::~Heuristic() {
 }
 
 void Heuristic::set_preferred(const Operator *op) {
-    if (!op->is_marked()) {
-        op->mark();
+    int op_no = op - &*g_operators.begin();
+    assert(op_no >= 0 && op_no < g_operators.size());
+    if (!preferred_operator_marker[op_no]) {
+        preferred_operator_marker[op_no] = true;
         preferred_operators.push_back(op);
     }
 }
@@ -41,14 +45,20 @@ void Heuristic::add_to_op_bucket(const Operator *op) {
         operator_bucket.push_back(op);
     }
 }
-void Heuristic::evaluate(const State &state) {
-    if (heuristic == NOT_INITIALIZED)
+void Heuristic::ensure_initialized() {
+    if (!initialized) {
         initialize();
+        initialized = true;
+    }
+}
+
+void Heuristic::evaluate(const State &state) {
+    ensure_initialized();
     preferred_operators.clear();
     operator_bucket.clear();
     heuristic = compute_heuristic(state);
     for (int i = 0; i < preferred_operators.size(); i++)
-        preferred_operators[i]->unmark();
+        preferred_operator_marker[preferred_operators[i] - &*g_operators.begin()] = false;
     for (int i = 0; i < operator_bucket.size(); i++) 
         operator_marker1[operator_bucket[i] - &*g_operators.begin()] = false;
     assert(heuristic == DEAD_END || heuristic >= 0);
@@ -70,6 +80,46 @@ void Heuristic::evaluate(const State &state) {
     evaluator_value = heuristic;
 }
 
+/*
+  A clone that evaluates states with compute_heuristic of the heuristic
+  it was created from (see Heuristic::create_sharing_clone).
+*/
+class SharingHeuristicClone : public Heuristic {
+    Heuristic &original;
+protected:
+    virtual int compute_heuristic(const State &state) {
+        return original.compute_heuristic(state);
+    }
+    virtual Heuristic *create_thread_clone() {
+        return original.create_thread_clone();
+    }
+public:
+    explicit SharingHeuristicClone(Heuristic &original_)
+        : Heuristic(original_), original(original_) {
+        assert(initialized);
+    }
+    virtual bool dead_ends_are_reliable() const {
+        return original.dead_ends_are_reliable();
+    }
+};
+
+Heuristic *Heuristic::create_sharing_clone() {
+    return new SharingHeuristicClone(*this);
+}
+
+Heuristic *Heuristic::clone_for_thread() {
+    ensure_initialized();
+    return create_thread_clone();
+}
+
+void Heuristic::set_heuristic_value(int value) {
+    assert(value == DEAD_END || value >= 0);
+    preferred_operators.clear();
+    operator_bucket.clear();
+    heuristic = value;
+    evaluator_value = value;
+}
+
 bool Heuristic::is_dead_end() const {
     return evaluator_value == DEAD_END;
 }
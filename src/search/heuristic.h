@@ -16,13 +16,20 @@ class OptionParser;
 class Options;
 
 class Heuristic : public ScalarEvaluator {
+    friend class SharingHeuristicClone;
+
     enum {NOT_INITIALIZED = -2};
+    bool initialized;
     int heuristic;
     int evaluator_value; // usually equal to heuristic but can be different
     // if set with set_evaluator_value which is done if we use precalculated
     // estimates, eg. when re-opening a search node
 
     std::vector<const Operator *> preferred_operators;
+    // Marks the operators in preferred_operators. This is kept here
+    // instead of marking the (global) operators, so that different
+    // instances can be evaluated concurrently.
+    std::vector<bool> preferred_operator_marker;
     std::vector<const Operator *> operator_bucket;
     std::vector<bool> operator_marker1; // same concept for bucket as it is used for preferred ops
     bool is_unit_cost;
@@ -40,10 +47,28 @@ protected:
     bool is_unit_cost_problem() const {
         return is_unit_cost;
     }
+
+    /*
+      Implements clone_for_thread for initialized heuristics. The default
+      does not support clones; path-dependent heuristics (see reach_state)
+      cannot support them. A clone needs its own copy of all data that is
+      modified during evaluation, everything else can be shared.
+    */
+    virtual Heuristic *create_thread_clone() {return 0; }
+    /*
+      Returns a clone that computes its values with compute_heuristic of
+      this instance, which must outlive the clone. This can only be used
+      by heuristics whose compute_heuristic does not modify the instance
+      (in particular, does not set preferred operators) and shares all
+      precomputed data, such as pattern databases.
+    */
+    Heuristic *create_sharing_clone();
 public:
     Heuristic(const Options &options);
     virtual ~Heuristic();
 
+    // Computes the precomputed data now instead of in the first evaluation.
+    void ensure_initialized();
     void evaluate(const State &state);
     bool is_dead_end() const;
     int get_heuristic();
@@ -54,6 +79,8 @@ public:
     virtual bool dead_ends_are_reliable() const {return true; }
     virtual bool reach_state(const State &parent_state, const Operator &op,
                              const State &state);
+    // True if the values depend on the paths to the states (see reach_state).
+    virtual bool is_path_dependent() const {return false; }
     // notify heuristic that this state will not be needed again (possible for
     // depth first searches)
     // a node on the frontier is pruned in IDA* because its f value is too high
@@ -70,6 +97,21 @@ public:
     OperatorCost get_cost_type() const {return cost_type; }
     virtual void free_up_memory(SearchSpace & /*search_space*/) {}
 
+    /*
+      Returns a new instance of this heuristic that computes the same
+      values and can be evaluated in another thread while this instance
+      (or another clone) is evaluated, or 0 if this is not supported.
+      This instance is initialized first, so that its precomputed data
+      is not computed again for every clone.
+    */
+    Heuristic *clone_for_thread();
+    /*
+      Sets the result of the last evaluation to a value that was computed
+      by another instance (see EvaluationPool), as returned by get_value()
+      of that instance. There are no preferred operators afterwards.
+    */
+    void set_heuristic_value(int value);
+
     static void add_options_to_parser(OptionParser &parser);
     static Options default_options();
 };
@@ -11,7 +11,10 @@
 
 HMHeuristic::HMHeuristic(const Options &opts)
     : Heuristic(opts),
-      m(opts.get<int>("m")) {
+      m(opts.get<int>("m")),
+      arena("h^m heuristic"),
+      hm_table(std::less< ::tuple>(),
+               ArenaAllocator<std::pair<const ::tuple, int> >(&arena)) {
 }
 
 HMHeuristic::~HMHeuristic() {
@@ -46,7 +49,7 @@ int HMHeuristic::compute_heuristic(const State &state) {
 
 
 void HMHeuristic::init_hm_table(::tuple &t) {
-    std::map<::tuple, int>::iterator it;
+    HMTable::iterator it;
     for (it = hm_table.begin(); it != hm_table.end(); it++) {
         pair<::tuple, int> hm_ent = *it;
         ::tuple &tup = hm_ent.first;
@@ -86,7 +89,7 @@ void HMHeuristic::update_hm_table() {
 }
 
 void HMHeuristic::extend_tuple(::tuple &t, const Operator &op) {
-    map<::tuple, int>::const_iterator it;
+    HMTable::const_iterator it;
     for (it = hm_table.begin(); it != hm_table.end(); it++) {
         pair<::tuple, int> hm_ent = *it;
         ::tuple &entry = hm_ent.first;
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "arena_allocator.h"
 #include "heuristic.h"
 #include "globals.h"
 #include "state.h"
@@ -30,8 +31,12 @@ protected:
     // parameters
     int m;
 
-    // h^m table
-    std::map<tuple, int> hm_table;
+    // h^m table. The table is built once, so its nodes are allocated in
+    // the arena (the tuples are not).
+    typedef std::map<tuple, int, std::less<tuple>,
+                     ArenaAllocator<std::pair<const tuple, int> > > HMTable;
+    Arena arena;
+    HMTable hm_table;
     bool was_updated;
 
     void init_hm_table(tuple &t);
@@ -126,7 +131,7 @@ protected:
     void generate_all_partial_tuple(tuple &base_tuple, tuple &t, int index, int sz, std::vector<tuple> &res);
 
     void dump_table() const {
-        std::map<tuple, int>::const_iterator it;
+        HMTable::const_iterator it;
         for (it = hm_table.begin(); it != hm_table.end(); it++) {
             std::pair<tuple, int> hm_ent = *it;
             std::cout << "h[";
@@ -69,7 +69,7 @@ void IncrementalLandmarkCutHeuristic::reset_operator_costs(const State &state) {
         for (SavedLandmarks::iterator it_landmark = current_landmarks.begin(); it_landmark != current_landmarks.end(); ++it_landmark) {
             LandmarkPtr landmark = *it_landmark;
             for (Landmark::iterator it_op = landmark->begin(); it_op != landmark->end(); ++it_op) {
-                (*it_op)->cost -= landmark->cost;
+                operator_data[(*it_op)->id].cost -= landmark->cost;
             }
         }
     }
@@ -65,10 +65,13 @@ protected:
     virtual void discovered_landmark(const State &state, std::vector<RelaxedOperator *> &landmark, int cost);
     virtual void reset_operator_costs(const State &state);
     virtual int compute_heuristic(const State &state);
+    // Path-dependent, so there are no clones.
+    virtual Heuristic *create_thread_clone() {return 0; }
 public:
     IncrementalLandmarkCutHeuristic(const Options &opts);
     virtual ~IncrementalLandmarkCutHeuristic();
     virtual void free_up_memory(SearchSpace &search_space);
+    virtual bool is_path_dependent() const {return true; }
 };
 
 
@@ -0,0 +1,214 @@
+#ifndef INT_HASH_SET_H
+#define INT_HASH_SET_H
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+/*
+  IntHashSet is a hash set for non-negative int keys whose hash values and
+  equality are defined by the Hasher and Equal functors rather than by the
+  key values themselves. It is used by the StateRegistry to detect
+  duplicate states, where the keys are StateIDs and two keys are equal if
+  the corresponding states are equal.
+
+  Compared to a chained hash set (like __gnu_cxx::hash_set) it has the
+  following properties:
+    1. The keys are stored in one flat array of buckets (open addressing
+       with linear probing), so there is no allocation per entry and a
+       lookup usually touches only one or two cache lines.
+    2. Each bucket stores the hash value of its key next to the key. Since
+       keys are only compared with Equal if the stored hash values match,
+       most unsuccessful comparisons of full states are avoided. The stored
+       hashes also mean that Hasher is never called for keys that are
+       already in the set, not even when the table grows.
+    3. Growing the table is incremental: when the load factor limit is
+       reached, a table of twice the size is allocated and the entries of
+       the old table are moved over a few buckets at a time during
+       subsequent insertions. Lookups consult both tables while this
+       migration is in progress. This avoids a long rehash pause for large
+       tables (and also bounds the peak memory usage of growing to the old
+       plus the new table, as with vector).
+
+  Keys cannot be removed from the set.
+*/
+
+template<class Hasher, class Equal>
+class IntHashSet {
+    struct Bucket {
+        int key;
+        unsigned int hash;
+        Bucket()
+            : key(EMPTY_KEY), hash(0) {
+        }
+    };
+    static const int EMPTY_KEY = -1;
+    // The table grows when more than MAX_LOAD_PERCENT percent of the
+    // buckets are used.
+    static const size_t MAX_LOAD_PERCENT = 70;
+    // Number of buckets of the old table migrated per insertion while
+    // growing. With a load factor limit of 70%, migrating at least 2
+    // buckets per insertion guarantees that migration has finished before
+    // the new table needs to grow again.
+    static const size_t BUCKETS_MIGRATED_PER_INSERT = 4;
+    static const size_t INITIAL_CAPACITY = 1024;
+
+    Hasher hasher;
+    Equal equal;
+
+    std::vector<Bucket> buckets;
+    // Buckets of the previous table while it is migrated to buckets.
+    std::vector<Bucket> old_buckets;
+    size_t num_migrated_buckets;
+    // Number of keys stored in buckets (not counting old_buckets).
+    size_t num_used_buckets;
+    // Number of keys in the set.
+    size_t num_entries;
+
+    static unsigned int compute_hash(size_t hash) {
+        // Mix the high bits into the low bits that we use as bucket index.
+        hash ^= (hash >> 16);
+        hash *= 0x45d9f3b;
+        hash ^= (hash >> 16);
+        return static_cast<unsigned int>(hash);
+    }
+
+    static size_t get_bucket_index(const std::vector<Bucket> &table,
+                                   unsigned int hash) {
+        // The size of a table is always a power of two.
+        return hash & (table.size() - 1);
+    }
+
+    /*
+      Returns the index of the bucket of table that contains a key equal to
+      key, or the index of the empty bucket where key would have to be
+      inserted if there is no such key.
+    */
+    size_t find_bucket(const std::vector<Bucket> &table,
+                       int key, unsigned int hash) const {
+        size_t mask = table.size() - 1;
+        size_t index = get_bucket_index(table, hash);
+        while (true) {
+            const Bucket &bucket = table[index];
+            if (bucket.key == EMPTY_KEY ||
+                (bucket.hash == hash && equal(bucket.key, key)))
+                return index;
+            index = (index + 1) & mask;
+        }
+    }
+
+    void insert_into_empty_bucket(const Bucket &entry) {
+        // entry must not be present in buckets.
+        size_t mask = buckets.size() - 1;
+        size_t index = get_bucket_index(buckets, entry.hash);
+        while (buckets[index].key != EMPTY_KEY)
+            index = (index + 1) & mask;
+        buckets[index] = entry;
+        ++num_used_buckets;
+    }
+
+    bool is_migrating() const {
+        return !old_buckets.empty();
+    }
+
+    void migrate_some_buckets() {
+        size_t end = std::min(num_migrated_buckets + BUCKETS_MIGRATED_PER_INSERT,
+                              old_buckets.size());
+        for (; num_migrated_buckets < end; ++num_migrated_buckets) {
+            const Bucket &bucket = old_buckets[num_migrated_buckets];
+            if (bucket.key != EMPTY_KEY)
+                insert_into_empty_bucket(bucket);
+        }
+        if (num_migrated_buckets == old_buckets.size()) {
+            // Release the memory of the old table.
+            std::vector<Bucket>().swap(old_buckets);
+            num_migrated_buckets = 0;
+        }
+    }
+
+    void start_growing() {
+        assert(!is_migrating());
+        old_buckets.swap(buckets);
+        buckets.resize(2 * old_buckets.size());
+        num_migrated_buckets = 0;
+        num_used_buckets = 0;
+    }
+
+    bool is_full() const {
+        return num_used_buckets * 100 > buckets.size() * MAX_LOAD_PERCENT;
+    }
+public:
+    IntHashSet(const Hasher &hasher_, const Equal &equal_)
+        : hasher(hasher_),
+          equal(equal_),
+          buckets(INITIAL_CAPACITY),
+          num_migrated_buckets(0),
+          num_used_buckets(0),
+          num_entries(0) {
+    }
+
+    ~IntHashSet() {
+    }
+
+    /*
+      Inserts key if no equal key is present yet. Returns the key in the set
+      that is equal to key (which is key itself if it was inserted) and
+      whether key was inserted.
+    */
+    std::pair<int, bool> insert(int key) {
+        assert(key >= 0);
+        unsigned int hash = compute_hash(hasher(key));
+
+        if (is_migrating()) {
+            migrate_some_buckets();
+            /*
+              Migrated buckets are not removed from the old table, so a key
+              found here is either still in the old table only or has
+              already been copied to the new table. Either way it is in the
+              set.
+            */
+            if (is_migrating()) {
+                const Bucket &bucket =
+                    old_buckets[find_bucket(old_buckets, key, hash)];
+                if (bucket.key != EMPTY_KEY)
+                    return std::make_pair(bucket.key, false);
+            }
+        }
+
+        size_t index = find_bucket(buckets, key, hash);
+        Bucket &bucket = buckets[index];
+        if (bucket.key != EMPTY_KEY)
+            return std::make_pair(bucket.key, false);
+
+        bucket.key = key;
+        bucket.hash = hash;
+        ++num_used_buckets;
+        ++num_entries;
+        if (is_full())
+            start_growing();
+        return std::make_pair(key, true);
+    }
+
+    /*
+      Returns the key in the set that is equal to key, or -1 if there is
+      no such key. key itself is not inserted.
+    */
+    int find(int key) const {
+        assert(key >= 0);
+        unsigned int hash = compute_hash(hasher(key));
+        if (is_migrating()) {
+            const Bucket &bucket =
+                old_buckets[find_bucket(old_buckets, key, hash)];
+            if (bucket.key != EMPTY_KEY)
+                return bucket.key;
+        }
+        return buckets[find_bucket(buckets, key, hash)].key;
+    }
+
+    size_t size() const {
+        return num_entries;
+    }
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef INT_PACKER_H
+#define INT_PACKER_H
+
+#include <cassert>
+#include <vector>
+
+/*
+  Utility class to pack lots of unsigned integers (called "variables"
+  in the code below) with a small domain {0, ..., range - 1}
+  compactly into a sequence of bins of a fixed width (Bin).
+
+  Each variable occupies ceil(log2(range)) bits, but at least one bit.
+  Variables never cross bin boundaries: a variable is always stored
+  entirely within one bin. Bins are filled greedily, always placing the
+  largest remaining variable that still fits into the current bin.
+
+  The class does not own the packed data. Clients allocate arrays of
+  get_num_bins() bins and use get() and set() to access them.
+
+  This is used by the StateRegistry to store registered states compactly.
+*/
+class IntPacker {
+public:
+    typedef unsigned int Bin;
+    static const int BITS_PER_BIN = sizeof(Bin) * 8;
+private:
+    class VariableInfo {
+        int range;
+        int bin_index;
+        int shift;
+        Bin read_mask;
+        Bin clear_mask;
+    public:
+        VariableInfo(int range_, int bin_index_, int shift_);
+        VariableInfo();
+        ~VariableInfo();
+
+        int get(const Bin *buffer) const {
+            return (buffer[bin_index] & read_mask) >> shift;
+        }
+
+        void set(Bin *buffer, int value) const {
+            assert(value >= 0 && value < range);
+            Bin &bin = buffer[bin_index];
+            bin = (bin & clear_mask) | (Bin(value) << shift);
+        }
+
+        int get_condition(int value, Bin &mask, Bin &bits) const {
+            assert(value >= 0 && value < range);
+            mask = read_mask;
+            bits = Bin(value) << shift;
+            return bin_index;
+        }
+    };
+
+    std::vector<VariableInfo> var_infos;
+    int num_bins;
+
+    int pack_one_bin(const std::vector<int> &ranges,
+                     std::vector<std::vector<int> > &bits_to_vars);
+    void pack_bins(const std::vector<int> &ranges);
+public:
+    /*
+      The constructor takes the range for each variable. The domain of
+      variable i is {0, ..., ranges[i] - 1}. Because we only use this
+      class for state packing at the moment, ranges must fit into an int.
+    */
+    explicit IntPacker(const std::vector<int> &ranges);
+    ~IntPacker();
+
+    int get(const Bin *buffer, int var) const {
+        return var_infos[var].get(buffer);
+    }
+
+    void set(Bin *buffer, int var, int value) const {
+        var_infos[var].set(buffer, value);
+    }
+
+    /*
+      Returns the index of the bin of var and sets mask and bits such
+      that var has the given value in buffer iff
+      (buffer[bin] & mask) == bits. Conditions on variables in the same
+      bin can be combined by or-ing their masks and bits.
+    */
+    int get_condition(int var, int value, Bin &mask, Bin &bits) const {
+        return var_infos[var].get_condition(value, mask, bits);
+    }
+
+    int get_num_bins() const {
+        return num_bins;
+    }
+};
+
+#endif
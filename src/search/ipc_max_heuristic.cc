@@ -51,6 +51,13 @@ bool IPCMaxHeuristic::reach_state(const State &parent_state, const Operator &op,
     return result;
 }
 
+bool IPCMaxHeuristic::is_path_dependent() const {
+    for (int i = 0; i < evaluators.size(); i++)
+        if (evaluators[i]->is_path_dependent())
+            return true;
+    return false;
+}
+
 static Heuristic *_parse(OptionParser &parser) {
     parser.document_hide(); //don't show documentation for this temporary class (see issue198)
     parser.document_synopsis("IPC-Max Heuristic", "");
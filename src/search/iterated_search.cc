@@ -1,6 +1,8 @@
 #include "iterated_search.h"
 #include "plugin.h"
+#include "shared_plan_bound.h"
 #include "ext/tree_util.hh"
+#include <algorithm>
 #include <limits>
 
 IteratedSearch::IteratedSearch(const Options &opts)
@@ -54,11 +56,22 @@ SearchEngine *IteratedSearch::create_phase(int p) {
     return get_search_engine(p);
 }
 
+void IteratedSearch::update_best_bound() {
+    /*
+      In a parallel portfolio, the other configurations may have found
+      better plans in the meantime. The phases also prune with them
+      while they run (see SearchEngine::search).
+    */
+    if (g_shared_plan_bound)
+        best_bound = min(best_bound, g_shared_plan_bound->get_best_plan_cost());
+}
+
 int IteratedSearch::step() {
     current_search = create_phase(phase);
     if (current_search == NULL) {
         return found_solution() ? SOLVED : FAILED;
     }
+    update_best_bound();
     if (pass_bound) {
         current_search->set_bound(best_bound);
     }
@@ -73,6 +86,7 @@ int IteratedSearch::step() {
         iterated_found_solution = true;
         found_plan = current_search->get_plan();
         plan_cost = calculate_plan_cost(found_plan);
+        update_best_bound();
         if (plan_cost < best_bound) {
             ++plan_counter;
             save_plan(found_plan, plan_counter);
@@ -26,6 +26,7 @@ class IteratedSearch : public SearchEngine {
 
     SearchEngine *get_search_engine(int engine_config_start_index);
     SearchEngine *create_phase(int p);
+    void update_best_bound();
     int step_return_value();
 
     virtual void initialize();
@@ -29,6 +29,7 @@ using namespace __gnu_cxx;
 // Construction and destruction
 Exploration::Exploration(const Options &opts)
     : Heuristic(opts),
+      arena("landmark exploration"),
       did_write_overflow_warning(false) {
     cout << "Initializing Exploration..." << endl;
 
@@ -50,7 +51,15 @@ Exploration::Exploration(const Options &opts)
         termination_propositions.push_back(&propositions[var][val]);
     }
 
-    // Build unary operators for operators and axioms.
+    // Build unary operators for operators and axioms. Reserve space for
+    // all of them, so that their preconditions in the arena are not copied
+    // when unary_operators grows.
+    int num_unary_operators = 0;
+    for (int i = 0; i < g_operators.size(); i++)
+        num_unary_operators += g_operators[i].get_pre_post().size();
+    for (int i = 0; i < g_axioms.size(); i++)
+        num_unary_operators += g_axioms[i].get_pre_post().size();
+    unary_operators.reserve(num_unary_operators);
     for (int i = 0; i < g_operators.size(); i++)
         build_unary_operators(g_operators[i]);
     for (int i = 0; i < g_axioms.size(); i++)
@@ -62,6 +71,10 @@ Exploration::Exploration(const Options &opts)
         for (int j = 0; j < op->precondition.size(); j++)
             op->precondition[j]->precondition_of.push_back(op);
     }
+    for (int var = 0; var < propositions.size(); var++) {
+        for (int val = 0; val < propositions[var].size(); val++)
+            copy_to_arena(propositions[var][val].precondition_of, arena);
+    }
     // Set flag that before heuristic values can be used, computation
     // (relaxed exploration) needs to be done
     heuristic_recomputation_needed = true;
@@ -156,7 +169,10 @@ void Exploration::build_unary_operators(const Operator &op) {
             precondition.push_back(&propositions[precondition_var_vals2[j].first]
                                    [precondition_var_vals2[j].second]);
 
-        unary_operators.push_back(ExUnaryOperator(precondition, effect, &op, base_cost));
+        assert(unary_operators.size() < unary_operators.capacity());
+        unary_operators.push_back(ExUnaryOperator(effect, &op, base_cost, arena));
+        unary_operators.back().precondition.assign(precondition.begin(),
+                                                   precondition.end());
         // precondition.erase(precondition.end() - eff_cond.size(), precondition.end());
         precondition.clear();
         precondition_var_vals2.clear();
@@ -242,7 +258,7 @@ void Exploration::relaxed_exploration(bool use_h_max = false, bool level_out = f
             continue;
         if (!level_out && prop->is_termination_condition && --unsolved_goals == 0)
             return;
-        const vector<ExUnaryOperator *> &triggered_operators = prop->precondition_of;
+        const ExUnaryOperatorList &triggered_operators = prop->precondition_of;
         for (int i = 0; i < triggered_operators.size(); i++) {
             ExUnaryOperator *unary_op = triggered_operators[i];
             if (unary_op->h_add_cost == -2) // operator is not applied
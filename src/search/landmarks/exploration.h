@@ -1,6 +1,7 @@
 #ifndef LANDMARKS_EXPLORATION_H
 #define LANDMARKS_EXPLORATION_H
 
+#include "../arena_allocator.h"
 #include "../heuristic.h"
 #include "../globals.h"
 #include "../priority_queue.h"
@@ -17,12 +18,17 @@ class State;
 class ExProposition;
 class ExUnaryOperator;
 
+// The lists of the relaxed task are stored in the arena of the exploration.
+typedef std::vector<ExProposition *, ArenaAllocator<ExProposition *> > ExPropositionList;
+typedef std::vector<ExUnaryOperator *, ArenaAllocator<ExUnaryOperator *> > ExUnaryOperatorList;
+
 struct ExProposition {
     int var;
     int val;
     bool is_goal_condition;
     bool is_termination_condition;
-    std::vector<ExUnaryOperator *> precondition_of;
+    // Filled on the heap and then copied to the arena.
+    ExUnaryOperatorList precondition_of;
 
     int h_add_cost;
     int h_max_cost;
@@ -46,7 +52,7 @@ struct ExProposition {
 
 struct ExUnaryOperator {
     const Operator *op;
-    std::vector<ExProposition *> precondition;
+    ExPropositionList precondition;
     ExProposition *effect;
     int base_cost; // 0 for axioms, 1 for regular operators
 
@@ -54,9 +60,11 @@ struct ExUnaryOperator {
     int h_add_cost;
     int h_max_cost;
     int depth;
-    ExUnaryOperator(const std::vector<ExProposition *> &pre, ExProposition *eff,
-                    const Operator *the_op, int base)
-        : op(the_op), precondition(pre), effect(eff), base_cost(base) {}
+    // The precondition is filled after the operator has been stored.
+    ExUnaryOperator(ExProposition *eff, const Operator *the_op, int base,
+                    Arena &arena)
+        : op(the_op), precondition(ArenaAllocator<ExProposition *>(&arena)),
+          effect(eff), base_cost(base) {}
 
 
     bool operator<(const ExUnaryOperator &other) const {
@@ -90,6 +98,7 @@ class Exploration : public Heuristic {
 
     typedef __gnu_cxx::hash_set<const Operator *, ex_hash_operator_ptr> RelaxedPlan;
     RelaxedPlan relaxed_plan;
+    Arena arena;
     std::vector<ExUnaryOperator> unary_operators;
     std::vector<std::vector<ExProposition> > propositions;
     std::vector<ExProposition *> goal_propositions;
@@ -55,6 +55,7 @@ public:
     }
     virtual bool reach_state(const State &parent_state, const Operator &op,
                              const State &state);
+    virtual bool is_path_dependent() const {return true; }
     virtual bool dead_ends_are_reliable() const {
         return true;
     }
@@ -35,6 +35,8 @@ void LazySearch::set_pref_operator_heuristics(
 void LazySearch::initialize() {
     //TODO children classes should output which kind of search
     cout << "Conducting lazy best first search, (real) bound = " << bound << endl;
+    if (!bound_heuristics.empty())
+        cout << "Pruning states whose g+h reaches the bound" << endl;
 
     assert(open_list != NULL);
     set<Heuristic *> hset;
@@ -49,6 +51,7 @@ void LazySearch::initialize() {
     // not also used in the open list)
     hset.insert(preferred_operator_heuristics.begin(),
                 preferred_operator_heuristics.end());
+    hset.insert(bound_heuristics.begin(), bound_heuristics.end());
 
     for (set<Heuristic *>::iterator it = hset.begin(); it != hset.end(); it++) {
         heuristics.push_back(*it);
@@ -161,6 +164,16 @@ int LazySearch::step() {
         search_progress.inc_evaluations(heuristics.size());
         open_list->evaluate(current_g, false);
         if (!open_list->is_dead_end()) {
+            /*
+              States are only evaluated when they are expanded, so this
+              prunes with the current bound. The node is left unchanged,
+              so the state is evaluated again if it is reached on a
+              cheaper path.
+            */
+            if (exceeds_bound(current_real_g)) {
+                search_progress.inc_bound_pruned();
+                return fetch_next_state();
+            }
             // We use the value of the first heuristic, because SearchSpace only
             // supported storing one heuristic value
             int h = heuristics[0]->get_value();
@@ -208,6 +221,7 @@ static SearchEngine *_parse(OptionParser &parser) {
         "preferred",
         "use preferred operators of these heuristics", "[]");
     SearchEngine::add_options_to_parser(parser);
+    SearchEngine::add_bound_pruning_option(parser);
     Options opts = parser.parse();
 
     LazySearch *engine = 0;
@@ -246,6 +260,7 @@ static SearchEngine *_parse_greedy(OptionParser &parser) {
         "to preferred operator nodes",
         OptionParser::to_str(DEFAULT_LAZY_BOOST));
     SearchEngine::add_options_to_parser(parser);
+    SearchEngine::add_bound_pruning_option(parser);
     Options opts = parser.parse();
 
     LazySearch *engine = 0;
@@ -304,6 +319,7 @@ static SearchEngine *_parse_weighted_astar(OptionParser &parser) {
                            OptionParser::to_str(DEFAULT_LAZY_BOOST));
     parser.add_option<int>("w", "heuristic weight", "1");
     SearchEngine::add_options_to_parser(parser);
+    SearchEngine::add_bound_pruning_option(parser);
     Options opts = parser.parse();
 
     opts.verify_list_non_empty<ScalarEvaluator *>("evals");
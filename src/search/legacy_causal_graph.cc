@@ -1,13 +1,14 @@
 #include "legacy_causal_graph.h"
 
 #include "globals.h"
+#include "task_reader.h"
 
 #include <algorithm>
 #include <cassert>
 #include <iostream>
 using namespace std;
 
-LegacyCausalGraph::LegacyCausalGraph(istream &in) {
+LegacyCausalGraph::LegacyCausalGraph(TaskReader &in) {
     check_magic(in, "begin_CG");
     int var_count = g_variable_domain.size();
     arcs.resize(var_count);
@@ -4,6 +4,7 @@
 #include <iosfwd>
 #include <vector>
 
+class TaskReader;
 
 class LegacyCausalGraph {
     /*
@@ -17,7 +18,7 @@ class LegacyCausalGraph {
     std::vector<std::vector<int> > inverse_arcs;
     std::vector<std::vector<int> > edges;
 public:
-    LegacyCausalGraph(std::istream &in);
+    LegacyCausalGraph(TaskReader &in);
     ~LegacyCausalGraph() {}
     const std::vector<int> &get_successors(int var) const;
     const std::vector<int> &get_predecessors(int var) const;
@@ -16,30 +16,56 @@ using namespace std;
 
 
 // construction and destruction
+LandmarkCutHeuristic::RelaxedTask::RelaxedTask()
+    : arena("landmark cut heuristic"),
+      artificial_precondition(0),
+      artificial_goal(1),
+      num_propositions(2) {
+}
+
 LandmarkCutHeuristic::LandmarkCutHeuristic(const Options &opts)
     : Heuristic(opts) {
-    num_propositions = 2; // artificial goal and artificial precondition
+}
+
+LandmarkCutHeuristic::LandmarkCutHeuristic(const LandmarkCutHeuristic &other)
+    : Heuristic(other),
+      task(other.task),
+      operator_data(other.operator_data),
+      proposition_data(other.proposition_data) {
 }
 
 LandmarkCutHeuristic::~LandmarkCutHeuristic() {
 }
 
+Heuristic *LandmarkCutHeuristic::create_thread_clone() {
+    return new LandmarkCutHeuristic(*this);
+}
+
 // initialization
 void LandmarkCutHeuristic::initialize() {
     cout << "Initializing landmark cut heuristic..." << endl;
 
     ::verify_no_axioms_no_cond_effects();
 
+    task.reset(new RelaxedTask);
+    Arena &arena = task->arena;
+    vector<vector<RelaxedProposition> > &propositions = task->propositions;
+    vector<RelaxedOperator> &relaxed_operators = task->relaxed_operators;
+
     // Build propositions.
-    assert(num_propositions == 2);
+    assert(task->num_propositions == 2);
     propositions.resize(g_variable_domain.size());
     for (int var = 0; var < g_variable_domain.size(); var++) {
         for (int value = 0; value < g_variable_domain[var]; value++)
-            propositions[var].push_back(RelaxedProposition());
-        num_propositions += g_variable_domain[var];
+            propositions[var].push_back(
+                RelaxedProposition(task->num_propositions + value));
+        task->num_propositions += g_variable_domain[var];
     }
 
-    // Build relaxed operators for operators and axioms.
+    // Build relaxed operators for operators and axioms. Reserve space for
+    // all of them (including the goal operator), so that their lists in
+    // the arena are not copied when relaxed_operators grows.
+    relaxed_operators.reserve(g_operators.size() + 1);
     for (int i = 0; i < g_operators.size(); i++)
         build_relaxed_operator(g_operators[i]);
 
@@ -56,7 +82,7 @@ void LandmarkCutHeuristic::initialize() {
         RelaxedProposition *goal_prop = &propositions[var][val];
         goal_op_pre.push_back(goal_prop);
     }
-    goal_op_eff.push_back(&artificial_goal);
+    goal_op_eff.push_back(&task->artificial_goal);
     add_relaxed_operator(goal_op_pre, goal_op_eff, 0, 0);
 
     // Cross-reference relaxed operators.
@@ -67,9 +93,24 @@ void LandmarkCutHeuristic::initialize() {
         for (int j = 0; j < op->effects.size(); j++)
             op->effects[j]->effect_of.push_back(op);
     }
+    copy_to_arena(task->artificial_precondition.precondition_of, arena);
+    copy_to_arena(task->artificial_precondition.effect_of, arena);
+    copy_to_arena(task->artificial_goal.precondition_of, arena);
+    copy_to_arena(task->artificial_goal.effect_of, arena);
+    for (int var = 0; var < propositions.size(); var++) {
+        for (int value = 0; value < propositions[var].size(); value++) {
+            RelaxedProposition &prop = propositions[var][value];
+            copy_to_arena(prop.precondition_of, arena);
+            copy_to_arena(prop.effect_of, arena);
+        }
+    }
+
+    operator_data.resize(relaxed_operators.size());
+    proposition_data.resize(task->num_propositions);
 }
 
 void LandmarkCutHeuristic::build_relaxed_operator(const Operator &op) {
+    vector<vector<RelaxedProposition> > &propositions = task->propositions;
     const vector<Prevail> &prevail = op.get_prevail();
     const vector<PrePost> &pre_post = op.get_pre_post();
     vector<RelaxedProposition *> precondition;
@@ -89,40 +130,44 @@ void LandmarkCutHeuristic::add_relaxed_operator(
     const vector<RelaxedProposition *> &precondition,
     const vector<RelaxedProposition *> &effects,
     const Operator *op, int base_cost) {
-    RelaxedOperator relaxed_op(precondition, effects, op, base_cost);
-    if (relaxed_op.precondition.empty())
-        relaxed_op.precondition.push_back(&artificial_precondition);
-    relaxed_operators.push_back(relaxed_op);
+    // Fill the lists of the stored operator, so that they are only
+    // allocated once.
+    vector<RelaxedOperator> &relaxed_operators = task->relaxed_operators;
+    assert(relaxed_operators.size() < relaxed_operators.capacity());
+    relaxed_operators.push_back(RelaxedOperator(
+                                    op, relaxed_operators.size(), base_cost,
+                                    task->arena));
+    RelaxedOperator &relaxed_op = relaxed_operators.back();
+    if (precondition.empty())
+        relaxed_op.precondition.assign(1, &task->artificial_precondition);
+    else
+        relaxed_op.precondition.assign(precondition.begin(), precondition.end());
+    relaxed_op.effects.assign(effects.begin(), effects.end());
 }
 
 // heuristic computation
 void LandmarkCutHeuristic::setup_exploration_queue() {
     priority_queue.clear();
 
-    for (int var = 0; var < propositions.size(); var++) {
-        for (int value = 0; value < propositions[var].size(); value++) {
-            RelaxedProposition &prop = propositions[var][value];
-            prop.status = UNREACHED;
-        }
-    }
-
-    artificial_goal.status = UNREACHED;
-    artificial_precondition.status = UNREACHED;
+    for (int i = 0; i < proposition_data.size(); i++)
+        proposition_data[i].status = UNREACHED;
 
+    const vector<RelaxedOperator> &relaxed_operators = task->relaxed_operators;
     for (int i = 0; i < relaxed_operators.size(); i++) {
-        RelaxedOperator &op = relaxed_operators[i];
-        op.unsatisfied_preconditions = op.precondition.size();
-        op.h_max_supporter = 0;
-        op.h_max_supporter_cost = numeric_limits<int>::max();
+        RelaxedOperatorData &op_data = operator_data[i];
+        op_data.unsatisfied_preconditions = relaxed_operators[i].precondition.size();
+        op_data.h_max_supporter = 0;
+        op_data.h_max_supporter_cost = numeric_limits<int>::max();
     }
 }
 
 void LandmarkCutHeuristic::setup_exploration_queue_state(const State &state) {
+    vector<vector<RelaxedProposition> > &propositions = task->propositions;
     for (int var = 0; var < propositions.size(); var++) {
         RelaxedProposition *init_prop = &propositions[var][state[var]];
         enqueue_if_necessary(init_prop, 0);
     }
-    enqueue_if_necessary(&artificial_precondition, 0);
+    enqueue_if_necessary(&task->artificial_precondition, 0);
 }
 
 void LandmarkCutHeuristic::first_exploration(const State &state) {
@@ -133,20 +178,21 @@ void LandmarkCutHeuristic::first_exploration(const State &state) {
         pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
         int popped_cost = top_pair.first;
         RelaxedProposition *prop = top_pair.second;
-        int prop_cost = prop->h_max_cost;
+        int prop_cost = get_data(prop).h_max_cost;
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
+        const RelaxedOperatorList &triggered_operators =
             prop->precondition_of;
         for (int i = 0; i < triggered_operators.size(); i++) {
             RelaxedOperator *relaxed_op = triggered_operators[i];
-            relaxed_op->unsatisfied_preconditions--;
-            assert(relaxed_op->unsatisfied_preconditions >= 0);
-            if (relaxed_op->unsatisfied_preconditions == 0) {
-                relaxed_op->h_max_supporter = prop;
-                relaxed_op->h_max_supporter_cost = prop_cost;
-                int target_cost = prop_cost + relaxed_op->cost;
+            RelaxedOperatorData &op_data = get_data(relaxed_op);
+            op_data.unsatisfied_preconditions--;
+            assert(op_data.unsatisfied_preconditions >= 0);
+            if (op_data.unsatisfied_preconditions == 0) {
+                op_data.h_max_supporter = prop;
+                op_data.h_max_supporter_cost = prop_cost;
+                int target_cost = prop_cost + op_data.cost;
                 for (int j = 0; j < relaxed_op->effects.size(); j++) {
                     RelaxedProposition *effect = relaxed_op->effects[j];
                     enqueue_if_necessary(effect, target_cost);
@@ -164,10 +210,11 @@ void LandmarkCutHeuristic::first_exploration_incremental(
        heap-based too aggressively. This should prevent ever switching
        to heap-based in problems where action costs are at most 1.
     */
-    priority_queue.add_virtual_pushes(num_propositions);
+    priority_queue.add_virtual_pushes(task->num_propositions);
     for (int i = 0; i < cut.size(); i++) {
         RelaxedOperator *relaxed_op = cut[i];
-        int cost = relaxed_op->h_max_supporter_cost + relaxed_op->cost;
+        const RelaxedOperatorData &op_data = get_data(relaxed_op);
+        int cost = op_data.h_max_supporter_cost + op_data.cost;
         for (int j = 0; j < relaxed_op->effects.size(); j++) {
             RelaxedProposition *effect = relaxed_op->effects[j];
             enqueue_if_necessary(effect, cost);
@@ -177,23 +224,24 @@ void LandmarkCutHeuristic::first_exploration_incremental(
         pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
         int popped_cost = top_pair.first;
         RelaxedProposition *prop = top_pair.second;
-        int prop_cost = prop->h_max_cost;
+        int prop_cost = get_data(prop).h_max_cost;
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
+        const RelaxedOperatorList &triggered_operators =
             prop->precondition_of;
         for (int i = 0; i < triggered_operators.size(); i++) {
             RelaxedOperator *relaxed_op = triggered_operators[i];
-            if (relaxed_op->h_max_supporter == prop) {
-                int old_supp_cost = relaxed_op->h_max_supporter_cost;
+            RelaxedOperatorData &op_data = get_data(relaxed_op);
+            if (op_data.h_max_supporter == prop) {
+                int old_supp_cost = op_data.h_max_supporter_cost;
                 if (old_supp_cost > prop_cost) {
-                    relaxed_op->update_h_max_supporter();
-                    int new_supp_cost = relaxed_op->h_max_supporter_cost;
+                    update_h_max_supporter(relaxed_op);
+                    int new_supp_cost = op_data.h_max_supporter_cost;
                     if (new_supp_cost != old_supp_cost) {
                         // This operator has become cheaper.
                         assert(new_supp_cost < old_supp_cost);
-                        int target_cost = new_supp_cost + relaxed_op->cost;
+                        int target_cost = new_supp_cost + op_data.cost;
                         for (int j = 0; j < relaxed_op->effects.size(); j++) {
                             RelaxedProposition *effect = relaxed_op->effects[j];
                             enqueue_if_necessary(effect, target_cost);
@@ -210,28 +258,29 @@ void LandmarkCutHeuristic::second_exploration(
     assert(second_exploration_queue.empty());
     assert(cut.empty());
 
-    artificial_precondition.status = BEFORE_GOAL_ZONE;
-    second_exploration_queue.push_back(&artificial_precondition);
+    get_data(&task->artificial_precondition).status = BEFORE_GOAL_ZONE;
+    second_exploration_queue.push_back(&task->artificial_precondition);
 
+    vector<vector<RelaxedProposition> > &propositions = task->propositions;
     for (int var = 0; var < propositions.size(); var++) {
         RelaxedProposition *init_prop = &propositions[var][state[var]];
-        init_prop->status = BEFORE_GOAL_ZONE;
+        get_data(init_prop).status = BEFORE_GOAL_ZONE;
         second_exploration_queue.push_back(init_prop);
     }
 
     while (!second_exploration_queue.empty()) {
         RelaxedProposition *prop = second_exploration_queue.back();
         second_exploration_queue.pop_back();
-        const vector<RelaxedOperator *> &triggered_operators =
+        const RelaxedOperatorList &triggered_operators =
             prop->precondition_of;
         for (int i = 0; i < triggered_operators.size(); i++) {
             RelaxedOperator *relaxed_op = triggered_operators[i];
-            if (relaxed_op->h_max_supporter == prop) {
+            if (get_data(relaxed_op).h_max_supporter == prop) {
                 bool reached_goal_zone = false;
                 for (int j = 0; j < relaxed_op->effects.size(); j++) {
                     RelaxedProposition *effect = relaxed_op->effects[j];
-                    if (effect->status == GOAL_ZONE) {
-                        assert(relaxed_op->cost > 0);
+                    if (get_data(effect).status == GOAL_ZONE) {
+                        assert(get_data(relaxed_op).cost > 0);
                         reached_goal_zone = true;
                         cut.push_back(relaxed_op);
                         break;
@@ -240,9 +289,10 @@ void LandmarkCutHeuristic::second_exploration(
                 if (!reached_goal_zone) {
                     for (int j = 0; j < relaxed_op->effects.size(); j++) {
                         RelaxedProposition *effect = relaxed_op->effects[j];
-                        if (effect->status != BEFORE_GOAL_ZONE) {
-                            assert(effect->status == REACHED);
-                            effect->status = BEFORE_GOAL_ZONE;
+                        RelaxedPropositionData &effect_data = get_data(effect);
+                        if (effect_data.status != BEFORE_GOAL_ZONE) {
+                            assert(effect_data.status == REACHED);
+                            effect_data.status = BEFORE_GOAL_ZONE;
                             second_exploration_queue.push_back(effect);
                         }
                     }
@@ -257,12 +307,14 @@ void LandmarkCutHeuristic::mark_goal_plateau(RelaxedProposition *subgoal) {
     // a zero-cost action that is relaxed unreachable. (This can only
     // happen in domains which have zero-cost actions to start with.)
     // For example, this happens in pegsol-strips #01.
-    if (subgoal && subgoal->status != GOAL_ZONE) {
-        subgoal->status = GOAL_ZONE;
-        const vector<RelaxedOperator *> &effect_of = subgoal->effect_of;
-        for (int i = 0; i < effect_of.size(); i++)
-            if (effect_of[i]->cost == 0)
-                mark_goal_plateau(effect_of[i]->h_max_supporter);
+    if (subgoal && get_data(subgoal).status != GOAL_ZONE) {
+        get_data(subgoal).status = GOAL_ZONE;
+        const RelaxedOperatorList &effect_of = subgoal->effect_of;
+        for (int i = 0; i < effect_of.size(); i++) {
+            const RelaxedOperatorData &op_data = get_data(effect_of[i]);
+            if (op_data.cost == 0)
+                mark_goal_plateau(op_data.h_max_supporter);
+        }
     }
 }
 
@@ -271,26 +323,30 @@ void LandmarkCutHeuristic::validate_h_max() const {
     // Using conditional compilation to avoid complaints about unused
     // variables when using NDEBUG. This whole code does nothing useful
     // when assertions are switched off anyway.
-    for (int i = 0; i < relaxed_operators.size(); i++) {
-        const RelaxedOperator *op = &relaxed_operators[i];
-        const vector<RelaxedProposition *> &prec = op->precondition;
-        if (op->unsatisfied_preconditions) {
+    for (int i = 0; i < task->relaxed_operators.size(); i++) {
+        const RelaxedOperator *op = &task->relaxed_operators[i];
+        const RelaxedOperatorData &op_data = operator_data[op->id];
+        const RelaxedPropositionList &prec = op->precondition;
+        if (op_data.unsatisfied_preconditions) {
             bool reachable = true;
             for (int j = 0; j < prec.size(); j++) {
-                if (prec[j]->status == UNREACHED) {
+                if (proposition_data[prec[j]->id].status == UNREACHED) {
                     reachable = false;
                     break;
                 }
             }
             assert(!reachable);
-            assert(!op->h_max_supporter);
+            assert(!op_data.h_max_supporter);
         } else {
-            assert(op->h_max_supporter);
-            int h_max_cost = op->h_max_supporter_cost;
-            assert(h_max_cost == op->h_max_supporter->h_max_cost);
+            assert(op_data.h_max_supporter);
+            int h_max_cost = op_data.h_max_supporter_cost;
+            assert(h_max_cost ==
+                   proposition_data[op_data.h_max_supporter->id].h_max_cost);
             for (int j = 0; j < prec.size(); j++) {
-                assert(prec[j]->status != UNREACHED);
-                assert(prec[j]->h_max_cost <= h_max_cost);
+                const RelaxedPropositionData &prec_data =
+                    proposition_data[prec[j]->id];
+                assert(prec_data.status != UNREACHED);
+                assert(prec_data.h_max_cost <= h_max_cost);
             }
         }
     }
@@ -300,10 +356,9 @@ void LandmarkCutHeuristic::validate_h_max() const {
 
 void LandmarkCutHeuristic::reset_operator_costs(const State &/*state*/) {
     // TODO: Possibly put back in some kind of preferred operator mechanism.
-    for (int i = 0; i < relaxed_operators.size(); i++) {
-        RelaxedOperator &op = relaxed_operators[i];
-        op.cost = op.base_cost * COST_MULTIPLIER;
-    }
+    const vector<RelaxedOperator> &relaxed_operators = task->relaxed_operators;
+    for (int i = 0; i < relaxed_operators.size(); i++)
+        operator_data[i].cost = relaxed_operators[i].base_cost * COST_MULTIPLIER;
 }
 
 int LandmarkCutHeuristic::compute_heuristic(const State &state) {
@@ -320,21 +375,22 @@ int LandmarkCutHeuristic::compute_heuristic(const State &state) {
     vector<RelaxedProposition *> second_exploration_queue;
     first_exploration(state);
     // validate_h_max();  // too expensive to use even in regular debug mode
-    if (artificial_goal.status == UNREACHED)
+    const RelaxedPropositionData &goal_data = get_data(&task->artificial_goal);
+    if (goal_data.status == UNREACHED)
         return DEAD_END;
 
     int num_iterations = 0;
-    while (artificial_goal.h_max_cost != 0) {
+    while (goal_data.h_max_cost != 0) {
         num_iterations++;
-        //cout << "h_max = " << artificial_goal.h_max_cost << "..." << endl;
+        //cout << "h_max = " << goal_data.h_max_cost << "..." << endl;
         //cout << "total_cost = " << total_cost << "..." << endl;
-        mark_goal_plateau(&artificial_goal);
+        mark_goal_plateau(&task->artificial_goal);
         assert(cut.empty());
         second_exploration(state, second_exploration_queue, cut);
         assert(!cut.empty());
         int cut_cost = numeric_limits<int>::max();
         for (int i = 0; i < cut.size(); i++) {
-            cut_cost = min(cut_cost, cut[i]->cost);
+            cut_cost = min(cut_cost, get_data(cut[i]).cost);
             if (COST_MULTIPLIER > 1) {
                 /* We're using this "if" here because COST_MULTIPLIER
                    is currently a global constant and usually 1, which
@@ -361,7 +417,7 @@ int LandmarkCutHeuristic::compute_heuristic(const State &state) {
             }
         }
         for (int i = 0; i < cut.size(); i++)
-            cut[i]->cost -= cut_cost;
+            get_data(cut[i]).cost -= cut_cost;
         //cout << "{" << cut_cost << "}" << flush;
         total_cost += cut_cost;
         discovered_landmark(state, cut, cut_cost);
@@ -377,15 +433,11 @@ int LandmarkCutHeuristic::compute_heuristic(const State &state) {
         //       a round-dependent counter for GOAL_ZONE and BEFORE_GOAL_ZONE,
         //       or something based on total_cost, in which case we don't
         //       need a per-round reinitialization.
-        for (int var = 0; var < propositions.size(); var++) {
-            for (int value = 0; value < propositions[var].size(); value++) {
-                RelaxedProposition &prop = propositions[var][value];
-                if (prop.status == GOAL_ZONE || prop.status == BEFORE_GOAL_ZONE)
-                    prop.status = REACHED;
-            }
+        for (int i = 0; i < proposition_data.size(); i++) {
+            RelaxedPropositionData &prop_data = proposition_data[i];
+            if (prop_data.status == GOAL_ZONE || prop_data.status == BEFORE_GOAL_ZONE)
+                prop_data.status = REACHED;
         }
-        artificial_goal.status = REACHED;
-        artificial_precondition.status = REACHED;
     }
     //cout << "[" << total_cost << "]" << flush;
     //cout << "**************************" << endl;
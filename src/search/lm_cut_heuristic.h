@@ -1,11 +1,13 @@
 #ifndef LM_CUT_HEURISTIC_H
 #define LM_CUT_HEURISTIC_H
 
+#include "arena_allocator.h"
 #include "heuristic.h"
 #include "priority_queue.h"
 
 #include <algorithm>
 #include <cassert>
+#include <tr1/memory>
 #include <vector>
 
 // TODO: Fix duplication with the other relaxation heuristics.
@@ -16,6 +18,12 @@ class State;
 class RelaxedProposition;
 class RelaxedOperator;
 
+// The lists of the relaxed task are stored in the arena of the heuristic.
+typedef std::vector<RelaxedProposition *,
+                    ArenaAllocator<RelaxedProposition *> > RelaxedPropositionList;
+typedef std::vector<RelaxedOperator *,
+                    ArenaAllocator<RelaxedOperator *> > RelaxedOperatorList;
+
 class Options;
 /* TODO: Check the impact of using unary relaxed operators instead of
    multi-effect ones.
@@ -59,27 +67,40 @@ const int COST_MULTIPLIER = 1;
 
 struct RelaxedOperator {
     const Operator *op;
-    std::vector<RelaxedProposition *> precondition;
-    std::vector<RelaxedProposition *> effects;
+    int id; // index in the relaxed operators
+    RelaxedPropositionList precondition;
+    RelaxedPropositionList effects;
     int base_cost; // 0 for axioms, 1 for regular operators
 
+    // The lists are filled after the operator has been stored.
+    RelaxedOperator(const Operator *the_op, int id_, int base, Arena &arena)
+        : op(the_op), id(id_),
+          precondition(ArenaAllocator<RelaxedProposition *>(&arena)),
+          effects(ArenaAllocator<RelaxedProposition *>(&arena)),
+          base_cost(base) {
+    }
+};
+
+struct RelaxedProposition {
+    int id; // 0 and 1 for the artificial precondition and goal
+    // Filled on the heap and then copied to the arena (see initialize).
+    RelaxedOperatorList precondition_of;
+    RelaxedOperatorList effect_of;
+
+    explicit RelaxedProposition(int id_) : id(id_) {
+    }
+};
+
+// The data of the explorations for a relaxed operator.
+struct RelaxedOperatorData {
     int cost;
     int unsatisfied_preconditions;
     int h_max_supporter_cost; // h_max_cost of h_max_supporter
     RelaxedProposition *h_max_supporter;
-    RelaxedOperator(const std::vector<RelaxedProposition *> &pre,
-                    const std::vector<RelaxedProposition *> &eff,
-                    const Operator *the_op, int base)
-        : op(the_op), precondition(pre), effects(eff), base_cost(base) {
-    }
-
-    inline void update_h_max_supporter();
 };
 
-struct RelaxedProposition {
-    std::vector<RelaxedOperator *> precondition_of;
-    std::vector<RelaxedOperator *> effect_of;
-
+// The data of the explorations for a relaxed proposition.
+struct RelaxedPropositionData {
     PropositionStatus status;
     int h_max_cost;
     /* TODO: Also add the rpg depth? The Python implementation used
@@ -99,14 +120,34 @@ struct RelaxedProposition {
        depths). See if the init h values degrade compared to Python
        without explicit depth tie-breaking, then decide.
     */
-
-    RelaxedProposition() {
-    }
 };
 
 class LandmarkCutHeuristic : public Heuristic {
+    /*
+      The relaxed task, which is built by initialize and only read
+      afterwards, so that it is shared by the heuristic and its thread
+      clones. The arena holds the precondition and effect lists of the
+      relaxed operators and the operator lists of the propositions.
+    */
+    struct RelaxedTask {
+        Arena arena;
+        std::vector<RelaxedOperator> relaxed_operators;
+        std::vector<std::vector<RelaxedProposition> > propositions;
+        RelaxedProposition artificial_precondition;
+        RelaxedProposition artificial_goal;
+        int num_propositions;
+        RelaxedTask();
+    };
+    std::tr1::shared_ptr<RelaxedTask> task;
     AdaptiveQueue<RelaxedProposition *> priority_queue;
 
+    RelaxedPropositionData &get_data(const RelaxedProposition *prop) {
+        return proposition_data[prop->id];
+    }
+    RelaxedOperatorData &get_data(const RelaxedOperator *op) {
+        return operator_data[op->id];
+    }
+
     void build_relaxed_operator(const Operator &op);
     void add_relaxed_operator(const std::vector<RelaxedProposition *> &precondition,
                               const std::vector<RelaxedProposition *> &effects,
@@ -120,37 +161,50 @@ class LandmarkCutHeuristic : public Heuristic {
 
     void enqueue_if_necessary(RelaxedProposition *prop, int cost) {
         assert(cost >= 0);
-        if (prop->status == UNREACHED || prop->h_max_cost > cost) {
-            prop->status = REACHED;
-            prop->h_max_cost = cost;
+        RelaxedPropositionData &data = get_data(prop);
+        if (data.status == UNREACHED || data.h_max_cost > cost) {
+            data.status = REACHED;
+            data.h_max_cost = cost;
             priority_queue.push(cost, prop);
         }
     }
 
+    inline void update_h_max_supporter(const RelaxedOperator *op);
     void mark_goal_plateau(RelaxedProposition *subgoal);
     void validate_h_max() const;
 protected:
-    std::vector<RelaxedOperator> relaxed_operators;
-    std::vector<std::vector<RelaxedProposition> > propositions;
-    RelaxedProposition artificial_precondition;
-    RelaxedProposition artificial_goal;
-    int num_propositions;
+    // Indexed by the ids of the relaxed operators and propositions. Each
+    // thread clone has its own copy.
+    std::vector<RelaxedOperatorData> operator_data;
+    std::vector<RelaxedPropositionData> proposition_data;
+
     virtual void initialize();
     virtual void discovered_landmark(const State & /*state*/, std::vector<RelaxedOperator *> & /*landmark*/, int /*cost*/) {
     }
     virtual void reset_operator_costs(const State &state);
     virtual int compute_heuristic(const State &state);
+
+    virtual Heuristic *create_thread_clone();
+    // Used for clones, which share the relaxed task with the original.
+    LandmarkCutHeuristic(const LandmarkCutHeuristic &other);
 public:
     LandmarkCutHeuristic(const Options &opts);
     virtual ~LandmarkCutHeuristic();
 };
 
-inline void RelaxedOperator::update_h_max_supporter() {
-    assert(!unsatisfied_preconditions);
-    for (int i = 0; i < precondition.size(); i++)
-        if (precondition[i]->h_max_cost > h_max_supporter->h_max_cost)
-            h_max_supporter = precondition[i];
-    h_max_supporter_cost = h_max_supporter->h_max_cost;
+inline void LandmarkCutHeuristic::update_h_max_supporter(
+    const RelaxedOperator *op) {
+    RelaxedOperatorData &op_data = get_data(op);
+    assert(!op_data.unsatisfied_preconditions);
+    int h_max_supporter_cost = get_data(op_data.h_max_supporter).h_max_cost;
+    for (int i = 0; i < op->precondition.size(); i++) {
+        int h_max_cost = get_data(op->precondition[i]).h_max_cost;
+        if (h_max_cost > h_max_supporter_cost) {
+            op_data.h_max_supporter = op->precondition[i];
+            h_max_supporter_cost = h_max_cost;
+        }
+    }
+    op_data.h_max_supporter_cost = h_max_supporter_cost;
 }
 
 #endif
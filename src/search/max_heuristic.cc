@@ -5,6 +5,7 @@
 #include "plugin.h"
 #include "state.h"
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 using namespace std;
@@ -29,9 +30,17 @@ HSPMaxHeuristic::HSPMaxHeuristic(const Options &opts)
     : RelaxationHeuristic(opts) {
 }
 
+HSPMaxHeuristic::HSPMaxHeuristic(const HSPMaxHeuristic &other)
+    : RelaxationHeuristic(other) {
+}
+
 HSPMaxHeuristic::~HSPMaxHeuristic() {
 }
 
+Heuristic *HSPMaxHeuristic::create_thread_clone() {
+    return new HSPMaxHeuristic(*this);
+}
+
 // initialization
 void HSPMaxHeuristic::initialize() {
     cout << "Initializing HSP max heuristic..." << endl;
@@ -42,53 +51,42 @@ void HSPMaxHeuristic::initialize() {
 void HSPMaxHeuristic::setup_exploration_queue() {
     queue.clear();
 
-    for (int var = 0; var < propositions.size(); var++) {
-        for (int value = 0; value < propositions[var].size(); value++) {
-            Proposition &prop = propositions[var][value];
-            prop.cost = -1;
-        }
-    }
+    // Operator costs will be increased by precondition costs.
+    reset_exploration();
 
     // Deal with operators and axioms without preconditions.
-    for (int i = 0; i < unary_operators.size(); i++) {
-        UnaryOperator &op = unary_operators[i];
-        op.unsatisfied_preconditions = op.precondition.size();
-        op.cost = op.base_cost; // will be increased by precondition costs
-
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost);
+    for (int i = 0; i < task->operators_without_preconditions.size(); i++) {
+        int op = task->operators_without_preconditions[i];
+        enqueue_if_necessary(task->effect[op], task->base_cost[op]);
     }
 }
 
 void HSPMaxHeuristic::setup_exploration_queue_state(const State &state) {
-    for (int var = 0; var < propositions.size(); var++) {
-        Proposition *init_prop = &propositions[var][state[var]];
-        enqueue_if_necessary(init_prop, 0);
-    }
+    for (int var = 0; var < task->proposition_offsets.size(); var++)
+        enqueue_if_necessary(get_proposition(var, state[var]), 0);
 }
 
 void HSPMaxHeuristic::relaxed_exploration() {
-    int unsolved_goals = goal_propositions.size();
+    int unsolved_goals = task->goal_propositions.size();
     while (!queue.empty()) {
-        pair<int, Proposition *> top_pair = queue.pop();
+        pair<int, int> top_pair = queue.pop();
         int distance = top_pair.first;
-        Proposition *prop = top_pair.second;
-        int prop_cost = prop->cost;
+        int prop = top_pair.second;
+        int prop_cost = proposition_cost[prop];
         assert(prop_cost <= distance);
         if (prop_cost < distance)
             continue;
-        if (prop->is_goal && --unsolved_goals == 0)
+        if (task->is_goal[prop] && --unsolved_goals == 0)
             return;
-        const vector<UnaryOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (int i = 0; i < triggered_operators.size(); i++) {
-            UnaryOperator *unary_op = triggered_operators[i];
-            unary_op->unsatisfied_preconditions--;
-            unary_op->cost = max(unary_op->cost,
-                                 unary_op->base_cost + prop_cost);
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect, unary_op->cost);
+        int end = task->precondition_of_start[prop + 1];
+        for (int i = task->precondition_of_start[prop]; i < end; i++) {
+            int op = task->precondition_of[i];
+            int &unsatisfied = unsatisfied_preconditions[op];
+            unsatisfied--;
+            operator_cost[op] = max(operator_cost[op], task->base_cost[op] + prop_cost);
+            assert(unsatisfied >= 0);
+            if (unsatisfied == 0)
+                enqueue_if_necessary(task->effect[op], operator_cost[op]);
         }
     }
 }
@@ -99,8 +97,8 @@ int HSPMaxHeuristic::compute_heuristic(const State &state) {
     relaxed_exploration();
 
     int total_cost = 0;
-    for (int i = 0; i < goal_propositions.size(); i++) {
-        int prop_cost = goal_propositions[i]->cost;
+    for (int i = 0; i < task->goal_propositions.size(); i++) {
+        int prop_cost = proposition_cost[task->goal_propositions[i]];
         if (prop_cost == -1)
             return DEAD_END;
         total_cost = max(total_cost, prop_cost);
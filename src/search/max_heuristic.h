@@ -6,23 +6,28 @@
 #include <cassert>
 
 class HSPMaxHeuristic : public RelaxationHeuristic {
-    AdaptiveQueue<Proposition *> queue;
+    AdaptiveQueue<int> queue;
 
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void relaxed_exploration();
 
-    void enqueue_if_necessary(Proposition *prop, int cost) {
+    void enqueue_if_necessary(int prop, int cost) {
         assert(cost >= 0);
-        if (prop->cost == -1 || prop->cost > cost) {
-            prop->cost = cost;
+        int &prop_cost = proposition_cost[prop];
+        if (prop_cost == -1 || prop_cost > cost) {
+            prop_cost = cost;
             queue.push(cost, prop);
         }
-        assert(prop->cost != -1 && prop->cost <= cost);
+        assert(prop_cost != -1 && prop_cost <= cost);
     }
 protected:
     virtual void initialize();
     virtual int compute_heuristic(const State &state);
+
+    virtual Heuristic *create_thread_clone();
+    // Used for clones; the queue is only used during evaluation.
+    HSPMaxHeuristic(const HSPMaxHeuristic &other);
 public:
     HSPMaxHeuristic(const Options &options);
     ~HSPMaxHeuristic();
@@ -191,6 +191,11 @@ int MergeAndShrinkHeuristic::compute_heuristic(const State &state) {
     return cost;
 }
 
+Heuristic *MergeAndShrinkHeuristic::create_thread_clone() {
+    // Share the abstraction, computing heuristic values only reads it.
+    return create_sharing_clone();
+}
+
 static Heuristic *_parse(OptionParser &parser) {
     parser.document_synopsis(
         "Merge-and-shrink heuristic",
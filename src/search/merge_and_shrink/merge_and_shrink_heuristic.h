@@ -31,6 +31,7 @@ class MergeAndShrinkHeuristic : public Heuristic {
 protected:
     virtual void initialize();
     virtual int compute_heuristic(const State &state);
+    virtual Heuristic *create_thread_clone();
 public:
     MergeAndShrinkHeuristic(const Options &opts);
     ~MergeAndShrinkHeuristic();
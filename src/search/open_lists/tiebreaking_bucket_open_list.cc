@@ -0,0 +1,145 @@
+// HACK! Ignore this if used as a top-level compile target.
+#ifdef OPEN_LISTS_TIEBREAKING_BUCKET_OPEN_LIST_H
+
+#include <cassert>
+#include <limits>
+#include "../scalar_evaluator.h"
+#include "../option_parser.h"
+using namespace std;
+
+template<class Entry>
+OpenList<Entry> *TieBreakingBucketOpenList<Entry>::_parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Bucket-based tie-breaking open list",
+        "Open list that orders entries by the value of the first evaluator "
+        "and breaks ties by the value of the optional second evaluator, "
+        "like the tie-breaking open list. Entries are stored in buckets "
+        "indexed by these values, which makes inserting and removing "
+        "entries cheap if the values are small non-negative integers. "
+        "States that any evaluator regards as dead ends are not inserted.");
+    parser.add_list_option<ScalarEvaluator *>(
+        "evals", "one or two scalar evaluators");
+    parser.add_option<bool>(
+        "pref_only",
+        "insert only nodes generated by preferred operators", "false");
+    Options opts = parser.parse();
+    vector<ScalarEvaluator *> evals = opts.get_list<ScalarEvaluator *>("evals");
+    if (evals.empty() || evals.size() > 2)
+        parser.error("expected one or two evaluators");
+    if (parser.dry_run())
+        return 0;
+    else
+        return new TieBreakingBucketOpenList<Entry>(opts);
+}
+
+template<class Entry>
+TieBreakingBucketOpenList<Entry>::TieBreakingBucketOpenList(const Options &opts)
+    : OpenList<Entry>(opts.get<bool>("pref_only")),
+      lowest_primary(numeric_limits<int>::max()),
+      size(0), evaluators(opts.get_list<ScalarEvaluator *>("evals")) {
+}
+
+template<class Entry>
+TieBreakingBucketOpenList<Entry>::~TieBreakingBucketOpenList() {
+}
+
+template<class Entry>
+int TieBreakingBucketOpenList<Entry>::insert(const Entry &entry) {
+    if (OpenList<Entry>::only_preferred && !last_preferred)
+        return 0;
+    if (dead_end)
+        return 0;
+    int primary = last_primary_value;
+    int secondary = last_secondary_value;
+    assert(primary >= 0 && secondary >= 0);
+    if (primary >= buckets.size()) {
+        buckets.resize(primary + 1);
+        primary_sizes.resize(primary + 1, 0);
+        lowest_secondary.resize(primary + 1, numeric_limits<int>::max());
+    }
+    vector<Bucket> &secondary_buckets = buckets[primary];
+    if (secondary >= secondary_buckets.size())
+        secondary_buckets.resize(secondary + 1);
+    secondary_buckets[secondary].push_back(entry);
+    if (primary < lowest_primary)
+        lowest_primary = primary;
+    if (secondary < lowest_secondary[primary])
+        lowest_secondary[primary] = secondary;
+    ++primary_sizes[primary];
+    ++size;
+    return 1;
+}
+
+template<class Entry>
+Entry TieBreakingBucketOpenList<Entry>::remove_min(vector<int> *key) {
+    assert(size > 0);
+    while (primary_sizes[lowest_primary] == 0)
+        ++lowest_primary;
+    vector<Bucket> &secondary_buckets = buckets[lowest_primary];
+    int &secondary = lowest_secondary[lowest_primary];
+    while (secondary_buckets[secondary].empty())
+        ++secondary;
+    if (key) {
+        assert(key->empty());
+        key->push_back(lowest_primary);
+        if (evaluators.size() == 2)
+            key->push_back(secondary);
+    }
+    Bucket &bucket = secondary_buckets[secondary];
+    Entry result = bucket.front();
+    bucket.pop_front();
+    --primary_sizes[lowest_primary];
+    --size;
+    return result;
+}
+
+template<class Entry>
+bool TieBreakingBucketOpenList<Entry>::empty() const {
+    return size == 0;
+}
+
+template<class Entry>
+void TieBreakingBucketOpenList<Entry>::clear() {
+    buckets.clear();
+    primary_sizes.clear();
+    lowest_secondary.clear();
+    lowest_primary = numeric_limits<int>::max();
+    size = 0;
+}
+
+template<class Entry>
+void TieBreakingBucketOpenList<Entry>::evaluate(int g, bool preferred) {
+    dead_end = false;
+    dead_end_reliable = false;
+    last_secondary_value = 0;
+    for (int i = 0; i < evaluators.size(); ++i) {
+        evaluators[i]->evaluate(g, preferred);
+        if (evaluators[i]->is_dead_end()) {
+            dead_end = true;
+            if (evaluators[i]->dead_end_is_reliable())
+                dead_end_reliable = true;
+        } else if (i == 0) {
+            last_primary_value = evaluators[i]->get_value();
+        } else {
+            last_secondary_value = evaluators[i]->get_value();
+        }
+    }
+    last_preferred = preferred;
+}
+
+template<class Entry>
+bool TieBreakingBucketOpenList<Entry>::is_dead_end() const {
+    return dead_end;
+}
+
+template<class Entry>
+bool TieBreakingBucketOpenList<Entry>::dead_end_is_reliable() const {
+    return dead_end_reliable;
+}
+
+template<class Entry>
+void TieBreakingBucketOpenList<Entry>::get_involved_heuristics(std::set<Heuristic *> &hset) {
+    for (int i = 0; i < evaluators.size(); ++i)
+        evaluators[i]->get_involved_heuristics(hset);
+}
+#endif
@@ -0,0 +1,74 @@
+#ifndef OPEN_LISTS_TIEBREAKING_BUCKET_OPEN_LIST_H
+#define OPEN_LISTS_TIEBREAKING_BUCKET_OPEN_LIST_H
+
+#include "open_list.h"
+#include "../evaluator.h"
+
+#include <deque>
+#include <vector>
+
+class ScalarEvaluator;
+class Options;
+class OptionParser;
+
+/*
+  Bucket-based variant of TieBreakingOpenList for one or two evaluators
+  with small non-negative integer values, such as f and h values.
+  Entries with primary value k and secondary value l are stored in the
+  FIFO bucket buckets[k][l], so insert and remove_min take amortized
+  constant time instead of a lookup in a map with vector keys.
+
+  For each primary value, the lowest secondary value that may have a
+  non-empty bucket is cached, and so is the lowest primary value with a
+  non-empty bucket. Like in BucketOpenList, these only move up in
+  remove_min, which is efficient as long as the values of inserted
+  entries rarely drop far below the values of removed ones. This holds
+  for A* with consistent heuristics.
+
+  Unlike TieBreakingOpenList, entries are not inserted if any evaluator
+  reports a dead end (like in BucketOpenList).
+*/
+template<class Entry>
+class TieBreakingBucketOpenList : public OpenList<Entry> {
+    typedef std::deque<Entry> Bucket;
+
+    std::vector<std::vector<Bucket> > buckets;
+    // Number of entries with the given primary value.
+    std::vector<int> primary_sizes;
+    std::vector<int> lowest_secondary;
+    int lowest_primary;
+    int size;
+
+    std::vector<ScalarEvaluator *> evaluators;
+    int last_primary_value;
+    int last_secondary_value;
+    bool last_preferred;
+    bool dead_end;
+    bool dead_end_reliable;
+protected:
+    Evaluator *get_evaluator() {return this; }
+
+public:
+    TieBreakingBucketOpenList(const Options &opts);
+    ~TieBreakingBucketOpenList();
+
+    // open list interface
+    int insert(const Entry &entry);
+    Entry remove_min(std::vector<int> *key = 0);
+    bool empty() const;
+    void clear();
+
+    // tuple evaluator interface
+    void evaluate(int g, bool preferred);
+    bool is_dead_end() const;
+    bool dead_end_is_reliable() const;
+    void get_involved_heuristics(std::set<Heuristic *> &hset);
+
+    static OpenList<Entry> *_parse(OptionParser &parser);
+};
+
+#include "tiebreaking_bucket_open_list.cc"
+
+// HACK! Need a better strategy of dealing with templates, also in the Makefile.
+
+#endif
@@ -1,14 +1,16 @@
 #include "globals.h"
 #include "operator.h"
+#include "task_reader.h"
 
 #include <iostream>
+#include <map>
 using namespace std;
 
-Prevail::Prevail(istream &in) {
+Prevail::Prevail(TaskReader &in) {
     in >> var >> prev;
 }
 
-PrePost::PrePost(istream &in) {
+PrePost::PrePost(TaskReader &in) {
     int condCount;
     in >> condCount;
     for (int i = 0; i < condCount; i++)
@@ -16,14 +18,13 @@ PrePost::PrePost(istream &in) {
     in >> var >> pre >> post;
 }
 
-Operator::Operator(istream &in, bool axiom) {
+Operator::Operator(TaskReader &in, bool axiom) {
     marked = false;
 
     is_an_axiom = axiom;
     if (!is_an_axiom) {
         check_magic(in, "begin_operator");
-        in >> ws;
-        getline(in, name);
+        in.read_line(name);
         int count;
         in >> count;
         for (int i = 0; i < count; i++)
@@ -49,6 +50,38 @@ Operator::Operator(istream &in, bool axiom) {
     }
 
     marker1 = marker2 = false;
+    compile_preconditions();
+}
+
+static void add_packed_condition(
+    int var, int value, map<int, pair<PackedStateBin, PackedStateBin> > &tests) {
+    PackedStateBin mask, bits;
+    int bin = g_state_packer->get_condition(var, value, mask, bits);
+    pair<PackedStateBin, PackedStateBin> &test = tests[bin];
+    // A variable may only be tested for one value.
+    assert((test.first & mask) == 0 || (test.second & mask) == bits);
+    test.first |= mask;
+    test.second |= bits;
+}
+
+void Operator::compile_preconditions() {
+    // Maps bins to the combined mask and bits of their conditions.
+    map<int, pair<PackedStateBin, PackedStateBin> > tests;
+    for (int i = 0; i < prevail.size(); i++)
+        add_packed_condition(prevail[i].var, prevail[i].prev, tests);
+    for (int i = 0; i < pre_post.size(); i++)
+        if (pre_post[i].pre != -1)
+            add_packed_condition(pre_post[i].var, pre_post[i].pre, tests);
+
+    packed_preconditions.clear();
+    map<int, pair<PackedStateBin, PackedStateBin> >::const_iterator it;
+    for (it = tests.begin(); it != tests.end(); ++it) {
+        PackedCondition condition;
+        condition.bin = it->first;
+        condition.mask = it->second.first;
+        condition.bits = it->second.second;
+        packed_preconditions.push_back(condition);
+    }
 }
 
 void rename_fact_in_conditions(int variable, int before, int after, vector<Prevail> &conditions) {
@@ -77,6 +110,7 @@ void Operator::rename_fact(int variable, int before, int after) {
         }
         rename_fact_in_conditions(variable, before, after, prepost.cond);
     }
+    compile_preconditions();
 }
 
 void Prevail::dump() const {
@@ -104,6 +138,7 @@ void Operator::keep_single_effect(int var, int value) {
             it = pre_post.erase(it);
         }
     }
+    compile_preconditions();
 }
 
 void Operator::dump() const {
@@ -12,7 +12,7 @@
 struct Prevail {
     int var;
     int prev;
-    Prevail(std::istream &in);
+    Prevail(TaskReader &in);
     Prevail(int v, int p) : var(v), prev(p) {}
 
     bool is_applicable(const State &state) const {
@@ -37,7 +37,7 @@ struct PrePost {
     int pre, post;
     std::vector<Prevail> cond;
     PrePost() {} // Needed for axiom file-reading constructor, unfortunately.
-    PrePost(std::istream &in);
+    PrePost(TaskReader &in);
     PrePost(int v, int pr, int po, const std::vector<Prevail> &co)
         : var(v), pre(pr), post(po), cond(co) {}
 
@@ -58,15 +58,31 @@ struct PrePost {
 };
 
 class Operator {
+    /*
+      The preconditions are also compiled into one test per bin of the
+      packed state data (see IntPacker::get_condition), so that
+      is_applicable tests all preconditions on variables in the same bin
+      with one mask operation instead of unpacking each variable.
+    */
+    struct PackedCondition {
+        int bin;
+        PackedStateBin mask;
+        PackedStateBin bits;
+    };
+
     bool is_an_axiom;
     std::vector<Prevail> prevail;      // var, val
     std::vector<PrePost> pre_post;     // var, old-val, new-val, effect conditions
+    std::vector<PackedCondition> packed_preconditions;
     std::string name;
     int cost;
 
     mutable bool marked; // Used for short-term marking of preferred operators
+
+    // Must be called whenever prevail or pre_post change.
+    void compile_preconditions();
 public:
-    Operator(std::istream &in, bool is_axiom);
+    Operator(TaskReader &in, bool is_axiom);
     void dump() const;
     std::string get_name() const {return name; }
 
@@ -76,12 +92,12 @@ public:
     const std::vector<PrePost> &get_pre_post() const {return pre_post; }
 
     bool is_applicable(const State &state) const {
-        for (int i = 0; i < prevail.size(); i++)
-            if (!prevail[i].is_applicable(state))
-                return false;
-        for (int i = 0; i < pre_post.size(); i++)
-            if (!pre_post[i].is_applicable(state))
+        const PackedStateBin *buffer = state.get_packed_buffer();
+        for (int i = 0; i < packed_preconditions.size(); i++) {
+            const PackedCondition &condition = packed_preconditions[i];
+            if ((buffer[condition.bin] & condition.mask) != condition.bits)
                 return false;
+        }
         return true;
     }
 
@@ -3,6 +3,7 @@
 #include "ext/tree_util.hh"
 #include "plugin.h"
 #include "rng.h"
+#include "state_registry.h"
 #include <algorithm>
 #include <iostream>
 #include <string>
@@ -216,6 +217,8 @@ SearchEngine *OptionParser::parse_cmd_line(
         } else if (arg.compare("--plan-file") == 0) {
             ++i;
             g_plan_filename = argv[i];
+        } else if (arg.compare("--incremental-state-hashing") == 0) {
+            g_state_registry->enable_incremental_hashing();
         } else {
             cerr << "unknown option " << arg << endl << endl;
             cout << OptionParser::usage(argv[0]) << endl;
@@ -245,6 +248,13 @@ string OptionParser::usage(string progname) {
         "    Use random seed SEED\n\n"
         "--plan-file FILENAME\n"
         "    Plan will be output to a file called FILENAME\n\n"
+        "--incremental-state-hashing\n"
+        "    Compute the hash value of a successor state from the hash value\n"
+        "    of its predecessor (Zobrist hashing). Must precede --search.\n\n"
+        "--portfolio PORTFOLIO_FILE [--plan-file FILENAME] [--jobs N]\n"
+        "    Runs the portfolio of configurations in PORTFOLIO_FILE (written\n"
+        "    by portfolio.py) instead of a single search, with up to N\n"
+        "    configurations at the same time.\n\n"
         "See http://www.fast-downward.org/ for details.";
     return usage;
 }
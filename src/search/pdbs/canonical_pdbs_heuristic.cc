@@ -1,5 +1,6 @@
 #include "canonical_pdbs_heuristic.h"
 
+#include "distance_table.h"
 #include "dominance_pruner.h"
 #include "max_cliques.h"
 #include "pdb_heuristic.h"
@@ -13,23 +14,37 @@
 #include "../timer.h"
 #include "../utilities.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <limits>
 #include <vector>
 
 using namespace std;
 
+// Collections with at most this many PDBs are evaluated without allocating memory.
+static const int MAX_PDBS_FOR_STACK_BUFFER = 256;
+
 CanonicalPDBsHeuristic::CanonicalPDBsHeuristic(const Options &opts)
-    : Heuristic(opts) {
+    : Heuristic(opts),
+      construction_threads(opts.get<int>("construction_threads")),
+      compress_distances(opts.get<bool>("compress_distances")),
+      cache_dir(opts.get<string>("cache_dir")) {
     const vector<vector<int> > &pattern_collection(opts.get_list<vector<int> >("patterns"));
     Timer timer;
     size = 0;
     pattern_databases.reserve(pattern_collection.size());
-    for (size_t i = 0; i < pattern_collection.size(); ++i)
-        _add_pattern(pattern_collection[i]);
+    PDBHeuristic::build_pdbs(pattern_collection, cost_type, construction_threads,
+                             compress_distances, cache_dir, pattern_databases);
+    size_t distances_memory = 0;
+    for (size_t i = 0; i < pattern_databases.size(); ++i) {
+        size += pattern_databases[i]->get_size();
+        distances_memory += pattern_databases[i]->get_distances_memory();
+    }
     compute_additive_vars();
     compute_max_cliques();
     cout << "PDB collection construction time: " << timer << endl;
+    cout << "PDB collection distances: " << distances_memory / 1024 << " KB" << endl;
 }
 
 CanonicalPDBsHeuristic::~CanonicalPDBsHeuristic() {
@@ -39,10 +54,9 @@ CanonicalPDBsHeuristic::~CanonicalPDBsHeuristic() {
 }
 
 void CanonicalPDBsHeuristic::_add_pattern(const vector<int> &pattern) {
-    Options opts;
-    opts.set<int>("cost_type", cost_type);
-    opts.set<vector<int> >("pattern", pattern);
-    pattern_databases.push_back(new PDBHeuristic(opts, false));
+    PDBHeuristic::build_pdbs(vector<vector<int> >(1, pattern), cost_type,
+                             construction_threads, compress_distances,
+                             cache_dir, pattern_databases);
     size += pattern_databases.back()->get_size();
 }
 
@@ -87,6 +101,37 @@ void CanonicalPDBsHeuristic::compute_max_cliques() {
         }
         max_cliques.push_back(clique);
     }
+    build_evaluation_plan();
+}
+
+void CanonicalPDBsHeuristic::build_evaluation_plan() {
+    plan_variables.clear();
+    plan_multipliers.clear();
+    plan_pattern_ends.clear();
+    plan_tables.clear();
+    plan_clique_members.clear();
+    plan_clique_ends.clear();
+
+    for (size_t i = 0; i < pattern_databases.size(); ++i) {
+        const PDBHeuristic *pdb = pattern_databases[i];
+        const vector<int> &pattern = pdb->get_pattern();
+        const vector<size_t> &multipliers = pdb->get_hash_multipliers();
+        plan_variables.insert(plan_variables.end(), pattern.begin(), pattern.end());
+        plan_multipliers.insert(plan_multipliers.end(), multipliers.begin(), multipliers.end());
+        plan_pattern_ends.push_back(plan_variables.size());
+        plan_tables.push_back(&pdb->get_distance_table());
+    }
+
+    for (size_t i = 0; i < max_cliques.size(); ++i) {
+        const vector<PDBHeuristic *> &clique = max_cliques[i];
+        for (size_t j = 0; j < clique.size(); ++j) {
+            int pdb_index = find(pattern_databases.begin(), pattern_databases.end(),
+                                 clique[j]) - pattern_databases.begin();
+            assert(pdb_index < pattern_databases.size());
+            plan_clique_members.push_back(pdb_index);
+        }
+        plan_clique_ends.push_back(plan_clique_members.size());
+    }
 }
 
 void CanonicalPDBsHeuristic::compute_additive_vars() {
@@ -123,32 +168,57 @@ void CanonicalPDBsHeuristic::dominance_pruning() {
     " of " << num_patterns << " PDBs" << endl;
 
     cout << "Dominance pruning took " << timer << endl;
+    build_evaluation_plan();
 }
 
 void CanonicalPDBsHeuristic::initialize() {
 }
 
+bool CanonicalPDBsHeuristic::compute_pdb_values(const State &state, int *h_values) const {
+    // The PDBs are not evaluated as heuristics (which would modify them),
+    // so that clones can share them.
+    size_t var_pos = 0;
+    for (size_t i = 0; i < plan_tables.size(); ++i) {
+        size_t index = 0;
+        for (size_t pattern_end = plan_pattern_ends[i]; var_pos < pattern_end; ++var_pos)
+            index += plan_multipliers[var_pos] * state[plan_variables[var_pos]];
+        int h = (*plan_tables[i])[index];
+        if (h == numeric_limits<int>::max())
+            return false;
+        h_values[i] = h;
+    }
+    return true;
+}
+
 int CanonicalPDBsHeuristic::compute_heuristic(const State &state) {
-    int max_h = 0;
-    assert(!max_cliques.empty());
+    assert(!plan_clique_ends.empty());
     // if we have an empty collection, then max_cliques = { \emptyset }
 
-    for (size_t i = 0; i < pattern_databases.size(); ++i) {
-        pattern_databases[i]->evaluate(state);
-        if (pattern_databases[i]->is_dead_end())
-            return DEAD_END;
+    int stack_buffer[MAX_PDBS_FOR_STACK_BUFFER];
+    vector<int> heap_buffer;
+    int *h_values = stack_buffer;
+    if (plan_tables.size() > MAX_PDBS_FOR_STACK_BUFFER) {
+        heap_buffer.resize(plan_tables.size());
+        h_values = &heap_buffer[0];
     }
-    for (size_t i = 0; i < max_cliques.size(); ++i) {
-        const vector<PDBHeuristic *> &clique = max_cliques[i];
+    if (!compute_pdb_values(state, h_values))
+        return DEAD_END;
+
+    int max_h = 0;
+    size_t member_pos = 0;
+    for (size_t i = 0; i < plan_clique_ends.size(); ++i) {
         int clique_h = 0;
-        for (size_t j = 0; j < clique.size(); ++j) {
-            clique_h += clique[j]->get_heuristic();
-        }
+        for (size_t clique_end = plan_clique_ends[i]; member_pos < clique_end; ++member_pos)
+            clique_h += h_values[plan_clique_members[member_pos]];
         max_h = max(max_h, clique_h);
     }
     return max_h;
 }
 
+Heuristic *CanonicalPDBsHeuristic::create_thread_clone() {
+    return create_sharing_clone();
+}
+
 void CanonicalPDBsHeuristic::add_pattern(const vector<int> &pattern) {
     _add_pattern(pattern);
     compute_max_cliques();
@@ -156,7 +226,7 @@ void CanonicalPDBsHeuristic::add_pattern(const vector<int> &pattern) {
 
 
 void CanonicalPDBsHeuristic::get_max_additive_subsets(
-    const vector<int> &new_pattern, vector<vector<PDBHeuristic *> > &max_additive_subsets) {
+    const vector<int> &new_pattern, vector<vector<PDBHeuristic *> > &max_additive_subsets) const {
     /*
       We compute additive pattern sets S with the property that we could
       add the new pattern P to S and still have an additive pattern set.
@@ -226,8 +296,7 @@ void CanonicalPDBsHeuristic::get_max_additive_subsets(
 void CanonicalPDBsHeuristic::evaluate_dead_end(const State &state) {
     int evaluator_value = 0;
     for (size_t i = 0; i < pattern_databases.size(); ++i) {
-        pattern_databases[i]->evaluate(state);
-        if (pattern_databases[i]->is_dead_end()) {
+        if (pattern_databases[i]->get_abstract_distance(state) == numeric_limits<int>::max()) {
             evaluator_value = DEAD_END;
             break;
         }
@@ -3,15 +3,38 @@
 
 #include "../heuristic.h"
 
+#include <string>
 #include <vector>
 
 // Implements the canonical heuristic function.
+class DistanceTable;
 class PDBHeuristic;
 class CanonicalPDBsHeuristic : public Heuristic {
     int size; // the sum of all abstract state sizes of all pdbs in the collection
     std::vector<std::vector<PDBHeuristic *> > max_cliques; // final computed max_cliques
     std::vector<std::vector<bool> > are_additive; // pair of variables which are additive
     std::vector<PDBHeuristic *> pattern_databases; // final pattern databases
+    int construction_threads; // number of threads used to build new pattern databases
+    bool compress_distances; // whether new pattern databases store their distances compressed
+    std::string cache_dir; // directory of cached pattern databases, or empty
+
+    /* The data that compute_heuristic needs, stored in flat vectors so that evaluating a state does not follow the
+       pointers of pattern_databases and max_cliques: the variables of the patterns of all PDBs one after the other
+       (the pattern of PDB i ends at plan_pattern_ends[i]) with their hash multipliers, the distance tables of the
+       PDBs and the indices of the PDBs of all cliques one after the other (clique i ends at plan_clique_ends[i]).
+       Built by build_evaluation_plan whenever pattern_databases or max_cliques change. */
+    std::vector<int> plan_variables;
+    std::vector<size_t> plan_multipliers;
+    std::vector<int> plan_pattern_ends;
+    std::vector<const DistanceTable *> plan_tables;
+    std::vector<int> plan_clique_members;
+    std::vector<int> plan_clique_ends;
+
+    void build_evaluation_plan();
+
+    /* Stores the h-values of all PDBs for the given state in h_values (with room for one value per PDB). Returns
+       false, and stops early, if the state is a dead end for one of the PDBs. */
+    bool compute_pdb_values(const State &state, int *h_values) const;
 
     /* Returns true iff the two patterns are additive i.e. there is no operator
        which affects variables in pattern one as well as in pattern two. */
@@ -34,6 +57,7 @@ class CanonicalPDBsHeuristic : public Heuristic {
 protected:
     virtual void initialize();
     virtual int compute_heuristic(const State &state);
+    virtual Heuristic *create_thread_clone();
 public:
     CanonicalPDBsHeuristic(const Options &opts);
     virtual ~CanonicalPDBsHeuristic();
@@ -48,7 +72,7 @@ public:
 
     // checks for all max cliques if they would be additive to this pattern
     void get_max_additive_subsets(const std::vector<int> &new_pattern,
-                                  std::vector<std::vector<PDBHeuristic *> > &max_additive_subsets);
+                                  std::vector<std::vector<PDBHeuristic *> > &max_additive_subsets) const;
 
     // to avoid unneccessary overhead in the sampling procedure of iPDB, provide
     // this method to only evaluate the heuristic to check whether a
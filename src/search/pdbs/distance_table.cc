@@ -0,0 +1,91 @@
+#include "distance_table.h"
+
+#include <algorithm>
+#include <sys/mman.h>
+
+using namespace std;
+
+DistanceTable::DistanceTable()
+    : bits_per_entry(32), num_entries(0), entries(0),
+      mapped_data(0), mapped_size(0) {
+}
+
+DistanceTable::~DistanceTable() {
+    clear();
+}
+
+void DistanceTable::clear() {
+    vector<int>().swap(int_entries);
+    vector<unsigned short>().swap(short_entries);
+    vector<unsigned char>().swap(byte_entries);
+    if (mapped_data)
+        munmap(mapped_data, mapped_size);
+    mapped_data = 0;
+    mapped_size = 0;
+    entries = 0;
+    num_entries = 0;
+    bits_per_entry = 32;
+}
+
+void DistanceTable::assign(vector<int> &distances, bool compress) {
+    clear();
+    num_entries = distances.size();
+
+    int max_distance = 0;
+    if (compress) {
+        for (size_t i = 0; i < distances.size(); ++i) {
+            if (distances[i] != numeric_limits<int>::max())
+                max_distance = max(max_distance, distances[i]);
+        }
+    }
+    // The largest value of an entry marks dead ends.
+    if (!compress || max_distance >= 65535) {
+        bits_per_entry = 32;
+        int_entries.swap(distances);
+        entries = num_entries ? &int_entries[0] : 0;
+    } else if (max_distance >= 255) {
+        bits_per_entry = 16;
+        short_entries.reserve(num_entries);
+        for (size_t i = 0; i < num_entries; ++i)
+            short_entries.push_back(
+                distances[i] == numeric_limits<int>::max() ? 65535 : distances[i]);
+        entries = num_entries ? &short_entries[0] : 0;
+    } else if (max_distance >= 15) {
+        bits_per_entry = 8;
+        byte_entries.reserve(num_entries);
+        for (size_t i = 0; i < num_entries; ++i)
+            byte_entries.push_back(
+                distances[i] == numeric_limits<int>::max() ? 255 : distances[i]);
+        entries = num_entries ? &byte_entries[0] : 0;
+    } else {
+        bits_per_entry = 4;
+        byte_entries.resize((num_entries + 1) / 2, 0);
+        for (size_t i = 0; i < num_entries; ++i) {
+            int value = distances[i] == numeric_limits<int>::max() ? 15 : distances[i];
+            byte_entries[i / 2] |= value << (4 * (i % 2));
+        }
+        entries = num_entries ? &byte_entries[0] : 0;
+    }
+    vector<int>().swap(distances);
+}
+
+void DistanceTable::assign_mapped(void *mapped_data_, size_t mapped_size_,
+                                  const char *entries_, int bits_per_entry_,
+                                  size_t num_entries_) {
+    clear();
+    mapped_data = mapped_data_;
+    mapped_size = mapped_size_;
+    entries = entries_;
+    bits_per_entry = bits_per_entry_;
+    num_entries = num_entries_;
+}
+
+size_t DistanceTable::get_memory() const {
+    return get_memory(bits_per_entry, num_entries);
+}
+
+size_t DistanceTable::get_memory(int bits_per_entry, size_t num_entries) {
+    if (bits_per_entry == 4)
+        return (num_entries + 1) / 2;
+    return num_entries * (bits_per_entry / 8);
+}
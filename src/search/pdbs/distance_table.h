@@ -0,0 +1,88 @@
+#ifndef PDBS_DISTANCE_TABLE_H
+#define PDBS_DISTANCE_TABLE_H
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/*
+  The distances of all abstract states of a PDB, where dead ends have the
+  distance numeric_limits<int>::max().
+
+  A compressed table stores every entry with the fewest bits (4, 8 or 16)
+  in which the largest finite distance and a marker for dead ends fit, and
+  uses 32 bits if no narrower entries suffice. Small distances are common
+  (e.g. on unit-cost tasks), so this often needs a quarter to an eighth of
+  the memory. An uncompressed table always uses 32 bits.
+
+  The entries are either owned by the table or are part of a file that is
+  mapped into memory (see pdb_cache.h).
+*/
+class DistanceTable {
+    int bits_per_entry;
+    size_t num_entries;
+    // Only the vector for the current number of bits is used. With 4 bits,
+    // entry i is stored in the low (i even) or high (i odd) half of byte i / 2.
+    std::vector<int> int_entries;
+    std::vector<unsigned short> short_entries;
+    std::vector<unsigned char> byte_entries;
+    // Points to the entries, in one of the vectors or in the mapped file.
+    const void *entries;
+    void *mapped_data;
+    size_t mapped_size;
+
+    void clear();
+
+    // Not implemented.
+    DistanceTable(const DistanceTable &);
+    DistanceTable &operator=(const DistanceTable &);
+public:
+    DistanceTable();
+    ~DistanceTable();
+
+    /*
+      Takes over the given distances, which are empty afterwards. Without
+      compression, their memory is taken over as well.
+    */
+    void assign(std::vector<int> &distances, bool compress);
+
+    /*
+      Uses the entries that start at the given position of a mapped file
+      in the format of get_entries. The table unmaps the file when it is
+      destroyed.
+    */
+    void assign_mapped(void *mapped_data, size_t mapped_size,
+                       const char *entries, int bits_per_entry,
+                       size_t num_entries);
+
+    int operator[](size_t index) const {
+        switch (bits_per_entry) {
+        case 4: {
+            int value = (static_cast<const unsigned char *>(entries)[index / 2]
+                         >> (4 * (index % 2))) & 15;
+            return value == 15 ? std::numeric_limits<int>::max() : value;
+        }
+        case 8: {
+            int value = static_cast<const unsigned char *>(entries)[index];
+            return value == 255 ? std::numeric_limits<int>::max() : value;
+        }
+        case 16: {
+            int value = static_cast<const unsigned short *>(entries)[index];
+            return value == 65535 ? std::numeric_limits<int>::max() : value;
+        }
+        default:
+            return static_cast<const int *>(entries)[index];
+        }
+    }
+
+    size_t size() const {return num_entries; }
+    int get_bits_per_entry() const {return bits_per_entry; }
+    // Returns the entries in their stored format (get_memory bytes).
+    const void *get_entries() const {return entries; }
+    // Returns the number of bytes used for the entries.
+    size_t get_memory() const;
+    // Returns the number of bytes needed for the entries of a table.
+    static size_t get_memory(int bits_per_entry, size_t num_entries);
+};
+
+#endif
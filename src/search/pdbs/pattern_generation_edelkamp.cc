@@ -182,6 +182,9 @@ void PatternGenerationEdelkamp::evaluate(vector<double> &fitness_values) {
             Options opts;
             opts.set<int>("cost_type", cost_type);
             opts.set<vector<vector<int> > >("patterns", pattern_collection);
+            opts.set<int>("construction_threads", 1);
+            opts.set<bool>("compress_distances", false);
+            opts.set<string>("cache_dir", "");
             ZeroOnePDBsHeuristic *zoppch =
                 new ZeroOnePDBsHeuristic(opts);
             fitness = zoppch->get_approx_mean_finite_h();
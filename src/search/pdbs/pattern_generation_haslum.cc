@@ -2,6 +2,7 @@
 
 #include "canonical_pdbs_heuristic.h"
 #include "pdb_heuristic.h"
+#include "util.h"
 
 #include "../globals.h"
 #include "../legacy_causal_graph.h"
@@ -19,6 +20,7 @@
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -31,7 +33,12 @@ PatternGenerationHaslum::PatternGenerationHaslum(const Options &opts)
       min_improvement(opts.get<int>("min_improvement")),
       max_time(opts.get<int>("max_time")),
       cost_type(OperatorCost(opts.get<int>("cost_type"))),
-      num_rejected(0) {
+      construction_threads(opts.get<int>("construction_threads")),
+      early_rejection(opts.get<bool>("early_rejection")),
+      compress_distances(opts.get<bool>("compress_distances")),
+      cache_dir(opts.get<string>("cache_dir")),
+      num_rejected(0),
+      num_rejected_early(0) {
     Timer timer;
     initialize();
     cout << "Pattern generation (Haslum et al.) time: " << timer << endl;
@@ -68,7 +75,8 @@ void PatternGenerationHaslum::generate_candidate_patterns(const PDBHeuristic *pd
     }
 }
 
-void PatternGenerationHaslum::sample_states(vector<State> &samples, double average_operator_cost) {
+void PatternGenerationHaslum::sample_states(StateRegistry &registry, vector<State> &samples,
+                                            double average_operator_cost) {
     const State &initial_state = g_initial_state();
     current_heuristic->evaluate(initial_state);
     assert(!current_heuristic->is_dead_end());
@@ -100,7 +108,7 @@ void PatternGenerationHaslum::sample_states(vector<State> &samples, double avera
         }
 
         // random walk of length length
-        State current_state(initial_state);
+        State current_state(registry.get_initial_state());
         for (int j = 0; j < length; ++j) {
             vector<const Operator *> applicable_ops;
             g_successor_generator->generate_applicable_ops(current_state, applicable_ops);
@@ -110,13 +118,11 @@ void PatternGenerationHaslum::sample_states(vector<State> &samples, double avera
             } else {
                 int random = g_rng.next(applicable_ops.size()); // [0..applicable_os.size())
                 assert(applicable_ops[random]->is_applicable(current_state));
-                // TODO for now, we only generate registered successors. This is a temporary state that
-                // should should not necessarily be registered in the global registry: see issue386.
-                current_state = g_state_registry->get_successor_state(current_state, *applicable_ops[random]);
+                current_state = registry.get_successor_state(current_state, *applicable_ops[random]);
                 // if current state is a dead end, then restart with initial state
                 current_heuristic->evaluate_dead_end(current_state);
                 if (current_heuristic->is_dead_end())
-                    current_state = initial_state;
+                    current_state = registry.get_initial_state();
             }
         }
         // last state of the random walk is used as sample
@@ -124,23 +130,21 @@ void PatternGenerationHaslum::sample_states(vector<State> &samples, double avera
     }
 }
 
-bool PatternGenerationHaslum::is_heuristic_improved(PDBHeuristic *pdb_heuristic,
-                                                    const State &sample,
-                                                    const vector<vector<PDBHeuristic *> > &max_additive_subsets) {
-    pdb_heuristic->evaluate(sample);
-    if (pdb_heuristic->is_dead_end()) {
+/*
+  Returns true iff the h-value of the new pattern (h_pattern) plus the h-value of one of the
+  maximal additive subsets (given by the indices of their PDBs in the current collection)
+  is greater than the h-value of the current collection (h_collection) for a sample, where
+  h_collection_pdbs contains the h-values of the PDBs of the current collection.
+*/
+static bool is_heuristic_improved(int h_pattern, int h_collection, const int *h_collection_pdbs,
+                                  const vector<vector<int> > &max_additive_subsets) {
+    if (h_pattern == numeric_limits<int>::max()) {
         return true;
     }
-    int h_pattern = pdb_heuristic->get_heuristic(); // h-value of the new pattern
-
-    current_heuristic->evaluate(sample);
-    int h_collection = current_heuristic->get_heuristic(); // h-value of the current collection heuristic
     for (size_t k = 0; k < max_additive_subsets.size(); ++k) { // for each max additive subset...
         int h_subset = 0;
         for (size_t l = 0; l < max_additive_subsets[k].size(); ++l) { // ...calculate its h-value
-            max_additive_subsets[k][l]->evaluate(sample);
-            assert(!max_additive_subsets[k][l]->is_dead_end());
-            h_subset += max_additive_subsets[k][l]->get_heuristic();
+            h_subset += h_collection_pdbs[max_additive_subsets[k][l]];
         }
         if (h_pattern + h_subset > h_collection) {
             // return true if one max additive subest is found for which the condition is met
@@ -150,6 +154,125 @@ bool PatternGenerationHaslum::is_heuristic_improved(PDBHeuristic *pdb_heuristic,
     return false;
 }
 
+/*
+  Scores the candidates with the given indices, one at a time, until all
+  are taken. The h-values of the current collection and of its PDBs are
+  computed for all samples in advance, so that the threads only read the
+  PDBs and samples. With early rejection, a candidate is not scored
+  further once it cannot reach the best count found so far. Candidates
+  that could reach it (and maybe be selected because of a lower index)
+  are scored completely, so the selected candidate does not depend on the
+  number of threads.
+*/
+struct CandidateScoring {
+    const CanonicalPDBsHeuristic *collection;
+    const vector<PDBHeuristic *> *candidate_pdbs;
+    const vector<int> *candidate_indices;
+    volatile int *next_index;
+    const vector<State> *samples;
+    const vector<int> *sample_h_values; // h-value of the collection for each sample
+    // h-values of the PDBs of the collection, one sample after the other
+    const vector<int> *sample_pdb_h_values;
+    bool early_rejection;
+    volatile int *best_improvement;
+    vector<int> *improvements;
+
+    void run() {
+        const vector<PDBHeuristic *> &pdbs = collection->get_pattern_databases();
+        int num_pdbs = pdbs.size();
+        int num_samples = samples->size();
+        int num_indices = candidate_indices->size();
+        while (true) {
+            int index = __sync_fetch_and_add(next_index, 1);
+            if (index >= num_indices)
+                break;
+            int candidate = (*candidate_indices)[index];
+            const PDBHeuristic *pdb_heuristic = (*candidate_pdbs)[candidate];
+
+            vector<vector<PDBHeuristic *> > max_additive_subsets;
+            collection->get_max_additive_subsets(pdb_heuristic->get_pattern(), max_additive_subsets);
+            vector<vector<int> > subset_indices(max_additive_subsets.size());
+            for (size_t k = 0; k < max_additive_subsets.size(); ++k) {
+                for (size_t l = 0; l < max_additive_subsets[k].size(); ++l) {
+                    subset_indices[k].push_back(
+                        find(pdbs.begin(), pdbs.end(), max_additive_subsets[k][l]) - pdbs.begin());
+                }
+            }
+
+            int count = 0;
+            for (int j = 0; j < num_samples; ++j) {
+                if (early_rejection && count + (num_samples - j) < *best_improvement) {
+                    count = -1;
+                    break;
+                }
+                const int *h_collection_pdbs =
+                    num_pdbs ? &(*sample_pdb_h_values)[j * num_pdbs] : 0;
+                if (is_heuristic_improved(pdb_heuristic->get_abstract_distance((*samples)[j]),
+                                          (*sample_h_values)[j], h_collection_pdbs, subset_indices))
+                    ++count;
+            }
+            (*improvements)[candidate] = count;
+
+            int best = *best_improvement;
+            while (count > best) {
+                int previous = __sync_val_compare_and_swap(best_improvement, best, count);
+                if (previous == best)
+                    break;
+                best = previous;
+            }
+        }
+    }
+};
+
+void PatternGenerationHaslum::score_candidates(const vector<PDBHeuristic *> &candidate_pdbs,
+                                               const vector<State> &samples,
+                                               vector<int> &improvements) {
+    const vector<PDBHeuristic *> &pdbs = current_heuristic->get_pattern_databases();
+    vector<int> sample_h_values;
+    vector<int> sample_pdb_h_values;
+    sample_h_values.reserve(samples.size());
+    sample_pdb_h_values.reserve(samples.size() * pdbs.size());
+    for (size_t j = 0; j < samples.size(); ++j) {
+        current_heuristic->evaluate(samples[j]);
+        assert(!current_heuristic->is_dead_end());
+        sample_h_values.push_back(current_heuristic->get_heuristic());
+        for (size_t k = 0; k < pdbs.size(); ++k)
+            sample_pdb_h_values.push_back(pdbs[k]->get_abstract_distance(samples[j]));
+    }
+
+    vector<int> candidate_indices;
+    for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
+        if (candidate_pdbs[i])
+            candidate_indices.push_back(i);
+    }
+    improvements.assign(candidate_pdbs.size(), 0);
+    if (candidate_indices.empty())
+        return;
+
+    volatile int next_index = 0;
+    volatile int best_improvement = 0;
+    vector<CandidateScoring> scorings(min<size_t>(construction_threads, candidate_indices.size()));
+    for (size_t i = 0; i < scorings.size(); ++i) {
+        CandidateScoring &scoring = scorings[i];
+        scoring.collection = current_heuristic;
+        scoring.candidate_pdbs = &candidate_pdbs;
+        scoring.candidate_indices = &candidate_indices;
+        scoring.next_index = &next_index;
+        scoring.samples = &samples;
+        scoring.sample_h_values = &sample_h_values;
+        scoring.sample_pdb_h_values = &sample_pdb_h_values;
+        scoring.early_rejection = early_rejection;
+        scoring.best_improvement = &best_improvement;
+        scoring.improvements = &improvements;
+    }
+    run_workers(scorings);
+
+    for (size_t i = 0; i < improvements.size(); ++i) {
+        if (improvements[i] == -1)
+            ++num_rejected_early;
+    }
+}
+
 void PatternGenerationHaslum::hill_climbing(double average_operator_cost,
                                             vector<vector<int> > &initial_candidate_patterns) {
     Timer timer;
@@ -173,56 +296,54 @@ void PatternGenerationHaslum::hill_climbing(double average_operator_cost,
             cout << current_heuristic->get_heuristic() << endl;
         }
 
+        // The samples are only needed in this iteration.
+        StateRegistry sample_registry;
         vector<State> samples;
-        sample_states(samples, average_operator_cost);
+        sample_states(sample_registry, samples, average_operator_cost);
 
         // For the new candidate patterns check whether they already have been candidates before and
         // thus already a PDB has been created an inserted into candidate_pdbs.
+        vector<vector<int> > new_patterns;
         for (size_t i = 0; i < new_candidates.size(); ++i) {
             if (generated_patterns.count(new_candidates[i]) == 0) {
-                Options opts;
-                opts.set<int>("cost_type", cost_type);
-                opts.set<vector<int> >("pattern", new_candidates[i]);
-                candidate_pdbs.push_back(new PDBHeuristic(opts, false));
-                max_pdb_size = max(max_pdb_size,
-                                   candidate_pdbs.back()->get_size());
+                new_patterns.push_back(new_candidates[i]);
                 generated_patterns.insert(new_candidates[i]);
             }
         }
+        size_t num_old_candidates = candidate_pdbs.size();
+        PDBHeuristic::build_pdbs(new_patterns, cost_type, construction_threads,
+                                 compress_distances, cache_dir, candidate_pdbs);
+        for (size_t i = num_old_candidates; i < candidate_pdbs.size(); ++i)
+            max_pdb_size = max(max_pdb_size, candidate_pdbs[i]->get_size());
 
         // TODO: The original implementation by Haslum et al. uses astar to compute h values for
         // the sample states only instead of generating all PDBs.
         int improvement = 0; // best improvement (= hightest count) for a pattern so far
         int best_pdb_index = 0;
 
-        // Iterate over all candidates and search for the best improving pattern/pdb
         for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
             PDBHeuristic *pdb_heuristic = candidate_pdbs[i];
-            if (pdb_heuristic == 0) {
-                // candidate pattern is too large or has already been added to
-                // the canonical heuristic.
-                continue;
-            }
             // If a candidate's size added to the current collection's size exceeds the maximum
             // collection size, then delete the PDB and let the PDB's entry point to a null reference.
-            if (current_heuristic->get_size() + pdb_heuristic->get_size() > collection_max_size) {
+            // (Candidates that are 0 are too large or have already been added to the canonical heuristic.)
+            if (pdb_heuristic &&
+                current_heuristic->get_size() + pdb_heuristic->get_size() > collection_max_size) {
                 delete pdb_heuristic;
                 candidate_pdbs[i] = 0;
-                continue;
             }
+        }
 
-            // Calculate the "counting approximation" for all sample states: count the number of
-            // samples for which the current pattern collection heuristic would be improved
-            // if the new pattern was included into it.
-            // TODO: The original implementation by Haslum et al. uses m/t as a statistical
-            // confidence intervall to stop the astar-search (which they use, see above) earlier.
-            int count = 0;
-            vector<vector<PDBHeuristic *> > max_additive_subsets;
-            current_heuristic->get_max_additive_subsets(pdb_heuristic->get_pattern(), max_additive_subsets);
-            for (size_t j = 0; j < samples.size(); ++j) {
-                if (is_heuristic_improved(pdb_heuristic, samples[j], max_additive_subsets))
-                    ++count;
-            }
+        // Calculate the "counting approximation" for all sample states: count the number of
+        // samples for which the current pattern collection heuristic would be improved
+        // if the new pattern was included into it.
+        // TODO: The original implementation by Haslum et al. uses m/t as a statistical
+        // confidence intervall to stop the astar-search (which they use, see above) earlier.
+        vector<int> improvements;
+        score_candidates(candidate_pdbs, samples, improvements);
+
+        // Search for the best improving pattern/pdb
+        for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
+            int count = improvements[i];
             if (count > improvement) {
                 improvement = count;
                 best_pdb_index = i;
@@ -255,6 +376,8 @@ void PatternGenerationHaslum::hill_climbing(double average_operator_cost,
             cout << "iPDB: improvement = " << improvement << endl;
             cout << "iPDB: generated = " << generated_patterns.size() << endl;
             cout << "iPDB: rejected = " << num_rejected << endl;
+            if (early_rejection)
+                cout << "iPDB: rejected early = " << num_rejected_early << endl;
             cout << "iPDB: max_pdb_size = " << max_pdb_size << endl;
             break;
         }
@@ -301,6 +424,9 @@ void PatternGenerationHaslum::initialize() {
     Options opts;
     opts.set<int>("cost_type", cost_type);
     opts.set<vector<vector<int> > >("patterns", initial_pattern_collection);
+    opts.set<int>("construction_threads", construction_threads);
+    opts.set<bool>("compress_distances", compress_distances);
+    opts.set<string>("cache_dir", cache_dir);
     current_heuristic = new CanonicalPDBsHeuristic(opts);
     current_heuristic->evaluate(g_initial_state());
     if (current_heuristic->is_dead_end())
@@ -339,11 +465,19 @@ static Heuristic *_parse(OptionParser &parser) {
     parser.add_option<int>("max_time",
                            "Time limit for hill climbing. Use 0 (default) for no limit.",
                            "0");
+    parser.add_option<bool>("early_rejection",
+                            "stop counting the improved samples of a candidate pattern as soon "
+                            "as it cannot reach the best count of the iteration. This does not "
+                            "change the selected patterns, but the improvements of rejected "
+                            "candidates are not reported.",
+                            "false");
+    add_construction_options(parser);
 
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.help_mode())
         return 0;
+    check_construction_options(parser, opts);
 
     if (opts.get<int>("pdb_max_size") < 1)
         parser.error("size per pdb must be at least 1");
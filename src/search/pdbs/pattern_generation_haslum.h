@@ -4,12 +4,14 @@
 #include "../operator_cost.h"
 
 #include <map>
+#include <string>
 #include <vector>
 
 class Options;
 class CanonicalPDBsHeuristic;
 class PDBHeuristic;
 class State;
+class StateRegistry;
 // Implementation of the pattern generation algorithm by Haslum et al.
 class PatternGenerationHaslum {
     const int pdb_max_size; // maximum number of states for each pdb
@@ -18,9 +20,14 @@ class PatternGenerationHaslum {
     const int min_improvement; // minimal improvement required for hill climbing to continue search
     const int max_time;
     const OperatorCost cost_type;
+    const int construction_threads; // number of threads used to build and score the candidate PDBs
+    const bool early_rejection; // stop scoring candidates that cannot beat the best candidate
+    const bool compress_distances; // whether all PDBs store their distances compressed
+    const std::string cache_dir; // directory of cached PDBs, or empty
     CanonicalPDBsHeuristic *current_heuristic;
 
     int num_rejected; // for stats only
+    int num_rejected_early; // for stats only
 
     /* For the given pattern, all possible extensions of the pattern by one relevant variable
        are inserted into candidate_patterns. This may generate duplicated patterns. */
@@ -33,14 +40,17 @@ class PatternGenerationHaslum {
        and applied to the current state. If a dead end is reached or no more operators are
        applicable, the walk starts over again from the initial state. At the end of each random
        walk, the last state visited is taken as a sample state, thus totalling exactly
-       num_samples of sample states. */
-    void sample_states(std::vector<State> &samples, double average_operator_costs);
+       num_samples of sample states. The states of the random walks are registered in the given
+       registry instead of the global one, so that they are freed with the registry. */
+    void sample_states(StateRegistry &registry, std::vector<State> &samples, double average_operator_costs);
 
-    /* Returns true iff the h-value of the new pattern (from pdb_heuristic) plus the h-value of all
-       maximal additive subsets from the current pattern collection heuristic if the new pattern was
-       added to it is greater than the the h-value of the current pattern collection. */
-    bool is_heuristic_improved(PDBHeuristic *pdb_heuristic, const State &sample,
-                               const std::vector<std::vector<PDBHeuristic *> > &max_additive_subsets);
+    /* Counts for each candidate PDB (that is not 0) the samples for which the h-value of the new pattern plus
+       the h-value of one of the maximal additive subsets of the current collection that remain additive with
+       it is greater than the h-value of the current collection. The counts are stored in improvements (-1 for
+       candidates that are rejected early, see early_rejection, and 0 for candidates that are 0).
+       The candidates are scored by construction_threads threads at the same time. */
+    void score_candidates(const std::vector<PDBHeuristic *> &candidate_pdbs,
+                          const std::vector<State> &samples, std::vector<int> &improvements);
 
     /* This is the core algorithm of this class. As soon as after an iteration, the improvement (according
        to the "counting approximation") is smaller than the minimal required improvement, the search is
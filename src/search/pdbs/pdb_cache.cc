@@ -0,0 +1,203 @@
+#include "pdb_cache.h"
+
+#include "distance_table.h"
+
+#include "../globals.h"
+#include "../operator.h"
+#include "../utilities.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// The header line of a cache file starts with this word.
+static const char CACHE_MAGIC[] = "pdb_cache";
+static const int CACHE_VERSION = 1;
+static const int BYTE_ORDER_MARK = 0x01020304;
+
+static void add_operators(const vector<Operator> &operators, vector<int> &data) {
+    data.push_back(operators.size());
+    for (size_t i = 0; i < operators.size(); ++i) {
+        const vector<Prevail> &prevail = operators[i].get_prevail();
+        data.push_back(prevail.size());
+        for (size_t j = 0; j < prevail.size(); ++j) {
+            data.push_back(prevail[j].var);
+            data.push_back(prevail[j].prev);
+        }
+        const vector<PrePost> &pre_post = operators[i].get_pre_post();
+        data.push_back(pre_post.size());
+        for (size_t j = 0; j < pre_post.size(); ++j) {
+            data.push_back(pre_post[j].var);
+            data.push_back(pre_post[j].pre);
+            data.push_back(pre_post[j].post);
+            data.push_back(pre_post[j].cond.size());
+            for (size_t k = 0; k < pre_post[j].cond.size(); ++k) {
+                data.push_back(pre_post[j].cond[k].var);
+                data.push_back(pre_post[j].cond[k].prev);
+            }
+        }
+    }
+}
+
+static size_t compute_task_fingerprint() {
+    vector<int> data(g_variable_domain);
+    add_operators(g_operators, data);
+    add_operators(g_axioms, data);
+    for (size_t i = 0; i < g_goal.size(); ++i) {
+        data.push_back(g_goal[i].first);
+        data.push_back(g_goal[i].second);
+    }
+    return hash_number_sequence(data, data.size());
+}
+
+static size_t get_task_fingerprint() {
+    // Computed once, by the first thread that builds a PDB.
+    static const size_t fingerprint = compute_task_fingerprint();
+    return fingerprint;
+}
+
+static string get_header(bool compressed) {
+    ostringstream header;
+    header << CACHE_MAGIC << " " << CACHE_VERSION << " " << hex
+           << get_task_fingerprint() << " " << compressed << "\n";
+    return header.str();
+}
+
+static string get_path(const string &cache_dir, const vector<int> &pattern,
+                       const vector<int> &operator_costs, bool compressed) {
+    vector<int> key(pattern);
+    key.insert(key.end(), operator_costs.begin(), operator_costs.end());
+    key.push_back(compressed);
+    size_t fingerprint = get_task_fingerprint();
+    key.push_back(fingerprint);
+    key.push_back(fingerprint >> 16 >> 16);
+    ostringstream path;
+    path << cache_dir << "/pdb-" << hex << hash_number_sequence(key, key.size())
+         << ".bin";
+    return path.str();
+}
+
+// The ints after the header line, which is padded to a multiple of 4 bytes.
+static void get_ints(const vector<int> &pattern, const vector<int> &operator_costs,
+                     const vector<bool> &relevant_operators, int num_states,
+                     int bits_per_entry, vector<int> &ints) {
+    ints.push_back(BYTE_ORDER_MARK);
+    ints.push_back(pattern.size());
+    ints.insert(ints.end(), pattern.begin(), pattern.end());
+    ints.push_back(operator_costs.size());
+    ints.insert(ints.end(), operator_costs.begin(), operator_costs.end());
+    ints.insert(ints.end(), relevant_operators.begin(), relevant_operators.end());
+    ints.push_back(num_states);
+    ints.push_back(bits_per_entry);
+}
+
+static size_t get_padded_size(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+bool load_cached_pdb(const string &cache_dir, const vector<int> &pattern,
+                     const vector<int> &operator_costs, bool compressed,
+                     vector<bool> &relevant_operators,
+                     DistanceTable &distances) {
+    string path = get_path(cache_dir, pattern, operator_costs, compressed);
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+    struct stat file_status;
+    void *mapped_data = MAP_FAILED;
+    size_t mapped_size = 0;
+    if (fstat(fd, &file_status) == 0 && file_status.st_size > 0) {
+        mapped_size = file_status.st_size;
+        mapped_data = mmap(0, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (mapped_data == MAP_FAILED)
+        return false;
+
+    // Compare everything before the entries, except for the relevant
+    // operators and the kind of entries, which are read from the file.
+    const char *data = static_cast<const char *>(mapped_data);
+    string header = get_header(compressed);
+    size_t offset = get_padded_size(header.size(), sizeof(int));
+    vector<int> expected;
+    get_ints(pattern, operator_costs, vector<bool>(), 0, 0, expected);
+    size_t num_operators = operator_costs.size();
+    size_t num_ints = expected.size() + num_operators;
+    bool matches = mapped_size >= offset + num_ints * sizeof(int) &&
+                   memcmp(data, header.data(), header.size()) == 0;
+    const int *ints = reinterpret_cast<const int *>(data + offset);
+    size_t num_relevant_start = expected.size() - 2;
+    if (matches)
+        matches = memcmp(ints, &expected[0], num_relevant_start * sizeof(int)) == 0;
+
+    if (matches) {
+        size_t num_states = 1;
+        for (size_t i = 0; i < pattern.size(); ++i)
+            num_states *= g_variable_domain[pattern[i]];
+        const int *rest = ints + num_relevant_start + num_operators;
+        int bits_per_entry = rest[1];
+        size_t entries_offset = get_padded_size(offset + num_ints * sizeof(int),
+                                                sizeof(int) * 2);
+        matches = static_cast<size_t>(rest[0]) == num_states &&
+                  (bits_per_entry == 32 || (compressed &&
+                                            (bits_per_entry == 4 ||
+                                             bits_per_entry == 8 ||
+                                             bits_per_entry == 16))) &&
+                  mapped_size >= entries_offset +
+                  DistanceTable::get_memory(bits_per_entry, num_states);
+        if (matches) {
+            const int *relevant = ints + num_relevant_start;
+            relevant_operators.assign(relevant, relevant + num_operators);
+            distances.assign_mapped(mapped_data, mapped_size,
+                                    data + entries_offset, bits_per_entry,
+                                    num_states);
+            return true;
+        }
+    }
+    munmap(mapped_data, mapped_size);
+    return false;
+}
+
+void save_cached_pdb(const string &cache_dir, const vector<int> &pattern,
+                     const vector<int> &operator_costs, bool compressed,
+                     const vector<bool> &relevant_operators,
+                     const DistanceTable &distances) {
+    static volatile int num_saved_files = 0;
+    string path = get_path(cache_dir, pattern, operator_costs, compressed);
+    // Threads and processes that save the same PDB use different files.
+    ostringstream temp_path;
+    temp_path << path << ".tmp" << getpid() << "-"
+              << __sync_fetch_and_add(&num_saved_files, 1);
+
+    string header = get_header(compressed);
+    header.resize(get_padded_size(header.size(), sizeof(int)), '\0');
+    vector<int> ints;
+    get_ints(pattern, operator_costs, relevant_operators, distances.size(),
+             distances.get_bits_per_entry(), ints);
+    size_t size = header.size() + ints.size() * sizeof(int);
+    string padding(get_padded_size(size, sizeof(int) * 2) - size, '\0');
+
+    FILE *file = fopen(temp_path.str().c_str(), "wb");
+    bool ok = file != 0;
+    if (ok) {
+        ok = fwrite(header.data(), 1, header.size(), file) == header.size() &&
+             fwrite(&ints[0], sizeof(int), ints.size(), file) == ints.size() &&
+             fwrite(padding.data(), 1, padding.size(), file) == padding.size() &&
+             fwrite(distances.get_entries(), 1, distances.get_memory(), file) ==
+             distances.get_memory();
+        ok = fclose(file) == 0 && ok;
+    }
+    if (ok)
+        ok = rename(temp_path.str().c_str(), path.c_str()) == 0;
+    if (!ok) {
+        cerr << "Could not write PDB cache file " << path << "." << endl;
+        remove(temp_path.str().c_str());
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef PDBS_PDB_CACHE_H
+#define PDBS_PDB_CACHE_H
+
+#include <string>
+#include <vector>
+
+class DistanceTable;
+
+/*
+  A cache directory holds the distances of PDBs that were built before,
+  so that later runs on the same task (e.g. with other search settings)
+  can use them instead of building the PDBs again.
+
+  Each PDB is stored in its own file, whose name is derived from the
+  pattern, the operator costs, whether the distances are compressed and
+  a fingerprint of the task (variables, operators, axioms and goal). The
+  file starts with these data and a PDB is only loaded from a file if
+  they match exactly, so files of other tasks are never used (unless the
+  fingerprints of two tasks collide) and are overwritten when the PDB is
+  built again. The distances are stored in the format of DistanceTable,
+  so that loading a PDB maps them into memory without reading them.
+
+  Files are written under a temporary name and renamed when they are
+  complete, so that several planners can use the same cache directory.
+*/
+
+// Returns true and sets the relevant operators and distances of the PDB
+// if the cache directory contains a matching file.
+extern bool load_cached_pdb(const std::string &cache_dir,
+                            const std::vector<int> &pattern,
+                            const std::vector<int> &operator_costs,
+                            bool compressed,
+                            std::vector<bool> &relevant_operators,
+                            DistanceTable &distances);
+
+// Writes the file for the PDB. Failures are reported, but the planner
+// continues without updating the cache.
+extern void save_cached_pdb(const std::string &cache_dir,
+                            const std::vector<int> &pattern,
+                            const std::vector<int> &operator_costs,
+                            bool compressed,
+                            const std::vector<bool> &relevant_operators,
+                            const DistanceTable &distances);
+
+#endif
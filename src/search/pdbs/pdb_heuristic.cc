@@ -1,6 +1,7 @@
 #include "pdb_heuristic.h"
 
 #include "match_tree.h"
+#include "pdb_cache.h"
 #include "util.h"
 
 #include "../globals.h"
@@ -16,12 +17,24 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <functional>
 #include <limits>
+#include <map>
 #include <string>
 #include <vector>
 
 using namespace std;
 
+/*
+  With more than one thread, PDBs with at least this many states are
+  built one after the other with all threads, using a regression search
+  that expands the states of a layer in parallel if the layer has at
+  least MIN_LAYER_SIZE_FOR_THREADS states. Smaller PDBs are built by one
+  thread each.
+*/
+static const size_t MIN_STATES_FOR_PARALLEL_REGRESSION = 1000000;
+static const size_t MIN_LAYER_SIZE_FOR_THREADS = 10000;
+
 AbstractOperator::AbstractOperator(const vector<pair<int, int> > &prev_pairs,
                                    const vector<pair<int, int> > &pre_pairs,
                                    const vector<pair<int, int> > &eff_pairs, int c,
@@ -76,7 +89,8 @@ PDBHeuristic::PDBHeuristic(
     relevant_operators.resize(g_operators.size(), false);
 
     Timer timer;
-    set_pattern(opts.get_list<int>("pattern"));
+    set_pattern(opts.get_list<int>("pattern"), opts.get<int>("construction_threads"),
+                opts.get<bool>("compress_distances"), opts.get<string>("cache_dir"));
     if (dump)
         cout << "PDB construction time: " << timer << endl;
 }
@@ -84,7 +98,7 @@ PDBHeuristic::PDBHeuristic(
 PDBHeuristic::~PDBHeuristic() {
 }
 
-void PDBHeuristic::verify_no_axioms_no_cond_effects() const {
+void PDBHeuristic::verify_no_axioms_no_cond_effects() {
     if (!g_axioms.empty()) {
         cerr << "Heuristic does not support axioms!" << endl << "Terminating." << endl;
         exit_with(EXIT_UNSUPPORTED);
@@ -174,7 +188,7 @@ void PDBHeuristic::build_abstract_operators(
     multiply_out(0, op_no, operator_costs[op_no], prev_pairs, pre_pairs, eff_pairs, effects_without_pre, operators);
 }
 
-void PDBHeuristic::create_pdb() {
+void PDBHeuristic::create_pdb(int num_threads, bool compress) {
     // compute all abstract operators
     vector<AbstractOperator> operators;
     for (size_t i = 0; i < g_operators.size(); ++i) {
@@ -195,19 +209,29 @@ void PDBHeuristic::create_pdb() {
         }
     }
 
+    vector<int> distances;
     distances.reserve(num_states);
-    AdaptiveQueue<size_t> pq; // (first implicit entry: priority,) second entry: index for an abstract state
-
-    // initialize queue
+    vector<size_t> goal_states;
     for (size_t state_index = 0; state_index < num_states; ++state_index) {
         if (is_goal_state(state_index, abstract_goal)) {
-            pq.push(0, state_index);
+            goal_states.push_back(state_index);
             distances.push_back(0);
         } else {
             distances.push_back(numeric_limits<int>::max());
         }
     }
 
+    if (num_threads > 1 && num_states >= MIN_STATES_FOR_PARALLEL_REGRESSION) {
+        compute_distances_in_layers(match_tree, goal_states, distances, num_threads);
+        distance_table.assign(distances, compress);
+        return;
+    }
+
+    // initialize queue
+    AdaptiveQueue<size_t> pq; // (first implicit entry: priority,) second entry: index for an abstract state
+    for (size_t i = 0; i < goal_states.size(); ++i)
+        pq.push(0, goal_states[i]);
+
     // Dijkstra loop
     while (!pq.empty()) {
         pair<int, size_t> node = pq.pop();
@@ -229,9 +253,109 @@ void PDBHeuristic::create_pdb() {
             }
         }
     }
+    distance_table.assign(distances, compress);
+}
+
+// Maps distances to the states that were reached with this distance.
+typedef map<int, vector<size_t> > DistanceBuckets;
+
+/*
+  Expands the states layer[begin] to layer[end - 1] of a layer of the
+  regression search: lowers the distances of their predecessors and
+  adds the predecessors whose distances were lowered to the buckets of
+  their new distances. If the layer is expanded by several threads at
+  the same time, distances are lowered with compare-and-swap.
+*/
+struct LayerExpansion {
+    const MatchTree *match_tree;
+    const vector<size_t> *layer;
+    size_t begin;
+    size_t end;
+    int distance;
+    int *distances;
+    bool atomic;
+    DistanceBuckets buckets;
+
+    bool lower_distance(size_t state_index, int new_distance) {
+        int &entry = distances[state_index];
+        if (!atomic) {
+            if (new_distance >= entry)
+                return false;
+            entry = new_distance;
+            return true;
+        }
+        int old_distance = entry;
+        while (new_distance < old_distance) {
+            int previous = __sync_val_compare_and_swap(&entry, old_distance, new_distance);
+            if (previous == old_distance)
+                return true;
+            old_distance = previous;
+        }
+        return false;
+    }
+
+    void run() {
+        vector<const AbstractOperator *> applicable_operators;
+        for (size_t i = begin; i < end; ++i) {
+            size_t state_index = (*layer)[i];
+            // Skip states that were reached with a lower distance later.
+            if (distances[state_index] < distance)
+                continue;
+            applicable_operators.clear();
+            match_tree->get_applicable_operators(state_index, applicable_operators);
+            for (size_t j = 0; j < applicable_operators.size(); ++j) {
+                size_t predecessor = state_index + applicable_operators[j]->get_hash_effect();
+                int alternative_cost = distance + applicable_operators[j]->get_cost();
+                if (lower_distance(predecessor, alternative_cost))
+                    buckets[alternative_cost].push_back(predecessor);
+            }
+        }
+    }
+};
+
+void PDBHeuristic::compute_distances_in_layers(const MatchTree &match_tree,
+                                               vector<size_t> &goal_states,
+                                               vector<int> &distances,
+                                               int num_threads) {
+    DistanceBuckets buckets;
+    buckets[0].swap(goal_states);
+    while (!buckets.empty()) {
+        // Predecessors of operators with cost 0 are added to the bucket of
+        // the current layer again and expanded in the next iteration.
+        int distance = buckets.begin()->first;
+        vector<size_t> layer;
+        layer.swap(buckets.begin()->second);
+        buckets.erase(buckets.begin());
+
+        int num_parts = layer.size() < MIN_LAYER_SIZE_FOR_THREADS ? 1 : num_threads;
+        vector<LayerExpansion> expansions(num_parts);
+        for (int i = 0; i < num_parts; ++i) {
+            LayerExpansion &expansion = expansions[i];
+            expansion.match_tree = &match_tree;
+            expansion.layer = &layer;
+            expansion.begin = layer.size() * i / num_parts;
+            expansion.end = layer.size() * (i + 1) / num_parts;
+            expansion.distance = distance;
+            expansion.distances = &distances[0];
+            expansion.atomic = num_parts > 1;
+        }
+        run_workers(expansions);
+
+        for (int i = 0; i < num_parts; ++i) {
+            DistanceBuckets &new_states = expansions[i].buckets;
+            for (DistanceBuckets::iterator it = new_states.begin(); it != new_states.end(); ++it) {
+                vector<size_t> &bucket = buckets[it->first];
+                if (bucket.empty())
+                    bucket.swap(it->second);
+                else
+                    bucket.insert(bucket.end(), it->second.begin(), it->second.end());
+            }
+        }
+    }
 }
 
-void PDBHeuristic::set_pattern(const vector<int> &pat) {
+void PDBHeuristic::set_pattern(const vector<int> &pat, int num_threads, bool compress,
+                               const string &cache_dir) {
     assert_sorted_unique(pat);
     pattern = pat;
     hash_multipliers.reserve(pattern.size());
@@ -242,7 +366,103 @@ void PDBHeuristic::set_pattern(const vector<int> &pat) {
         variable_to_index[pattern[i]] = i;
         num_states *= g_variable_domain[pattern[i]];
     }
-    create_pdb();
+    if (cache_dir.empty()) {
+        create_pdb(num_threads, compress);
+    } else if (!load_cached_pdb(cache_dir, pattern, operator_costs, compress,
+                                relevant_operators, distance_table)) {
+        create_pdb(num_threads, compress);
+        save_cached_pdb(cache_dir, pattern, operator_costs, compress,
+                        relevant_operators, distance_table);
+    }
+}
+
+static PDBHeuristic *create_pdb_for_pattern(const vector<int> &pattern,
+                                            OperatorCost cost_type,
+                                            int num_threads,
+                                            bool compress_distances,
+                                            const string &cache_dir) {
+    Options opts;
+    opts.set<int>("cost_type", cost_type);
+    opts.set<vector<int> >("pattern", pattern);
+    opts.set<int>("construction_threads", num_threads);
+    opts.set<bool>("compress_distances", compress_distances);
+    opts.set<string>("cache_dir", cache_dir);
+    return new PDBHeuristic(opts, false);
+}
+
+// Builds the PDBs for the given patterns, one at a time, until all are taken.
+struct PDBConstruction {
+    const vector<vector<int> > *patterns;
+    // Indices of the patterns to build, in the order in which they are taken.
+    const vector<int> *pattern_indices;
+    volatile int *next_index;
+    OperatorCost cost_type;
+    bool compress_distances;
+    const string *cache_dir;
+    vector<PDBHeuristic *> *pdbs;
+
+    void run() {
+        int num_indices = pattern_indices->size();
+        while (true) {
+            int index = __sync_fetch_and_add(next_index, 1);
+            if (index >= num_indices)
+                break;
+            int pattern_index = (*pattern_indices)[index];
+            (*pdbs)[pattern_index] = create_pdb_for_pattern(
+                (*patterns)[pattern_index], cost_type, 1, compress_distances,
+                *cache_dir);
+        }
+    }
+};
+
+void PDBHeuristic::build_pdbs(const vector<vector<int> > &patterns,
+                              OperatorCost cost_type, int num_threads,
+                              bool compress_distances, const string &cache_dir,
+                              vector<PDBHeuristic *> &pdbs) {
+    assert(num_threads >= 1);
+    if (num_threads == 1) {
+        for (size_t i = 0; i < patterns.size(); ++i)
+            pdbs.push_back(create_pdb_for_pattern(patterns[i], cost_type, 1,
+                                                  compress_distances, cache_dir));
+        return;
+    }
+    // Only the calling thread may terminate the planner for unsupported tasks.
+    verify_no_axioms_no_cond_effects();
+
+    vector<PDBHeuristic *> new_pdbs(patterns.size(), 0);
+    // Small PDBs are taken in order of decreasing size, so that no thread
+    // is left with a large PDB at the end.
+    vector<pair<size_t, int> > small_pdbs;
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        size_t size = 1;
+        for (size_t j = 0; j < patterns[i].size(); ++j)
+            size *= g_variable_domain[patterns[i][j]];
+        if (size >= MIN_STATES_FOR_PARALLEL_REGRESSION)
+            new_pdbs[i] = create_pdb_for_pattern(patterns[i], cost_type, num_threads,
+                                                 compress_distances, cache_dir);
+        else
+            small_pdbs.push_back(make_pair(size, i));
+    }
+    sort(small_pdbs.begin(), small_pdbs.end(), greater<pair<size_t, int> >());
+
+    if (!small_pdbs.empty()) {
+        vector<int> pattern_indices;
+        for (size_t i = 0; i < small_pdbs.size(); ++i)
+            pattern_indices.push_back(small_pdbs[i].second);
+        volatile int next_index = 0;
+        vector<PDBConstruction> constructions(min<size_t>(num_threads, small_pdbs.size()));
+        for (size_t i = 0; i < constructions.size(); ++i) {
+            constructions[i].patterns = &patterns;
+            constructions[i].pattern_indices = &pattern_indices;
+            constructions[i].next_index = &next_index;
+            constructions[i].cost_type = cost_type;
+            constructions[i].compress_distances = compress_distances;
+            constructions[i].cache_dir = &cache_dir;
+            constructions[i].pdbs = &new_pdbs;
+        }
+        run_workers(constructions);
+    }
+    pdbs.insert(pdbs.end(), new_pdbs.begin(), new_pdbs.end());
 }
 
 bool PDBHeuristic::is_goal_state(const size_t state_index, const vector<pair<int, int> > &abstract_goal) const {
@@ -269,21 +489,31 @@ void PDBHeuristic::initialize() {
 }
 
 int PDBHeuristic::compute_heuristic(const State &state) {
-    int h = distances[hash_index(state)];
+    int h = get_abstract_distance(state);
     if (h == numeric_limits<int>::max())
         return DEAD_END;
     return h;
 }
 
+int PDBHeuristic::get_abstract_distance(const State &state) const {
+    return distance_table[hash_index(state)];
+}
+
+Heuristic *PDBHeuristic::create_thread_clone() {
+    // Share the distances, computing heuristic values only reads them.
+    return create_sharing_clone();
+}
+
 double PDBHeuristic::compute_mean_finite_h() const {
     double sum = 0;
     int size = num_states;
-    for (size_t i = 0; i < distances.size(); ++i) {
-        if (distances[i] == numeric_limits<int>::max()) {
+    for (size_t i = 0; i < distance_table.size(); ++i) {
+        int distance = distance_table[i];
+        if (distance == numeric_limits<int>::max()) {
             --size;
             continue;
         }
-        sum += distances[i];
+        sum += distance;
     }
     if (size == 0) { // empty pattern or all states are dead-end
         return numeric_limits<double>::infinity();
@@ -1,8 +1,12 @@
 #ifndef PDBS_PDB_HEURISTIC_H
 #define PDBS_PDB_HEURISTIC_H
 
+#include "distance_table.h"
+
 #include "../heuristic.h"
+#include "../operator_cost.h"
 
+#include <string>
 #include <vector>
 
 class AbstractOperator {
@@ -40,6 +44,7 @@ public:
 };
 
 // Implements a single PDB
+class MatchTree;
 class Operator;
 class State;
 class PDBHeuristic : public Heuristic {
@@ -55,10 +60,10 @@ class PDBHeuristic : public Heuristic {
     std::vector<int> variable_to_index;
 
     // final h-values for abstract-states. dead-ends are represented by numeric_limits<int>::max()
-    std::vector<int> distances;
+    DistanceTable distance_table;
 
     std::vector<size_t> hash_multipliers; // multipliers for each variable for perfect hash function
-    void verify_no_axioms_no_cond_effects() const; // we support SAS+ tasks only
+    static void verify_no_axioms_no_cond_effects(); // we support SAS+ tasks only
 
     /* Recursive method; called by build_abstract_operators.
        In the case of a precondition with value = -1 in the conrete operator, all mutliplied out abstract
@@ -75,25 +80,37 @@ class PDBHeuristic : public Heuristic {
     void build_abstract_operators(int op_no, std::vector<AbstractOperator> &operators);
 
     /* Computes all abstract operators, builds the match tree (successor generator) and then does a Dijkstra regression
-       search to compute all final h-values (stored in distances). */
-    void create_pdb();
+       search to compute all final h-values (stored in distance_table, compressed if compress is true). Large PDBs are
+       computed with compute_distances_in_layers if more than one thread is used. */
+    void create_pdb(int num_threads, bool compress);
+
+    /* Regression search that expands all states with the same distance (starting with the goal states, which must
+       have distance 0) before the states with the next higher distance. The states of large layers are expanded by
+       num_threads threads at the same time. Computes the same distances as the Dijkstra search. */
+    void compute_distances_in_layers(const MatchTree &match_tree, std::vector<size_t> &goal_states,
+                                     std::vector<int> &distances, int num_threads);
 
-    // Sets the pattern for the PDB and initializes hash_multipliers and num_states.
-    void set_pattern(const std::vector<int> &pattern);
+    /* Sets the pattern for the PDB, initializes hash_multipliers and num_states and creates the PDB, or loads it
+       from the cache directory if it is not empty and contains the PDB (see pdb_cache.h). */
+    void set_pattern(const std::vector<int> &pattern, int num_threads, bool compress,
+                     const std::string &cache_dir);
 
     /* For a given abstract state (given as index), the according values for each variable in the state are computed
        and compared with the given pairs of goal variables and values. Returns true iff the state is a goal state. */
     bool is_goal_state(const size_t state_index, const std::vector<std::pair<int, int> > &abstract_goal) const;
 
     /* The given concrete state is used to calculate the index of the according abstract state. This is only used
-       for table lookup (distances) during search. */
+       for table lookup (distance_table) during search. */
     size_t hash_index(const State &state) const;
 protected:
     virtual void initialize();
     virtual int compute_heuristic(const State &state);
+    virtual Heuristic *create_thread_clone();
 public:
     /* Important: It is assumed that the pattern (passed via Options) is small enough so that the number of
                   abstract states is below numeric_limits<int>::max()
+       The options contain the pattern, construction_threads, the number of threads used to compute the
+       distances if the PDB is large, compress_distances (see DistanceTable) and cache_dir (see pdb_cache.h).
        Parameters:
        dump:     If set to true, prints the construction time.
        op_costs: Can specify individual operator costs for each operator. This is useful for action cost
@@ -103,12 +120,32 @@ public:
                  const std::vector<int> &op_costs = std::vector<int>());
     virtual ~PDBHeuristic();
 
+    /* Builds the PDBs for the given patterns with num_threads threads (including the calling thread) and appends
+       them to pdbs in the order of the patterns. Large PDBs are built one after the other with all threads (see
+       compute_distances_in_layers), the other PDBs are built at the same time with one thread each. */
+    static void build_pdbs(const std::vector<std::vector<int> > &patterns, OperatorCost cost_type,
+                           int num_threads, bool compress_distances, const std::string &cache_dir,
+                           std::vector<PDBHeuristic *> &pdbs);
+
     // Returns the pattern (i.e. all variables used) of the PDB
     const std::vector<int> &get_pattern() const {return pattern; }
 
+    /* Returns the h-value of the abstract state of the given state (numeric_limits<int>::max() for dead-ends).
+       Unlike evaluate, this does not modify the heuristic, so it can be used by several threads at once. */
+    int get_abstract_distance(const State &state) const;
+
     // Returns the size (number of abstrat states) of the PDB
     size_t get_size() const {return num_states; }
 
+    // Returns the number of bytes used to store the distances
+    size_t get_distances_memory() const {return distance_table.get_memory(); }
+
+    // Returns the h-values of the abstract states by index (see hash_multipliers)
+    const DistanceTable &get_distance_table() const {return distance_table; }
+
+    // Returns the multiplier of each variable of the pattern in the index of an abstract state
+    const std::vector<size_t> &get_hash_multipliers() const {return hash_multipliers; }
+
     /* Returns the average h-value over all states, where dead-ends are ignored (they neither increase
        the sum of all h-values nor the total number of entries for the mean value calculation). If pattern
        is empty or all states are dead-ends, infinity is retuned.
@@ -5,6 +5,8 @@
 #include "../utilities.h"
 
 #include "../merge_and_shrink/variable_order_finder.h"
+#include <string>
+#include <sys/stat.h>
 #include <vector>
 
 using namespace std;
@@ -106,14 +108,53 @@ static void build_singleton_patterns(
         pattern_collection.push_back(vector<int>(1, g_goal[i].first));
 }
 
+void add_construction_options(OptionParser &parser) {
+    parser.add_option<int>(
+        "construction_threads",
+        "number of threads used to build the pattern databases. PDBs with "
+        "at least a million abstract states are built one after the other "
+        "by all threads, smaller PDBs are built at the same time by one "
+        "thread each. This does not change the heuristic.",
+        "1");
+    parser.add_option<bool>(
+        "compress_distances",
+        "store the distances of each PDB with as few bits per abstract state "
+        "as possible (4, 8, 16 or 32 bits, depending on the largest finite "
+        "distance). This does not change the heuristic, but lookups are "
+        "slightly slower.",
+        "false");
+    parser.add_option<string>(
+        "cache_dir",
+        "directory in which PDBs are stored when they are built, so that "
+        "later runs on the same task load them from there instead of "
+        "building them again. The directory must exist. If it is not "
+        "given, PDBs are not cached.",
+        "", OptionFlags(false));
+}
+
+void check_construction_options(OptionParser &parser, Options &opts) {
+    if (opts.get<int>("construction_threads") < 1)
+        parser.error("number of construction threads must be at least 1");
+    // An empty cache directory stands for no cache.
+    if (!opts.contains("cache_dir"))
+        opts.set<string>("cache_dir", "");
+    string cache_dir = opts.get<string>("cache_dir");
+    struct stat file_status;
+    if (!cache_dir.empty() &&
+        (stat(cache_dir.c_str(), &file_status) != 0 || !S_ISDIR(file_status.st_mode)))
+        parser.error("cache_dir must be an existing directory");
+}
+
 void parse_pattern(OptionParser &parser, Options &opts) {
     parser.document_synopsis("PDB", "Pattern database heuristic");
     parser.add_option<int>("max_states", "maximum abstraction size", "1000000");
     parser.add_list_option<int>("pattern", "the pattern", "", OptionFlags(false));
+    add_construction_options(parser);
 
     opts = parser.parse();
     if (parser.help_mode())
         return;
+    check_construction_options(parser, opts);
 
     vector<int> pattern;
     if (opts.contains("pattern")) {
@@ -136,10 +177,12 @@ void parse_patterns(OptionParser &parser, Options &opts) {
         "combo", "use the combo strategy", "false");
     parser.add_option<int>(
         "max_states", "maximum abstraction size for combo strategy", "1000000");
+    add_construction_options(parser);
 
     opts = parser.parse();
     if (parser.help_mode())
         return;
+    check_construction_options(parser, opts);
 
     vector<vector<int> > pattern_collection;
     if (opts.contains("patterns")) {
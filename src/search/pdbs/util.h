@@ -1,10 +1,44 @@
 #ifndef PDBS_UTIL_H
 #define PDBS_UTIL_H
 
+#include "../utilities.h"
+
+#include <iostream>
+#include <pthread.h>
+#include <vector>
+
 class OptionParser;
 class Options;
 
 extern void parse_pattern(OptionParser &parser, Options &opts);
 extern void parse_patterns(OptionParser &parser, Options &opts);
 
+// Adds the options "construction_threads", "compress_distances" and
+// "cache_dir" for heuristics that build PDBs.
+extern void add_construction_options(OptionParser &parser);
+// Checks these options and sets "cache_dir" to "" if it is not given.
+extern void check_construction_options(OptionParser &parser, Options &opts);
+
+template<class Worker>
+void *run_worker(void *worker) {
+    static_cast<Worker *>(worker)->run();
+    return 0;
+}
+
+// Calls run() of all workers, the first one in the calling thread and the
+// others in new threads, and waits until they are finished.
+template<class Worker>
+void run_workers(std::vector<Worker> &workers) {
+    std::vector<pthread_t> threads(workers.size());
+    for (size_t i = 1; i < workers.size(); ++i) {
+        if (pthread_create(&threads[i], 0, run_worker<Worker>, &workers[i]) != 0) {
+            std::cerr << "Could not create thread for pattern databases." << std::endl;
+            exit_with(EXIT_CRITICAL_ERROR);
+        }
+    }
+    workers[0].run();
+    for (size_t i = 1; i < workers.size(); ++i)
+        pthread_join(threads[i], 0);
+}
+
 #endif
@@ -10,6 +10,7 @@
 #include "../state.h"
 #include "../utilities.h"
 
+#include <limits>
 #include <vector>
 
 using namespace std;
@@ -28,6 +29,11 @@ ZeroOnePDBsHeuristic::ZeroOnePDBsHeuristic(
         operator_costs = op_costs;
     }
     const vector<vector<int> > &pattern_collection(opts.get_list<vector<int> >("patterns"));
+    // The PDBs depend on each other's operator costs, so only the
+    // distances of large PDBs are computed in parallel.
+    int construction_threads = opts.get<int>("construction_threads");
+    bool compress_distances = opts.get<bool>("compress_distances");
+    string cache_dir = opts.get<string>("cache_dir");
     //Timer timer;
     approx_mean_finite_h = 0;
     pattern_databases.reserve(pattern_collection.size());
@@ -35,6 +41,9 @@ ZeroOnePDBsHeuristic::ZeroOnePDBsHeuristic(
         Options opts;
         opts.set<int>("cost_type", cost_type);
         opts.set<vector<int> >("pattern", pattern_collection[i]);
+        opts.set<int>("construction_threads", construction_threads);
+        opts.set<bool>("compress_distances", compress_distances);
+        opts.set<string>("cache_dir", cache_dir);
         PDBHeuristic *pdb_heuristic = new PDBHeuristic(opts, false, operator_costs);
         pattern_databases.push_back(pdb_heuristic);
 
@@ -66,14 +75,18 @@ int ZeroOnePDBsHeuristic::compute_heuristic(const State &state) {
     // from the patterns in the pattern collection
     int h_val = 0;
     for (size_t i = 0; i < pattern_databases.size(); ++i) {
-        pattern_databases[i]->evaluate(state);
-        if (pattern_databases[i]->is_dead_end())
+        int h = pattern_databases[i]->get_abstract_distance(state);
+        if (h == numeric_limits<int>::max())
             return -1;
-        h_val += pattern_databases[i]->get_heuristic();
+        h_val += h;
     }
     return h_val;
 }
 
+Heuristic *ZeroOnePDBsHeuristic::create_thread_clone() {
+    return create_sharing_clone();
+}
+
 void ZeroOnePDBsHeuristic::dump() const {
     for (size_t i = 0; i < pattern_databases.size(); ++i) {
         cout << pattern_databases[i]->get_pattern() << endl;
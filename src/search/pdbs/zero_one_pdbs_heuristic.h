@@ -14,6 +14,7 @@ class ZeroOnePDBsHeuristic : public Heuristic {
 protected:
     virtual void initialize();
     virtual int compute_heuristic(const State &state);
+    virtual Heuristic *create_thread_clone();
 public:
     ZeroOnePDBsHeuristic(const Options &opts,
                          const std::vector<int> &op_costs = std::vector<int>());
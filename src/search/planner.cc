@@ -1,6 +1,8 @@
+#include "arena_allocator.h"
 #include "globals.h"
 #include "operator.h"
 #include "option_parser.h"
+#include "portfolio.h"
 #include "ext/tree_util.hh"
 #include "timer.h"
 #include "utilities.h"
@@ -9,12 +11,16 @@
 // HACK
 #include "memory_tracking_allocator.h"
 
+#include <cstdlib>
 #include <iostream>
 #include <new>
 using namespace std;
 
 
 
+static void run_search(int argc, const char **argv) __attribute__((noreturn));
+static void run_portfolio(int argc, const char **argv) __attribute__((noreturn));
+
 int main(int argc, const char **argv) {
     register_event_handlers();
 
@@ -26,6 +32,12 @@ int main(int argc, const char **argv) {
     if (string(argv[1]).compare("--help") != 0)
         read_everything(cin);
 
+    if (string(argv[1]).compare("--portfolio") == 0)
+        run_portfolio(argc, argv);
+    run_search(argc, argv);
+}
+
+static void run_search(int argc, const char **argv) {
     SearchEngine *engine = 0;
 
     //the input will be parsed twice:
@@ -50,6 +62,7 @@ int main(int argc, const char **argv) {
 
     //HACK
     cout << "Tracked memory: " << g_memory_tracking_allocated / 1024 << " KB" << endl;
+    Arena::print_reports();
 
     cout << "Search time: " << search_timer << endl;
     cout << "Total time: " << g_timer << endl;
@@ -60,3 +73,27 @@ int main(int argc, const char **argv) {
         exit_with(EXIT_UNSOLVED_INCOMPLETE);
     }
 }
+
+static void run_portfolio(int argc, const char **argv) {
+    // Usage: --portfolio PORTFOLIO_FILE [--plan-file FILENAME] [--jobs N]
+    string plan_file = g_plan_filename;
+    int num_jobs = 1;
+    for (int i = 3; i < argc; i += 2) {
+        string arg = string(argv[i]);
+        if (i + 1 < argc && arg.compare("--plan-file") == 0) {
+            plan_file = argv[i + 1];
+        } else if (i + 1 < argc && arg.compare("--jobs") == 0 &&
+                   atoi(argv[i + 1]) >= 1) {
+            num_jobs = atoi(argv[i + 1]);
+        } else {
+            cout << OptionParser::usage(argv[0]) << endl;
+            exit_with(EXIT_INPUT_ERROR);
+        }
+    }
+    if (argc < 3) {
+        cout << OptionParser::usage(argv[0]) << endl;
+        exit_with(EXIT_INPUT_ERROR);
+    }
+    Portfolio portfolio(argv[2], plan_file, num_jobs, run_search);
+    exit_with(ExitCode(portfolio.run()));
+}
@@ -8,6 +8,7 @@
 #include "open_lists/standard_scalar_open_list.h"
 #include "open_lists/open_list_buckets.h"
 #include "open_lists/tiebreaking_open_list.h"
+#include "open_lists/tiebreaking_bucket_open_list.h"
 #include "open_lists/alternation_open_list.h"
 #include "open_lists/pareto_open_list.h"
 
@@ -35,6 +36,8 @@ public:
             "single_buckets", BucketOpenList<Entry>::_parse);
         Registry<OpenList<Entry > *>::instance()->register_object(
             "tiebreaking", TieBreakingOpenList<Entry>::_parse);
+        Registry<OpenList<Entry > *>::instance()->register_object(
+            "tiebreaking_buckets", TieBreakingBucketOpenList<Entry>::_parse);
         Registry<OpenList<Entry > *>::instance()->register_object(
             "alt", AlternationOpenList<Entry>::_parse);
         Registry<OpenList<Entry > *>::instance()->register_object(
@@ -0,0 +1,582 @@
+#include "portfolio.h"
+
+#include "globals.h"
+#include "option_parser.h"
+#include "shared_plan_bound.h"
+#include "timer.h"
+#include "utilities.h"
+
+#include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <sys/resource.h>
+#include <sys/times.h>
+#include <sys/wait.h>
+#include <unistd.h>
+using namespace std;
+
+static const char *PLAN_NUMBERS_FILE = "plan_numbers_and_cost";
+
+static void check_portfolio_magic(istream &in, const string &magic) {
+    string word;
+    in >> word;
+    if (word != magic) {
+        cerr << "Invalid portfolio file: expected '" << magic << "', got '"
+             << word << "'." << endl;
+        exit_with(EXIT_INPUT_ERROR);
+    }
+}
+
+static void replace_all(string &text, const string &from, const string &to) {
+    for (size_t pos = text.find(from); pos != string::npos;
+         pos = text.find(from, pos + to.size()))
+        text.replace(pos, from.size(), to);
+}
+
+static string int_to_string(int value) {
+    ostringstream out;
+    out << value;
+    return out.str();
+}
+
+static bool starts_with(const string &text, const string &prefix) {
+    return text.compare(0, prefix.size(), prefix) == 0;
+}
+
+// Returns the words of the text in lower case (like predefined names).
+static vector<string> get_lower_case_words(const string &text) {
+    vector<string> words;
+    string word;
+    for (size_t i = 0; i <= text.size(); ++i) {
+        if (i < text.size() && (isalnum(text[i]) || text[i] == '_')) {
+            word += tolower(text[i]);
+        } else if (!word.empty()) {
+            words.push_back(word);
+            word.clear();
+        }
+    }
+    return words;
+}
+
+static void substitute_heuristic_cost_type(vector<string> &args,
+                                           int heuristic_cost_type) {
+    // Like portfolio.py, only change predefinitions before "--search".
+    for (size_t i = 0; i + 1 < args.size(); ++i) {
+        if (args[i] == "--heuristic")
+            replace_all(args[i + 1], "H_COST_TYPE",
+                        int_to_string(heuristic_cost_type));
+        else if (args[i] == "--search")
+            break;
+    }
+}
+
+static bool can_change_cost_type(const vector<string> &args) {
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (args[i].find("S_COST_TYPE") != string::npos ||
+            args[i].find("H_COST_TYPE") != string::npos)
+            return true;
+    }
+    return false;
+}
+
+// Returns the used time of this process and all finished configurations.
+static double get_used_time() {
+    struct tms the_tms;
+    times(&the_tms);
+    clock_t clocks = the_tms.tms_utime + the_tms.tms_stime +
+                     the_tms.tms_cutime + the_tms.tms_cstime;
+    return double(clocks) / sysconf(_SC_CLK_TCK);
+}
+
+
+Portfolio::Portfolio(const string &filename, const string &plan_file_,
+                     int num_jobs_, ConfigurationRunner run_configuration_)
+    : plan_file(plan_file_),
+      num_jobs(num_jobs_),
+      run_configuration(run_configuration_),
+      heuristic_cost_type(-1) {
+    read_portfolio(filename);
+}
+
+Portfolio::~Portfolio() {
+    delete g_shared_plan_bound;
+    g_shared_plan_bound = 0;
+}
+
+Portfolio::Config Portfolio::read_config(istream &in) const {
+    Config config;
+    config.is_rerun = false;
+    int num_args;
+    check_portfolio_magic(in, "begin_config");
+    in >> config.relative_time >> num_args;
+    for (int i = 0; i < num_args && in; ++i) {
+        string arg;
+        in >> ws;
+        getline(in, arg);
+        config.args.push_back(arg);
+    }
+    check_portfolio_magic(in, "end_config");
+    return config;
+}
+
+void Portfolio::read_portfolio(const string &filename) {
+    ifstream in(filename.c_str());
+    if (!in) {
+        cerr << "Could not open portfolio file " << filename << "." << endl;
+        exit_with(EXIT_INPUT_ERROR);
+    }
+    check_portfolio_magic(in, "begin_portfolio");
+    string type;
+    int num_configs = 0;
+    in >> type >> remaining_time_at_start >> num_configs;
+    if (!in || (type != "optimal" && type != "satisficing")) {
+        cerr << "Invalid portfolio file: expected the portfolio type, "
+             << "the remaining time and the number of configurations." << endl;
+        exit_with(EXIT_INPUT_ERROR);
+    }
+    optimal = (type == "optimal");
+    for (int i = 0; i < num_configs; ++i)
+        configs.push_back(read_config(in));
+    in >> has_final_config;
+    if (has_final_config)
+        final_config = read_config(in);
+    check_portfolio_magic(in, "end_portfolio");
+    if (configs.empty()) {
+        cerr << "Invalid portfolio file: no configurations." << endl;
+        exit_with(EXIT_INPUT_ERROR);
+    }
+}
+
+vector<Portfolio::Predefinition> Portfolio::get_predefinitions(
+    const vector<string> &args, const string &config_id) const {
+    /*
+      The key of a predefinition is its definition together with the keys
+      of the earlier predefinitions that it refers to. Predefinitions that
+      cannot be shared get a key that is unique to the configuration:
+      those that redefine a name and those that we cannot parse.
+    */
+    vector<Predefinition> predefinitions;
+    map<string, string> key_of_name;
+    for (size_t i = 0; i + 1 < args.size(); ++i) {
+        bool is_landmark_graph = (args[i] == "--landmarks");
+        if (!is_landmark_graph && args[i] != "--heuristic")
+            continue;
+        ++i;
+        const string &definition = args[i];
+        Predefinition predefinition;
+        predefinition.arg_index = i;
+        predefinition.is_landmark_graph = is_landmark_graph;
+        predefinition.key = args[i - 1] + " " + definition;
+        size_t split = definition.find('=');
+        bool shareable = (split != string::npos);
+        if (shareable) {
+            predefinition.names = get_lower_case_words(definition.substr(0, split));
+            vector<string> words = get_lower_case_words(definition.substr(split + 1));
+            for (size_t j = 0; j < words.size(); ++j) {
+                map<string, string>::const_iterator it = key_of_name.find(words[j]);
+                if (it != key_of_name.end())
+                    predefinition.key += " {" + it->second + "}";
+            }
+        }
+        for (size_t j = 0; j < predefinition.names.size(); ++j) {
+            if (key_of_name.count(predefinition.names[j]))
+                shareable = false;
+        }
+        if (!shareable)
+            predefinition.key += " #" + config_id;
+        for (size_t j = 0; j < predefinition.names.size(); ++j)
+            key_of_name[predefinition.names[j]] = predefinition.key;
+        predefinitions.push_back(predefinition);
+    }
+    return predefinitions;
+}
+
+void Portfolio::construct_shared_predefinitions(const vector<string> &args) {
+    // Count the configurations that contain each predefinition.
+    map<string, int> num_occurrences;
+    for (size_t i = 0; i <= configs.size(); ++i) {
+        if (i == configs.size() && !has_final_config)
+            break;
+        vector<string> config_args =
+            i < configs.size() ? configs[i].args : final_config.args;
+        if (!optimal)
+            substitute_heuristic_cost_type(config_args, heuristic_cost_type);
+        vector<Predefinition> predefinitions =
+            get_predefinitions(config_args, int_to_string(i));
+        for (size_t j = 0; j < predefinitions.size(); ++j)
+            ++num_occurrences[predefinitions[j].key];
+    }
+
+    vector<Predefinition> predefinitions = get_predefinitions(args, "current");
+    for (size_t i = 0; i < predefinitions.size(); ++i) {
+        const Predefinition &predefinition = predefinitions[i];
+        map<string, SharedPredefinition>::const_iterator it =
+            shared_predefinitions.find(predefinition.key);
+        if (it != shared_predefinitions.end()) {
+            // Later shared predefinitions may refer to these names.
+            predefine(predefinition, it->second);
+        } else if (num_occurrences[predefinition.key] >= 2) {
+            const char *predefinition_args[] = {
+                "", args[predefinition.arg_index - 1].c_str(),
+                args[predefinition.arg_index].c_str()
+            };
+            cout << "Constructing shared predefinition: "
+                 << predefinition_args[1] << " " << predefinition_args[2] << endl;
+            try {
+                OptionParser::parse_cmd_line(3, predefinition_args, true);
+                OptionParser::parse_cmd_line(3, predefinition_args, false);
+            } catch (ParseError &) {
+                // Leave the error to the configuration.
+                continue;
+            }
+            SharedPredefinition &shared = shared_predefinitions[predefinition.key];
+            shared.landmark_graph = 0;
+            for (size_t j = 0; j < predefinition.names.size(); ++j) {
+                const string &name = predefinition.names[j];
+                if (predefinition.is_landmark_graph) {
+                    // Landmark graphs are complete once they are constructed.
+                    shared.landmark_graph =
+                        Predefinitions<LandmarkGraph *>::instance()->get(name);
+                    cout << "Precomputed shared landmark graph " << name << endl;
+                } else {
+                    // Heuristics initialize themselves lazily, which would
+                    // happen in every child process.
+                    Heuristic *heuristic =
+                        Predefinitions<Heuristic *>::instance()->get(name);
+                    heuristic->ensure_initialized();
+                    shared.heuristics.push_back(heuristic);
+                    cout << "Precomputed shared heuristic " << name << endl;
+                }
+            }
+        }
+    }
+}
+
+void Portfolio::predefine(const Predefinition &predefinition,
+                          const SharedPredefinition &shared) const {
+    for (size_t i = 0; i < predefinition.names.size(); ++i) {
+        const string &name = predefinition.names[i];
+        if (predefinition.is_landmark_graph)
+            Predefinitions<LandmarkGraph *>::instance()->predefine(
+                name, shared.landmark_graph);
+        else
+            Predefinitions<Heuristic *>::instance()->predefine(
+                name, shared.heuristics[i]);
+    }
+}
+
+void Portfolio::use_shared_predefinitions(vector<string> &args) const {
+    // Predefine the shared objects and remove their definitions from args.
+    vector<Predefinition> predefinitions = get_predefinitions(args, "current");
+    vector<bool> use_arg(args.size(), true);
+    for (size_t i = 0; i < predefinitions.size(); ++i) {
+        const Predefinition &predefinition = predefinitions[i];
+        map<string, SharedPredefinition>::const_iterator it =
+            shared_predefinitions.find(predefinition.key);
+        if (it == shared_predefinitions.end())
+            continue;
+        predefine(predefinition, it->second);
+        use_arg[predefinition.arg_index - 1] = false;
+        use_arg[predefinition.arg_index] = false;
+    }
+    vector<string> remaining_args;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (use_arg[i])
+            remaining_args.push_back(args[i]);
+    }
+    args.swap(remaining_args);
+}
+
+double Portfolio::determine_timeout(const vector<Config> &queue) const {
+    // Time slices of running configurations are not available.
+    double reserved_time = 0;
+    for (map<pid_t, Job>::const_iterator it = running_jobs.begin();
+         it != running_jobs.end(); ++it)
+        reserved_time += it->second.timeout;
+    double remaining_time =
+        remaining_time_at_start - get_used_time() - reserved_time;
+    int relative_time = queue[0].relative_time;
+    cout << "remaining time: " << remaining_time << endl;
+    int remaining_relative_time = 0;
+    for (size_t i = 0; i < queue.size(); ++i)
+        remaining_relative_time += queue[i].relative_time;
+    cout << "next config: relative time " << relative_time
+         << ", remaining " << remaining_relative_time << endl;
+    // For the last config we have relative_time == remaining_relative_time,
+    // so we use all of the remaining time at the end.
+    return remaining_time * relative_time / remaining_relative_time;
+}
+
+string Portfolio::adapt_search(vector<string> &args,
+                               int search_cost_type) const {
+    string g_bound = "infinity";
+    int plan_no = 0;
+    if (g_shared_plan_bound) {
+        // Plans are numbered by save_plan.
+        plan_no = g_shared_plan_bound->get_num_plans();
+        if (plan_no > 0)
+            g_bound = int_to_string(g_shared_plan_bound->get_best_plan_cost());
+    } else {
+        ifstream plan_numbers(PLAN_NUMBERS_FILE);
+        int plan_number, plan_cost;
+        while (plan_numbers >> plan_number >> plan_cost) {
+            ++plan_no;
+            g_bound = int_to_string(plan_cost);
+        }
+    }
+    substitute_heuristic_cost_type(args, heuristic_cost_type);
+    string curr_plan_file = plan_file;
+    for (size_t i = 0; i + 1 < args.size(); ++i) {
+        if (args[i] == "--search") {
+            string &search_config = args[i + 1];
+            if (starts_with(search_config, "iterated")) {
+                if (search_config.find("plan_counter=PLANCOUNTER") == string::npos) {
+                    cerr << "When using iterated search, we must add the option "
+                         << "plan_counter=PLANCOUNTER" << endl;
+                    exit_with(EXIT_INPUT_ERROR);
+                }
+            } else if (!g_shared_plan_bound) {
+                curr_plan_file = plan_file + "." + int_to_string(plan_no + 1);
+            }
+            replace_all(search_config, "BOUND", g_bound);
+            replace_all(search_config, "PLANCOUNTER", int_to_string(plan_no));
+            replace_all(search_config, "H_COST_TYPE",
+                        int_to_string(heuristic_cost_type));
+            replace_all(search_config, "S_COST_TYPE",
+                        int_to_string(search_cost_type));
+            break;
+        }
+    }
+    cout << "g bound: " << g_bound << endl;
+    cout << "next plan number: " << plan_no + 1 << endl;
+    return curr_plan_file;
+}
+
+bool Portfolio::start_search(int search_cost_type, vector<Config> &queue) {
+    Config config(queue[0]);
+    vector<string> args(config.args);
+    string curr_plan_file = optimal ? plan_file :
+                            adapt_search(args, search_cost_type);
+    double timeout = determine_timeout(queue);
+    if (timeout <= 0)
+        return false;
+    queue.erase(queue.begin());
+
+    double construction_start = get_used_time();
+    construct_shared_predefinitions(args);
+    timeout -= get_used_time() - construction_start;
+
+    args.push_back("--plan-file");
+    args.push_back(curr_plan_file);
+    cout << "args: " << args << endl;
+
+    struct rlimit time_limit;
+    getrlimit(RLIMIT_CPU, &time_limit);
+    // Soft limit reached --> SIGXCPU. Hard limit reached --> SIGKILL.
+    rlim_t external_hard_limit = time_limit.rlim_max;
+    time_limit.rlim_cur = static_cast<rlim_t>(max(1.0, ceil(timeout)));
+    time_limit.rlim_max = time_limit.rlim_cur + 1;
+    if (external_hard_limit != RLIM_INFINITY) {
+        time_limit.rlim_max = min(time_limit.rlim_max, external_hard_limit);
+        time_limit.rlim_cur = min(time_limit.rlim_cur, external_hard_limit);
+    }
+    cout << "timeout: " << timeout << " -> (" << time_limit.rlim_cur << ", "
+         << time_limit.rlim_max << ")" << endl;
+
+    cout.flush();
+    pid_t pid = fork();
+    if (pid == -1) {
+        cerr << "Could not start configuration: " << strerror(errno) << endl;
+        exit_with(EXIT_CRITICAL_ERROR);
+    } else if (pid == 0) {
+        if (setrlimit(RLIMIT_CPU, &time_limit) == -1)
+            cerr << "Time limit could not be set: " << strerror(errno) << endl;
+        struct rlimit memory_limit;
+        getrlimit(RLIMIT_AS, &memory_limit);
+        if (num_jobs > 1 && memory_limit.rlim_cur != RLIM_INFINITY) {
+            // The configurations that run in parallel share the memory.
+            memory_limit.rlim_cur /= num_jobs;
+            if (setrlimit(RLIMIT_AS, &memory_limit) == -1)
+                cerr << "Memory limit could not be set: " << strerror(errno) << endl;
+        }
+        use_shared_predefinitions(args);
+        vector<const char *> argv;
+        argv.push_back("downward");
+        for (size_t i = 0; i < args.size(); ++i)
+            argv.push_back(args[i].c_str());
+        // Times of this process start at zero.
+        g_timer.reset();
+        run_configuration(argv.size(), &argv[0]);
+        ABORT("Configuration returned.");
+    }
+
+    Job &job = running_jobs[pid];
+    job.config = config;
+    job.timeout = timeout;
+    return true;
+}
+
+int Portfolio::wait_for_search(Job &job) {
+    int status;
+    pid_t pid;
+    while ((pid = waitpid(-1, &status, 0)) == -1) {
+        if (errno != EINTR) {
+            cerr << "Could not wait for configuration: " << strerror(errno) << endl;
+            exit_with(EXIT_CRITICAL_ERROR);
+        }
+    }
+    map<pid_t, Job>::iterator it = running_jobs.find(pid);
+    assert(it != running_jobs.end());
+    job = it->second;
+    running_jobs.erase(it);
+    // Like the return codes of Python's subprocess module.
+    int returncode = WIFEXITED(status) ? WEXITSTATUS(status) : -WTERMSIG(status);
+    cout << "returncode: " << returncode << endl << endl;
+    return returncode;
+}
+
+void Portfolio::stop_searches() {
+    for (map<pid_t, Job>::const_iterator it = running_jobs.begin();
+         it != running_jobs.end(); ++it)
+        kill(it->first, SIGTERM);
+    while (!running_jobs.empty()) {
+        pid_t pid = waitpid(-1, 0, 0);
+        if (pid == -1 && errno != EINTR)
+            break;
+        running_jobs.erase(pid);
+    }
+}
+
+void Portfolio::run_sat() {
+    bool unit_cost = (g_min_action_cost == 1 && g_max_action_cost == 1);
+    // For non-unitcost tasks we start by treating all costs as one. When we
+    // find a solution, we rerun the successful config with real costs.
+    heuristic_cost_type = 1;
+    int search_cost_type = 1;
+    bool changed_cost_types = false;
+    bool final_round = false;
+    bool out_of_time = false;
+    // Configs of the current round that have not been started yet.
+    vector<Config> queue(configs);
+    vector<Config> configs_next_round;
+    while (true) {
+        while (!out_of_time && !queue.empty() &&
+               static_cast<int>(running_jobs.size()) < num_jobs) {
+            if (!start_search(search_cost_type, queue))
+                out_of_time = true;
+        }
+        if (running_jobs.empty()) {
+            if (out_of_time || final_round)
+                break;
+            if (has_final_config) {
+                cout << "Abort portfolio and run final config." << endl;
+                final_round = true;
+                queue.assign(1, final_config);
+                queue[0].relative_time = 1;
+                queue[0].is_rerun = false;
+            } else {
+                // Only run the successful configs in the next round.
+                queue.swap(configs_next_round);
+                configs_next_round.clear();
+                if (queue.empty())
+                    break;
+            }
+            continue;
+        }
+
+        Job job;
+        int exitcode = wait_for_search(job);
+        exitcodes.push_back(exitcode);
+        if (exitcode == EXIT_UNSOLVABLE) {
+            stop_searches();
+            break;
+        }
+        if (exitcode == EXIT_PLAN_FOUND && !job.config.is_rerun) {
+            configs_next_round.push_back(job.config);
+            if (!changed_cost_types && !unit_cost &&
+                can_change_cost_type(job.config.args)) {
+                // Switch to real cost and repeat last run.
+                changed_cost_types = true;
+                search_cost_type = 0;
+                heuristic_cost_type = 2;
+                queue.insert(queue.begin(), job.config);
+                queue[0].is_rerun = true;
+            }
+        }
+    }
+}
+
+void Portfolio::run_opt() {
+    vector<Config> queue(configs);
+    bool out_of_time = false;
+    while (true) {
+        while (!out_of_time && !queue.empty() &&
+               static_cast<int>(running_jobs.size()) < num_jobs) {
+            if (!start_search(0, queue))
+                out_of_time = true;
+        }
+        if (running_jobs.empty())
+            break;
+        Job job;
+        int exitcode = wait_for_search(job);
+        exitcodes.push_back(exitcode);
+        if (exitcode == EXIT_PLAN_FOUND || exitcode == EXIT_UNSOLVABLE) {
+            stop_searches();
+            break;
+        }
+    }
+}
+
+int Portfolio::generate_exitcode() const {
+    cout << "Exit codes: " << exitcodes << endl;
+    set<int> codes(exitcodes.begin(), exitcodes.end());
+    if (codes.erase(-SIGXCPU))
+        codes.insert(EXIT_TIMEOUT);
+    for (set<int>::const_iterator it = codes.begin(); it != codes.end(); ++it) {
+        int code = *it;
+        if (code != EXIT_PLAN_FOUND && code != EXIT_UNSOLVABLE &&
+            code != EXIT_UNSOLVED_INCOMPLETE && code != EXIT_OUT_OF_MEMORY &&
+            code != EXIT_TIMEOUT) {
+            cout << "Error: Unexpected exit code: " << code << endl;
+            return EXIT_CRITICAL_ERROR;
+        }
+    }
+    const int decisive_codes[] = {
+        EXIT_PLAN_FOUND, EXIT_UNSOLVABLE, EXIT_UNSOLVED_INCOMPLETE
+    };
+    for (int i = 0; i < 3; ++i) {
+        if (codes.count(decisive_codes[i]))
+            return decisive_codes[i];
+    }
+    if (codes.size() == 1 && codes.count(EXIT_OUT_OF_MEMORY))
+        return EXIT_OUT_OF_MEMORY;
+    if (codes.size() == 1 && codes.count(EXIT_TIMEOUT))
+        return EXIT_TIMEOUT;
+    if (codes.size() == 2)
+        return EXIT_TIMEOUT_AND_MEMORY;
+    cout << "Error: Unhandled exit codes: " << exitcodes << endl;
+    return EXIT_CRITICAL_ERROR;
+}
+
+int Portfolio::run() {
+    remove(PLAN_NUMBERS_FILE);
+    cout << "remaining time at start: " << remaining_time_at_start << endl;
+    if (num_jobs > 1) {
+        cout << "running " << num_jobs << " configs in parallel" << endl;
+        g_shared_plan_bound = new SharedPlanBound(!optimal);
+    }
+    if (optimal)
+        run_opt();
+    else
+        run_sat();
+    return generate_exitcode();
+}
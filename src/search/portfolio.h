@@ -0,0 +1,143 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+class Heuristic;
+class LandmarkGraph;
+
+/*
+  Runs a portfolio of planner configurations like the portfolio scripts
+  (downward-seq-*.py with portfolio.py), but in a single invocation of
+  the planner ("--portfolio PORTFOLIO_FILE").
+
+  The task is read only once, by the portfolio process. Every
+  configuration is run in a child process forked from it, so that the
+  configurations share the task, the successor generator, the causal
+  graph and the DTGs without copying them, and all memory used by a
+  configuration is released when it ends. Predefined heuristics and
+  landmark graphs that occur in more than one configuration (with the
+  same definition, and referring to the same predefinitions) are
+  constructed only once: by the portfolio process, before it starts the
+  first configuration that uses them. Shared heuristics are initialized
+  there as well (see Heuristic::ensure_initialized), since otherwise
+  every configuration would compute their precomputed data again.
+
+  Time slices, the switch from unit costs to real costs, plan numbering
+  and the cost bounds for satisficing portfolios work as in
+  portfolio.py.
+
+  With "--jobs N", up to N configurations run at the same time. Every
+  configuration still gets its time slice of CPU time: a configuration
+  is started with its share of the time that is neither used nor
+  reserved for the running configurations, so the portfolio uses at
+  most the same CPU time as with one job, and the memory limit is
+  divided among the jobs. The cost of the best plan found so far is
+  kept in shared memory (see SharedPlanBound), so that running searches
+  prune with it as soon as another configuration has found a plan, and
+  new configurations start with it as their bound. An optimal portfolio
+  stops all configurations when one of them finds a plan.
+
+  The portfolio file is written by portfolio.py:
+
+  begin_portfolio
+  <optimal|satisficing>
+  <remaining time in seconds>
+  <number of configurations>
+  <configurations>
+  <1 if there is a final configuration, 0 otherwise>
+  <final configuration, if any>
+  end_portfolio
+
+  where each configuration is written as
+
+  begin_config
+  <relative time>
+  <number of arguments>
+  <one argument per line>
+  end_config
+*/
+
+// Runs the search for the given planner arguments; must not return.
+typedef void (*ConfigurationRunner)(int argc, const char **argv);
+
+class Portfolio {
+    struct Config {
+        int relative_time;
+        std::vector<std::string> args;
+        // Reruns of successful configs with real costs are not repeated.
+        bool is_rerun;
+    };
+
+    // A config that runs in a child process.
+    struct Job {
+        Config config;
+        double timeout;
+    };
+
+    // A predefinition ("--heuristic" or "--landmarks") of a configuration.
+    struct Predefinition {
+        // Position of the definition in the arguments.
+        int arg_index;
+        bool is_landmark_graph;
+        std::vector<std::string> names;
+        // Equal for predefinitions that define the same objects.
+        std::string key;
+    };
+
+    // A predefinition that has been constructed by the portfolio process.
+    struct SharedPredefinition {
+        std::vector<Heuristic *> heuristics;
+        LandmarkGraph *landmark_graph;
+    };
+
+    bool optimal;
+    double remaining_time_at_start;
+    std::vector<Config> configs;
+    bool has_final_config;
+    Config final_config;
+    std::string plan_file;
+    int num_jobs;
+    ConfigurationRunner run_configuration;
+
+    // Substituted for H_COST_TYPE (satisficing portfolios only).
+    int heuristic_cost_type;
+    std::map<std::string, SharedPredefinition> shared_predefinitions;
+    std::vector<int> exitcodes;
+    std::map<pid_t, Job> running_jobs;
+
+    Config read_config(std::istream &in) const;
+    void read_portfolio(const std::string &filename);
+
+    std::vector<Predefinition> get_predefinitions(
+        const std::vector<std::string> &args, const std::string &config_id) const;
+    void predefine(const Predefinition &predefinition,
+                   const SharedPredefinition &shared) const;
+    void construct_shared_predefinitions(const std::vector<std::string> &args);
+    void use_shared_predefinitions(std::vector<std::string> &args) const;
+
+    double determine_timeout(const std::vector<Config> &queue) const;
+    std::string adapt_search(std::vector<std::string> &args,
+                             int search_cost_type) const;
+    // Starts the first config of the queue and removes it from the queue.
+    // Returns false if there is no time left.
+    bool start_search(int search_cost_type, std::vector<Config> &queue);
+    int wait_for_search(Job &job);
+    void stop_searches();
+    void run_sat();
+    void run_opt();
+    int generate_exitcode() const;
+public:
+    Portfolio(const std::string &filename, const std::string &plan_file,
+              int num_jobs, ConfigurationRunner run_configuration);
+    ~Portfolio();
+
+    // Returns the exit code of the planner (see portfolio.py).
+    int run();
+};
+
+#endif
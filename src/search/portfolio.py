@@ -18,6 +18,8 @@ DEFAULT_TIMEOUT = 1800
 # the "downward" wrapper script. In order not to reach the external memory limit
 # during a planner run, we don't allow the planner to use the reserved memory.
 BYTES_FOR_PYTHON = 50 * 1024 * 1024
+# Configurations for the planner's native portfolio mode.
+PORTFOLIO_FILE = "portfolio_configs"
 
 # Exit codes.
 EXIT_PLAN_FOUND = 0
@@ -40,6 +42,13 @@ def parse_args():
     parser = optparse.OptionParser()
     parser.add_option("--plan-file", default="sas_plan",
                       help="Filename for the found plans (default: %default)")
+    parser.add_option("--separate-processes", action="store_true",
+                      help="Run each configuration in a separate planner "
+                      "process that reads the task again (default: run the "
+                      "whole portfolio in one planner process)")
+    parser.add_option("--jobs", type="int", default=1,
+                      help="Number of configurations that the planner runs "
+                      "at the same time (default: %default)")
     return parser.parse_args()
 
 def safe_unlink(filename):
@@ -206,6 +215,15 @@ def run(configs, optimal=True, final_config=None, final_config_builder=None,
 
     print "remaining time at start: %s" % remaining_time_at_start
 
+    # The native portfolio mode cannot call final_config_builder.
+    if not options.separate_processes and final_config_builder is None:
+        sys.exit(run_native(configs, optimal, final_config, planner,
+                            sas_file, plan_file, remaining_time_at_start,
+                            memory, options.jobs))
+    if options.jobs != 1:
+        sys.exit("Error: Parallel portfolios need the planner's native "
+                 "portfolio mode.")
+
     if optimal:
         exitcodes = run_opt(configs, planner, sas_file, plan_file,
                             remaining_time_at_start, memory)
@@ -215,6 +233,46 @@ def run(configs, optimal=True, final_config=None, final_config_builder=None,
                             remaining_time_at_start, memory)
     sys.exit(_generate_exitcode(exitcodes))
 
+def _write_portfolio_file(filename, configs, optimal, final_config,
+                          remaining_time):
+    # See portfolio.h for the format.
+    def write_config(outfile, relative_time, args):
+        outfile.write("begin_config\n%d\n%d\n" % (relative_time, len(args)))
+        for arg in args:
+            outfile.write(arg.replace("\n", " ") + "\n")
+        outfile.write("end_config\n")
+
+    with open(filename, "w") as outfile:
+        outfile.write("begin_portfolio\n")
+        outfile.write("%s\n" % ("optimal" if optimal else "satisficing"))
+        outfile.write("%r\n" % remaining_time)
+        outfile.write("%d\n" % len(configs))
+        for relative_time, args in configs:
+            write_config(outfile, relative_time, args)
+        if final_config:
+            outfile.write("1\n")
+            write_config(outfile, 1, final_config)
+        else:
+            outfile.write("0\n")
+        outfile.write("end_portfolio\n")
+
+def run_native(configs, optimal, final_config, planner, sas_file, plan_file,
+               remaining_time_at_start, memory, jobs):
+    """Run the portfolio in a single planner process that reads the task
+    only once and runs the configurations itself (with the same time slices,
+    cost types and bounds as run_opt and run_sat)."""
+    remaining_time = remaining_time_at_start - sum(os.times()[:4])
+    _write_portfolio_file(PORTFOLIO_FILE, configs, optimal, final_config,
+                          remaining_time)
+    returncode = run_search(planner,
+                            ["--portfolio", PORTFOLIO_FILE, "--jobs", str(jobs)],
+                            sas_file, plan_file, memory=memory)
+    safe_unlink(PORTFOLIO_FILE)
+    if returncode < 0:
+        print "Error: planner terminated by signal", -returncode
+        return EXIT_CRITICAL_ERROR
+    return returncode
+
 def _can_change_cost_type(args):
     return any('S_COST_TYPE' in part or 'H_COST_TYPE' in part for part in args)
 
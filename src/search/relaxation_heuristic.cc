@@ -4,6 +4,7 @@
 #include "operator.h"
 #include "state.h"
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 using namespace std;
@@ -21,94 +22,166 @@ RelaxationHeuristic::~RelaxationHeuristic() {
 
 // initialization
 void RelaxationHeuristic::initialize() {
-    // Build propositions.
-    int prop_id = 0;
-    propositions.resize(g_variable_domain.size());
+    RelaxedTask *relaxed_task = new RelaxedTask;
+    task.reset(relaxed_task);
+
+    // Number propositions.
+    int num_propositions = 0;
     for (int var = 0; var < g_variable_domain.size(); var++) {
-        for (int value = 0; value < g_variable_domain[var]; value++)
-            propositions[var].push_back(Proposition(prop_id++));
+        relaxed_task->proposition_offsets.push_back(num_propositions);
+        num_propositions += g_variable_domain[var];
     }
 
     // Build goal propositions.
+    relaxed_task->is_goal.resize(num_propositions, false);
     for (int i = 0; i < g_goal.size(); i++) {
-        int var = g_goal[i].first, val = g_goal[i].second;
-        propositions[var][val].is_goal = true;
-        goal_propositions.push_back(&propositions[var][val]);
+        int prop = get_proposition(g_goal[i].first, g_goal[i].second);
+        relaxed_task->is_goal[prop] = true;
+        relaxed_task->goal_propositions.push_back(prop);
     }
 
-    // Build unary operators for operators and axioms.
+    // Build unary operators for operators and axioms. Reserve space for
+    // all of them, so that their preconditions are not copied when
+    // unary_operators grows.
+    Arena build_arena;
+    vector<UnaryOperator> unary_operators;
+    int max_num_unary_operators = 0;
+    for (int i = 0; i < g_operators.size(); i++)
+        max_num_unary_operators += g_operators[i].get_pre_post().size();
+    for (int i = 0; i < g_axioms.size(); i++)
+        max_num_unary_operators += g_axioms[i].get_pre_post().size();
+    unary_operators.reserve(max_num_unary_operators);
     for (int i = 0; i < g_operators.size(); i++)
-        build_unary_operators(g_operators[i], i);
+        build_unary_operators(g_operators[i], i, unary_operators, build_arena);
     for (int i = 0; i < g_axioms.size(); i++)
-        build_unary_operators(g_axioms[i], -1);
+        build_unary_operators(g_axioms[i], -1, unary_operators, build_arena);
 
     // Simplify unary operators.
-    simplify();
+    simplify(unary_operators, build_arena);
 
-    // Cross-reference unary operators.
-    for (int i = 0; i < unary_operators.size(); i++) {
-        UnaryOperator *op = &unary_operators[i];
-        for (int j = 0; j < op->precondition.size(); j++)
-            op->precondition[j]->precondition_of.push_back(op);
+    // Store unary operators.
+    int num_unary_operators = unary_operators.size();
+    int num_preconditions_total = 0;
+    for (int i = 0; i < num_unary_operators; i++)
+        num_preconditions_total += unary_operators[i].precondition.size();
+    relaxed_task->preconditions.reserve(num_preconditions_total);
+    relaxed_task->precondition_start.reserve(num_unary_operators + 1);
+    relaxed_task->num_preconditions.reserve(num_unary_operators);
+    relaxed_task->effect.reserve(num_unary_operators);
+    relaxed_task->base_cost.reserve(num_unary_operators);
+    relaxed_task->operator_no.reserve(num_unary_operators);
+    for (int i = 0; i < num_unary_operators; i++) {
+        const UnaryOperator &op = unary_operators[i];
+        relaxed_task->precondition_start.push_back(
+            relaxed_task->preconditions.size());
+        relaxed_task->preconditions.insert(relaxed_task->preconditions.end(),
+                                           op.precondition.begin(),
+                                           op.precondition.end());
+        relaxed_task->num_preconditions.push_back(op.precondition.size());
+        relaxed_task->effect.push_back(op.effect);
+        relaxed_task->base_cost.push_back(op.base_cost);
+        relaxed_task->operator_no.push_back(op.operator_no);
+        if (op.precondition.empty())
+            relaxed_task->operators_without_preconditions.push_back(i);
     }
+    relaxed_task->precondition_start.push_back(
+        relaxed_task->preconditions.size());
+
+    // Cross-reference unary operators, keeping them in ascending order
+    // for every proposition.
+    relaxed_task->precondition_of_start.resize(num_propositions + 1, 0);
+    const vector<int> &preconditions = relaxed_task->preconditions;
+    const vector<int> &precondition_start = relaxed_task->precondition_start;
+    vector<int> &precondition_of_start = relaxed_task->precondition_of_start;
+    for (int i = 0; i < preconditions.size(); i++)
+        ++precondition_of_start[preconditions[i] + 1];
+    for (int prop = 0; prop < num_propositions; prop++)
+        precondition_of_start[prop + 1] += precondition_of_start[prop];
+    relaxed_task->precondition_of.resize(preconditions.size());
+    vector<int> next_entry(precondition_of_start.begin(),
+                           precondition_of_start.end() - 1);
+    for (int op = 0; op < num_unary_operators; op++) {
+        for (int i = precondition_start[op]; i < precondition_start[op + 1]; i++)
+            relaxed_task->precondition_of[next_entry[preconditions[i]]++] = op;
+    }
+
+    // Collect achievers in the same way.
+    const vector<int> &effect = relaxed_task->effect;
+    vector<int> &achievers_start = relaxed_task->achievers_start;
+    achievers_start.resize(num_propositions + 1, 0);
+    for (int op = 0; op < num_unary_operators; op++)
+        ++achievers_start[effect[op] + 1];
+    for (int prop = 0; prop < num_propositions; prop++)
+        achievers_start[prop + 1] += achievers_start[prop];
+    relaxed_task->achievers.resize(num_unary_operators);
+    next_entry.assign(achievers_start.begin(), achievers_start.end() - 1);
+    for (int op = 0; op < num_unary_operators; op++)
+        relaxed_task->achievers[next_entry[effect[op]]++] = op;
+
+    proposition_cost.resize(num_propositions, -1);
+    reached_by.resize(num_propositions, NO_OPERATOR);
+    unsatisfied_preconditions.resize(num_unary_operators);
+    operator_cost.resize(num_unary_operators);
 }
 
-void RelaxationHeuristic::build_unary_operators(const Operator &op, int op_no) {
-    int base_cost = get_adjusted_cost(op);
+void RelaxationHeuristic::build_unary_operators(
+    const Operator &op, int op_no, vector<UnaryOperator> &unary_operators,
+    Arena &arena) {
+    int op_cost = get_adjusted_cost(op);
     const vector<Prevail> &prevail = op.get_prevail();
     const vector<PrePost> &pre_post = op.get_pre_post();
-    vector<Proposition *> precondition;
+    vector<int> precondition;
     for (int i = 0; i < prevail.size(); i++) {
         assert(prevail[i].var >= 0 && prevail[i].var < g_variable_domain.size());
         assert(prevail[i].prev >= 0 && prevail[i].prev < g_variable_domain[prevail[i].var]);
-        precondition.push_back(&propositions[prevail[i].var][prevail[i].prev]);
+        precondition.push_back(get_proposition(prevail[i].var, prevail[i].prev));
     }
     for (int i = 0; i < pre_post.size(); i++) {
         if (pre_post[i].pre != -1) {
             assert(pre_post[i].var >= 0 && pre_post[i].var < g_variable_domain.size());
             assert(pre_post[i].pre >= 0 && pre_post[i].pre < g_variable_domain[pre_post[i].var]);
-            precondition.push_back(&propositions[pre_post[i].var][pre_post[i].pre]);
+            precondition.push_back(get_proposition(pre_post[i].var, pre_post[i].pre));
         }
     }
     for (int i = 0; i < pre_post.size(); i++) {
         assert(pre_post[i].var >= 0 && pre_post[i].var < g_variable_domain.size());
         assert(pre_post[i].post >= 0 && pre_post[i].post < g_variable_domain[pre_post[i].var]);
-        Proposition *effect = &propositions[pre_post[i].var][pre_post[i].post];
+        int eff = get_proposition(pre_post[i].var, pre_post[i].post);
         const vector<Prevail> &eff_cond = pre_post[i].cond;
         for (int j = 0; j < eff_cond.size(); j++) {
             assert(eff_cond[j].var >= 0 && eff_cond[j].var < g_variable_domain.size());
             assert(eff_cond[j].prev >= 0 && eff_cond[j].prev < g_variable_domain[eff_cond[j].var]);
-            precondition.push_back(&propositions[eff_cond[j].var][eff_cond[j].prev]);
+            precondition.push_back(get_proposition(eff_cond[j].var, eff_cond[j].prev));
         }
-        unary_operators.push_back(UnaryOperator(precondition, effect, op_no, base_cost));
+        unary_operators.push_back(UnaryOperator(eff, op_no, op_cost, arena));
+        unary_operators.back().precondition.assign(precondition.begin(),
+                                                   precondition.end());
         precondition.erase(precondition.end() - eff_cond.size(), precondition.end());
     }
 }
 
+void RelaxationHeuristic::reset_exploration() {
+    fill(proposition_cost.begin(), proposition_cost.end(), -1);
+    // Plain copies: the sizes are equal, so nothing is reallocated.
+    unsatisfied_preconditions = task->num_preconditions;
+    operator_cost = task->base_cost;
+}
+
 class hash_unary_operator {
 public:
-    size_t operator()(const pair<vector<Proposition *>, Proposition *> &key) const {
-        // NOTE: We used to hash the Proposition* values directly, but
-        // this had the disadvantage that the results were not
-        // reproducible. This propagates through to the heuristic
-        // computation: runs on different computers could lead to
-        // different initial h values, for example.
-
-        unsigned long hash_value = key.second->id;
-        const vector<Proposition *> &vec = key.first;
+    template<class Condition>
+    size_t operator()(const pair<Condition, int> &key) const {
+        unsigned long hash_value = key.second;
+        const Condition &vec = key.first;
         for (int i = 0; i < vec.size(); i++)
-            hash_value = 17 * hash_value + vec[i]->id;
+            hash_value = 17 * hash_value + vec[i];
         return size_t(hash_value);
     }
 };
 
 
-static bool compare_prop_pointer(const Proposition *p1, const Proposition *p2) {
-    return p1->id < p2->id;
-}
-
-
-void RelaxationHeuristic::simplify() {
+void RelaxationHeuristic::simplify(vector<UnaryOperator> &unary_operators,
+                                   Arena &arena) {
     // Remove duplicate or dominated unary operators.
 
     /*
@@ -127,14 +200,16 @@ void RelaxationHeuristic::simplify() {
 
     cout << "Simplifying " << unary_operators.size() << " unary operators..." << flush;
 
-    typedef pair<vector<Proposition *>, Proposition *> HashKey;
-    typedef hash_map<HashKey, int, hash_unary_operator> HashMap;
-    HashMap unary_operator_index;
-    unary_operator_index.resize(unary_operators.size() * 2);
+    typedef pair<Condition, int> HashKey;
+    typedef hash_map<HashKey, int, hash_unary_operator, equal_to<HashKey>,
+                     ArenaAllocator<int> > HashMap;
+    HashMap unary_operator_index(unary_operators.size() * 2,
+                                 hash_unary_operator(), equal_to<HashKey>(),
+                                 ArenaAllocator<int>(&arena));
 
     for (int i = 0; i < unary_operators.size(); i++) {
         UnaryOperator &op = unary_operators[i];
-        sort(op.precondition.begin(), op.precondition.end(), compare_prop_pointer);
+        sort(op.precondition.begin(), op.precondition.end());
         HashKey key(op.precondition, op.effect);
         pair<HashMap::iterator, bool> inserted = unary_operator_index.insert(
             make_pair(key, i));
@@ -153,6 +228,7 @@ void RelaxationHeuristic::simplify() {
 
     vector<UnaryOperator> old_unary_operators;
     old_unary_operators.swap(unary_operators);
+    unary_operators.reserve(old_unary_operators.size());
 
     for (HashMap::iterator it = unary_operator_index.begin();
          it != unary_operator_index.end(); ++it) {
@@ -162,7 +238,8 @@ void RelaxationHeuristic::simplify() {
         bool match = false;
         if (powerset_size <= 31) { // HACK! Don't spend too much time here...
             for (int mask = 0; mask < powerset_size; mask++) {
-                HashKey dominating_key = make_pair(vector<Proposition *>(), key.second);
+                HashKey dominating_key = make_pair(
+                    Condition(ArenaAllocator<int>(&arena)), key.second);
                 for (int i = 0; i < key.first.size(); i++)
                     if (mask & (1 << i))
                         dominating_key.first.push_back(key.first[i]);
@@ -1,56 +1,99 @@
 #ifndef RELAXATION_HEURISTIC_H
 #define RELAXATION_HEURISTIC_H
 
+#include "arena_allocator.h"
 #include "heuristic.h"
 
+#include <tr1/memory>
 #include <vector>
 
 class Operator;
 class State;
 
-class Proposition;
-class UnaryOperator;
-
-struct UnaryOperator {
-    int operator_no; // -1 for axioms; index into g_operators otherwise
-    std::vector<Proposition *> precondition;
-    Proposition *effect;
-    int base_cost;
-
-    int unsatisfied_preconditions;
-    int cost; // Used for h^max cost or h^add cost;
-              // includes operator cost (base_cost)
-    UnaryOperator(const std::vector<Proposition *> &pre, Proposition *eff,
-                  int operator_no_, int base)
-        : operator_no(operator_no_), precondition(pre), effect(eff),
-          base_cost(base) {}
-};
-
-struct Proposition {
-    bool is_goal;
-    int id;
-    std::vector<UnaryOperator *> precondition_of;
-
-    int cost; // Used for h^max cost or h^add cost
-    UnaryOperator *reached_by;
-    bool marked; // used when computing preferred operators for h^add and h^FF
-
-    Proposition(int id_) {
-        id = id_;
-        is_goal = false;
-        cost = -1;
-        reached_by = 0;
-        marked = false;
-    }
-};
+/*
+  Base class of h^add, h^FF and h^max, which explore the relaxed task
+  consisting of one proposition for every fact and one unary operator
+  for every effect of every operator and axiom.
 
+  The relaxed task is stored in flat arrays indexed by proposition and
+  unary operator numbers instead of objects that point to each other:
+  the adjacency lists (preconditions of each unary operator, unary
+  operators triggered by each proposition) are stored consecutively in
+  one array each ("compressed sparse row" format), where the entries of
+  item i are those in [start[i], start[i + 1]). The data of the
+  exploration is stored in separate arrays that are reset with one
+  pass over each array per evaluation (see reset_exploration), so thread
+  clones share the relaxed task and only copy these arrays.
+*/
 class RelaxationHeuristic : public Heuristic {
-    void build_unary_operators(const Operator &op, int operator_no);
-    void simplify();
+    /*
+      Only used while building the relaxed task. The preconditions (and
+      the hash table of simplify) are allocated in an arena that is
+      released when the relaxed task has been built.
+    */
+    typedef std::vector<int, ArenaAllocator<int> > Condition;
+    struct UnaryOperator {
+        int operator_no;
+        Condition precondition;
+        int effect;
+        int base_cost;
+        // The precondition is filled after the operator has been stored.
+        UnaryOperator(int eff, int operator_no_, int base, Arena &arena)
+            : operator_no(operator_no_),
+              precondition(ArenaAllocator<int>(&arena)), effect(eff),
+              base_cost(base) {}
+    };
+
+    void build_unary_operators(const Operator &op, int operator_no,
+                               std::vector<UnaryOperator> &unary_operators,
+                               Arena &arena);
+    void simplify(std::vector<UnaryOperator> &unary_operators, Arena &arena);
 protected:
-    std::vector<UnaryOperator> unary_operators;
-    std::vector<std::vector<Proposition> > propositions;
-    std::vector<Proposition *> goal_propositions;
+    enum {NO_OPERATOR = -1};
+
+    /*
+      The relaxed task, which is built by initialize and only read
+      afterwards, so that it is shared by the heuristic and its thread
+      clones. Each clone has its own data of the exploration.
+    */
+    struct RelaxedTask {
+        // Proposition var=value has number proposition_offsets[var] + value.
+        std::vector<int> proposition_offsets;
+        std::vector<bool> is_goal;
+        std::vector<int> goal_propositions;
+        std::vector<int> precondition_of_start;
+        std::vector<int> precondition_of;
+        // Unary operators with the proposition as effect.
+        std::vector<int> achievers_start;
+        std::vector<int> achievers;
+
+        std::vector<int> precondition_start;
+        std::vector<int> preconditions;
+        std::vector<int> num_preconditions;
+        std::vector<int> effect;
+        std::vector<int> base_cost;
+        // Index into g_operators; -1 for axioms.
+        std::vector<int> operator_no;
+        std::vector<int> operators_without_preconditions;
+    };
+    std::tr1::shared_ptr<const RelaxedTask> task;
+
+    // Data of the exploration.
+    std::vector<int> proposition_cost; // -1 for unreached propositions
+    // Valid for reached propositions; NO_OPERATOR for the initial ones.
+    std::vector<int> reached_by;
+    std::vector<int> unsatisfied_preconditions;
+    std::vector<int> operator_cost; // includes base_cost
+
+    int get_proposition(int var, int value) const {
+        return task->proposition_offsets[var] + value;
+    }
+    int get_num_propositions() const {return task->is_goal.size(); }
+    int get_num_unary_operators() const {return task->effect.size(); }
+
+    // Marks all propositions as unreached and all preconditions as
+    // unsatisfied, and sets the cost of each unary operator to its base cost.
+    void reset_exploration();
 
     virtual void initialize();
     virtual int compute_heuristic(const State &state) = 0;
@@ -1,12 +1,15 @@
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <limits>
 using namespace std;
 
 #include "globals.h"
+#include "heuristic.h"
 #include "operator_cost.h"
 #include "option_parser.h"
 #include "search_engine.h"
+#include "shared_plan_bound.h"
 #include "timer.h"
 
 SearchEngine::SearchEngine(const Options &opts)
@@ -18,6 +21,16 @@ SearchEngine::SearchEngine(const Options &opts)
         exit_with(EXIT_INPUT_ERROR);
     }
     bound = opts.get<int>("bound");
+    if (opts.contains("bound_pruning")) {
+        bound_heuristics = opts.get_list<Heuristic *>("bound_pruning");
+        for (size_t i = 0; i < bound_heuristics.size(); ++i) {
+            if (bound_heuristics[i]->get_cost_type() != NORMAL) {
+                cerr << "error: heuristics for bound pruning must use "
+                     << "the real operator costs (cost_type=normal)" << endl;
+                exit_with(EXIT_INPUT_ERROR);
+            }
+        }
+    }
 }
 
 SearchEngine::~SearchEngine() {
@@ -43,8 +56,11 @@ void SearchEngine::set_plan(const Plan &p) {
 void SearchEngine::search() {
     initialize();
     Timer timer;
-    while (step() == IN_PROGRESS)
-        ;
+    while (step() == IN_PROGRESS) {
+        // Prune with the plans of the other configurations of a portfolio.
+        if (g_shared_plan_bound)
+            bound = min(bound, g_shared_plan_bound->get_best_plan_cost());
+    }
     cout << "Actual search time: " << timer
          << " [t=" << g_timer << "]" << endl;
 }
@@ -69,6 +85,19 @@ int SearchEngine::get_adjusted_cost(const Operator &op) const {
     return get_adjusted_action_cost(op, cost_type);
 }
 
+bool SearchEngine::exceeds_bound(int real_g) const {
+    for (size_t i = 0; i < bound_heuristics.size(); ++i) {
+        Heuristic *h = bound_heuristics[i];
+        if (h->is_dead_end()) {
+            if (h->dead_ends_are_reliable())
+                return true;
+        } else if (h->get_heuristic() >= bound - real_g) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void SearchEngine::add_options_to_parser(OptionParser &parser) {
     ::add_cost_type_option_to_parser(parser);
     parser.add_option<int>(
@@ -76,3 +105,16 @@ void SearchEngine::add_options_to_parser(OptionParser &parser) {
         "exclusive depth bound on g-values. Cutoffs are always performed according to "
         "the real cost, regardless of the cost_type parameter", "infinity");
 }
+
+void SearchEngine::add_bound_pruning_option(OptionParser &parser) {
+    parser.add_list_option<Heuristic *>(
+        "bound_pruning",
+        "prune states whose real g-value plus the estimate of one of these "
+        "heuristics reaches the bound. The bound is tightened whenever "
+        "a better plan is found, also by an earlier phase of an iterated "
+        "search or by another configuration of a parallel portfolio, "
+        "so states are pruned by it as soon as they are evaluated or "
+        "expanded. The heuristics must be admissible and use the real "
+        "operator costs (cost_type=normal).",
+        "[]");
+}
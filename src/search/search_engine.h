@@ -23,6 +23,14 @@ protected:
     SearchProgress search_progress;
     int bound;
     OperatorCost cost_type;
+    /*
+      Admissible heuristics for the real operator costs with which states
+      are pruned if their real g-value plus the estimate reaches the bound
+      ("bound_pruning" option of eager and lazy search). The bound can
+      decrease during the search (see search()), so this also prunes
+      states that were generated before a better plan was found.
+    */
+    std::vector<Heuristic *> bound_heuristics;
 
     enum {FAILED, SOLVED, IN_PROGRESS};
     virtual void initialize() {}
@@ -31,6 +39,8 @@ protected:
     void set_plan(const Plan &plan);
     bool check_goal_and_set_plan(const State &state);
     int get_adjusted_cost(const Operator &op) const;
+    // The bound heuristics must have been evaluated for the state.
+    bool exceeds_bound(int real_g) const;
 public:
     SearchEngine(const Options &opts);
     virtual ~SearchEngine();
@@ -44,6 +54,7 @@ public:
     void set_bound(int b) {bound = b; }
     int get_bound() {return bound; }
     static void add_options_to_parser(OptionParser &parser);
+    static void add_bound_pruning_option(OptionParser &parser);
 };
 
 #endif
@@ -2,30 +2,31 @@
 #define SEARCH_NODE_INFO_H
 
 #include "state_id.h"
-#include "operator.h"
-
-#include <vector>
 
 // For documentation on classes relevant to storing and working with registered
 // states see the file state_registry.h.
 
+/*
+  The data stored for every registered state (16 bytes). Data that
+  only some searches need (real path costs, path lengths and the
+  operator sequences of YAHSP2 lookahead nodes) is stored in separate
+  tables of the SearchSpace that are only filled when used.
+*/
 struct SearchNodeInfo {
     enum NodeStatus {NEW = 0, OPEN = 1, CLOSED = 2, DEAD_END = 3};
+    enum {NO_OPERATOR = -1};
 
     unsigned int status : 2;
     int g : 30;
     int h : 31; // TODO:CR - should we get rid of it
     bool h_is_dirty : 1;
     StateID parent_state_id;
-    const Operator *creating_operator;
-    std::vector<const Operator *> *steps;
-    int real_g;
-    int length;
+    // Index into g_operators.
+    int creating_operator;
 
     SearchNodeInfo()
         : status(NEW), g(-1), h(-1), h_is_dirty(false),
-          parent_state_id(StateID::no_state), creating_operator(0),
-          steps(0), real_g(-1), length(0) {
+          parent_state_id(StateID::no_state), creating_operator(NO_OPERATOR) {
     }
 };
 
@@ -12,6 +12,7 @@ SearchProgress::SearchProgress() {
     dead_end_states = 0;
     generated_ops = 0;
     pathmax_corrections = 0;
+    bound_pruned_states = 0;
 
     lastjump_expanded_states = 0;
     lastjump_reopened_states = 0;
@@ -115,6 +116,9 @@ void SearchProgress::print_statistics() const {
     if (pathmax_corrections > 0) {
         cout << "Pathmax corrections: " << pathmax_corrections << endl;
     }
+    if (bound_pruned_states > 0) {
+        cout << "Pruned by bound: " << bound_pruned_states << " state(s)." << endl;
+    }
 
     if (lastjump_f_value >= 0) {
         cout << "Expanded until last jump: "
@@ -22,6 +22,7 @@ private:
 
     int generated_ops;    // nr of operators that were returned as applicable
     int pathmax_corrections; // nr of pathmax corrections;
+    int bound_pruned_states; // nr states pruned because g + h reached the bound
 
     // f-statistics
     int lastjump_f_value; //f value obtained in the last jump
@@ -47,6 +48,7 @@ public:
     void inc_reopened(int inc = 1) {reopened_states += inc; }
     void inc_generated_ops(int inc = 1) {generated_ops += inc; }
     void inc_pathmax_corrections(int inc = 1) {pathmax_corrections += inc; }
+    void inc_bound_pruned(int inc = 1) {bound_pruned_states += inc; }
     void inc_evaluations(int inc = 1) {evaluations += inc; }
     void inc_dead_ends(int inc = 1) {dead_end_states += inc; }
 
@@ -58,6 +60,8 @@ public:
     int get_reopened() const {return reopened_states; }
     int get_generated_ops() const {return generated_ops; }
     int get_pathmax_corrections() const {return pathmax_corrections; }
+    int get_bound_pruned() const {return bound_pruned_states; }
+    int get_dead_ends() const {return dead_end_states; }
 
     // f-value
     void report_f_value(int f);
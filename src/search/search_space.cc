@@ -11,14 +11,14 @@ using namespace std;
 using namespace __gnu_cxx;
 
 
-SearchNode::SearchNode(StateID state_id_, SearchNodeInfo &info_,
-                       OperatorCost cost_type_)
-    : state_id(state_id_), info(info_), cost_type(cost_type_) {
+SearchNode::SearchNode(SearchSpace &search_space_, StateID state_id_,
+                       SearchNodeInfo &info_)
+    : search_space(search_space_), state_id(state_id_), info(info_) {
     assert(state_id != StateID::no_state);
 }
 
 State SearchNode::get_state() const {
-    return g_state_registry->lookup_state(state_id);
+    return search_space.state_registry.lookup_state(state_id);
 }
 
 bool SearchNode::is_open() const {
@@ -42,15 +42,26 @@ int SearchNode::get_g() const {
 }
 
 int SearchNode::get_real_g() const {
-    return info.real_g;
+    if (search_space.cost_type == NORMAL)
+        return info.g;
+    const SearchSpace &const_search_space = search_space;
+    return const_search_space.real_g_values[state_id];
 }
 
 int SearchNode::get_h() const {
     return info.h;
 }
 
-int SearchNode::get_length() {
-    return info.length;
+int SearchNode::get_length() const {
+    assert(search_space.tracks_lengths);
+    const SearchSpace &const_search_space = search_space;
+    return const_search_space.lengths[state_id];
+}
+
+const Operator *SearchNode::get_creating_operator() const {
+    if (info.creating_operator == SearchNodeInfo::NO_OPERATOR)
+        return 0;
+    return &g_operators[info.creating_operator];
 }
 
 bool SearchNode::is_h_dirty() const {
@@ -65,44 +76,68 @@ void SearchNode::clear_h_dirty() {
     info.h_is_dirty = false;
 }
 
+void SearchNode::set_path(int g, int real_g, int length,
+                          StateID parent_state_id, const Operator *parent_op) {
+    info.g = g;
+    if (search_space.cost_type != NORMAL)
+        search_space.real_g_values[state_id] = real_g;
+    else
+        assert(real_g == g);
+    if (search_space.tracks_lengths)
+        search_space.lengths[state_id] = length;
+    info.parent_state_id = parent_state_id;
+    if (parent_op)
+        info.creating_operator = parent_op - &*g_operators.begin();
+    else
+        info.creating_operator = SearchNodeInfo::NO_OPERATOR;
+    const SearchSpace &const_search_space = search_space;
+    if (const_search_space.steps[state_id]) {
+        delete search_space.steps[state_id];
+        search_space.steps[state_id] = 0;
+    }
+}
+
 void SearchNode::open_initial(int h) {
     assert(info.status == SearchNodeInfo::NEW);
     info.status = SearchNodeInfo::OPEN;
-    info.g = 0;
-    info.real_g = 0;
     info.h = h;
-    info.length = 0;
-    info.parent_state_id = StateID::no_state;
-    info.creating_operator = 0;
+    set_path(0, 0, 0, StateID::no_state, 0);
 }
 
 void SearchNode::open(int h, const SearchNode &parent_node,
                       const Operator *parent_op) {
     assert(info.status == SearchNodeInfo::NEW);
     info.status = SearchNodeInfo::OPEN;
-    info.length = parent_node.info.length + 1;
-    info.g = parent_node.info.g + get_adjusted_action_cost(*parent_op, cost_type);
-    info.real_g = parent_node.info.real_g + parent_op->get_cost();
     info.h = h;
-    info.parent_state_id = parent_node.get_state_id();
-    info.creating_operator = parent_op;
+    set_path(parent_node.get_g() + get_adjusted_action_cost(*parent_op, search_space.cost_type),
+             parent_node.get_real_g() + parent_op->get_cost(),
+             search_space.tracks_lengths ? parent_node.get_length() + 1 : 0,
+             parent_node.get_state_id(), parent_op);
+}
+
+void SearchNode::open(int h, int g, int real_g,
+                      StateID parent_state_id, const Operator *parent_op) {
+    assert(info.status == SearchNodeInfo::NEW);
+    assert(!search_space.tracks_lengths);
+    info.status = SearchNodeInfo::OPEN;
+    info.h = h;
+    set_path(g, real_g, 0, parent_state_id, parent_op);
 }
 
 // for YAHSP2
 void SearchNode::open(int h, const SearchNode &parent_node, vector<const Operator *> &steps) {
     assert(info.status == SearchNodeInfo::NEW);
     info.status = SearchNodeInfo::OPEN;
-    info.length = parent_node.info.length + steps.size();
     int plan_cost_adj = 0;
     for (int i = 0; i < steps.size(); i++) {
-        plan_cost_adj = plan_cost_adj + get_adjusted_action_cost(*steps[i], cost_type);
+        plan_cost_adj = plan_cost_adj + get_adjusted_action_cost(*steps[i], search_space.cost_type);
     }
-    info.g = parent_node.info.g + plan_cost_adj;
-    info.real_g = parent_node.info.real_g + calculate_plan_cost(steps);
     info.h = h;
-    info.parent_state_id = parent_node.get_state_id();
-    info.creating_operator = steps.back();
-    info.steps = new vector<const Operator *>(steps);
+    set_path(parent_node.get_g() + plan_cost_adj,
+             parent_node.get_real_g() + calculate_plan_cost(steps),
+             search_space.tracks_lengths ? parent_node.get_length() + steps.size() : 0,
+             parent_node.get_state_id(), steps.back());
+    search_space.steps[state_id] = new vector<const Operator *>(steps);
 }
 
 void SearchNode::reopen(const SearchNode &parent_node,
@@ -111,21 +146,30 @@ void SearchNode::reopen(const SearchNode &parent_node,
     info.status = SearchNodeInfo::OPEN;
 }
 
+void SearchNode::reopen(int g, int real_g,
+                        StateID parent_state_id, const Operator *parent_op) {
+    update_parent(g, real_g, parent_state_id, parent_op);
+    info.status = SearchNodeInfo::OPEN;
+}
+
 void SearchNode::update_parent(const SearchNode &parent_node,
                                const Operator *parent_op) {
     // The latter possibility is for inconsistent heuristics, which
     // may require reopening closed nodes.
     assert(info.status == SearchNodeInfo::OPEN ||
            info.status == SearchNodeInfo::CLOSED);
-    info.length = parent_node.info.length + 1;
-    info.g = parent_node.info.g + get_adjusted_action_cost(*parent_op, cost_type);
-    info.real_g = parent_node.info.real_g + parent_op->get_cost();
-    info.parent_state_id = parent_node.get_state_id();
-    info.creating_operator = parent_op;
-    if (info.steps) {
-        delete info.steps;
-        info.steps = 0;
-    }
+    set_path(parent_node.get_g() + get_adjusted_action_cost(*parent_op, search_space.cost_type),
+             parent_node.get_real_g() + parent_op->get_cost(),
+             search_space.tracks_lengths ? parent_node.get_length() + 1 : 0,
+             parent_node.get_state_id(), parent_op);
+}
+
+void SearchNode::update_parent(int g, int real_g,
+                               StateID parent_state_id, const Operator *parent_op) {
+    assert(info.status == SearchNodeInfo::OPEN ||
+           info.status == SearchNodeInfo::CLOSED);
+    assert(!search_space.tracks_lengths);
+    set_path(g, real_g, 0, parent_state_id, parent_op);
 }
 
 void SearchNode::increase_h(int h) {
@@ -144,9 +188,9 @@ void SearchNode::mark_as_dead_end() {
 
 void SearchNode::dump() const {
     cout << state_id << ": ";
-    g_state_registry->lookup_state(state_id).dump_fdr();
-    if (info.creating_operator) {
-        cout << " created by " << info.creating_operator->get_name()
+    search_space.state_registry.lookup_state(state_id).dump_fdr();
+    if (get_creating_operator()) {
+        cout << " created by " << get_creating_operator()->get_name()
              << " from " << info.parent_state_id << endl;
     } else {
         cout << " no parent" << endl;
@@ -154,11 +198,39 @@ void SearchNode::dump() const {
 }
 
 SearchSpace::SearchSpace(OperatorCost cost_type_)
-    : cost_type(cost_type_) {
+    : state_registry(*g_state_registry),
+      search_node_infos(SearchNodeInfo(), state_registry),
+      real_g_values(-1, state_registry),
+      lengths(0, state_registry),
+      steps(0, state_registry),
+      tracks_lengths(false),
+      cost_type(cost_type_) {
+}
+
+SearchSpace::SearchSpace(OperatorCost cost_type_, StateRegistry &state_registry_)
+    : state_registry(state_registry_),
+      search_node_infos(SearchNodeInfo(), state_registry),
+      real_g_values(-1, state_registry),
+      lengths(0, state_registry),
+      steps(0, state_registry),
+      tracks_lengths(false),
+      cost_type(cost_type_) {
+}
+
+SearchSpace::~SearchSpace() {
+    for (PerStateInformation<vector<const Operator *> *>::const_iterator it =
+             steps.begin(); it != steps.end(); ++it) {
+        const SearchSpace &const_search_space = *this;
+        delete const_search_space.steps[*it];
+    }
 }
 
 SearchNode SearchSpace::get_node(StateID id) {
-    return SearchNode(id, search_node_infos[id], cost_type);
+    return SearchNode(*this, id, search_node_infos[id]);
+}
+
+void SearchSpace::track_lengths() {
+    tracks_lengths = true;
 }
 
 void SearchSpace::trace_path(const State &goal_state,
@@ -167,12 +239,17 @@ void SearchSpace::trace_path(const State &goal_state,
     assert(path.empty());
     for (;;) {
         const SearchNodeInfo &info = search_node_infos[current_state_id];
-        const Operator *op = info.creating_operator;
-        if (op == 0) {
+        if (info.creating_operator == SearchNodeInfo::NO_OPERATOR) {
             assert(info.parent_state_id == StateID::no_state);
             break;
         }
-        path.push_back(op);
+        const vector<const Operator *> *node_steps = steps[current_state_id];
+        if (node_steps) {
+            // Node created by a sequence of operators (see YAHSP2).
+            path.insert(path.end(), node_steps->rbegin(), node_steps->rend());
+        } else {
+            path.push_back(&g_operators[info.creating_operator]);
+        }
         current_state_id = info.parent_state_id;
     }
     reverse(path.begin(), path.end());
@@ -184,9 +261,10 @@ void SearchSpace::dump() const {
         StateID id = *it;
         const SearchNodeInfo &node_info = search_node_infos[id];
         cout << id << ": ";
-        g_state_registry->lookup_state(id).dump_fdr();
-        if (node_info.creating_operator && node_info.parent_state_id != StateID::no_state) {
-            cout << " created by " << node_info.creating_operator->get_name()
+        state_registry.lookup_state(id).dump_fdr();
+        if (node_info.creating_operator != SearchNodeInfo::NO_OPERATOR &&
+            node_info.parent_state_id != StateID::no_state) {
+            cout << " created by " << g_operators[node_info.creating_operator].get_name()
                  << " from " << node_info.parent_state_id << endl;
         } else {
             cout << "has no parent" << endl;
@@ -195,5 +273,5 @@ void SearchSpace::dump() const {
 }
 
 void SearchSpace::statistics() const {
-    cout << "Number of registered states: " << g_state_registry->size() << endl;
+    cout << "Number of registered states: " << state_registry.size() << endl;
 }
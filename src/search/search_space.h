@@ -12,16 +12,21 @@
 #include <vector>
 
 class Operator;
+class SearchSpace;
 class State;
+class StateRegistry;
 
 
 class SearchNode {
+    SearchSpace &search_space;
     StateID state_id;
     SearchNodeInfo &info;
-    OperatorCost cost_type;
+
+    void set_path(int g, int real_g, int length,
+                  StateID parent_state_id, const Operator *parent_op);
 public:
-    SearchNode(StateID state_id_, SearchNodeInfo &info_,
-               OperatorCost cost_type_);
+    SearchNode(SearchSpace &search_space_, StateID state_id_,
+               SearchNodeInfo &info_);
 
     StateID get_state_id() const {
         return state_id;
@@ -40,11 +45,13 @@ public:
     int get_real_g() const;
     int get_h() const;
 
-    int get_length();
-    // TODO: Remove in favor of more fine-grained access to SearchNodeInfo?
-    const SearchNodeInfo &get_info() {
-        return info;
+    // Only available if the search space tracks lengths.
+    int get_length() const;
+    StateID get_parent_state_id() const {
+        return info.parent_state_id;
     }
+    // Returns 0 for the initial state.
+    const Operator *get_creating_operator() const;
 
     void open_initial(int h);
     void open(int h, const SearchNode &parent_node,
@@ -54,6 +61,18 @@ public:
                 const Operator *parent_op);
     void update_parent(const SearchNode &parent_node,
                        const Operator *parent_op);
+    /*
+      Variants of open, reopen and update_parent for searches where the
+      parent node may belong to a different search space (see HDASearch).
+      g and real_g are the costs of the new path to the node. They cannot
+      be used if the search space tracks lengths.
+    */
+    void open(int h, int g, int real_g,
+              StateID parent_state_id, const Operator *parent_op);
+    void reopen(int g, int real_g,
+                StateID parent_state_id, const Operator *parent_op);
+    void update_parent(int g, int real_g,
+                       StateID parent_state_id, const Operator *parent_op);
     void increase_h(int h);
     void close();
     void mark_as_dead_end();
@@ -63,12 +82,32 @@ public:
 
 
 class SearchSpace {
+    friend class SearchNode;
+
+    StateRegistry &state_registry;
     PerStateInformation<SearchNodeInfo> search_node_infos;
+    /*
+      The following tables are only filled when they are needed (see
+      PerStateInformation): real_g_values if the real costs differ from
+      g, i.e., if cost_type is not NORMAL, lengths if enabled with
+      track_lengths, and steps for the nodes created by
+      open(h, parent_node, steps).
+    */
+    PerStateInformation<int> real_g_values;
+    PerStateInformation<int> lengths;
+    PerStateInformation<std::vector<const Operator *> *> steps;
+    bool tracks_lengths;
 
     OperatorCost cost_type;
 public:
+    // Search spaces of the states in g_state_registry (the default) or
+    // in the given registry.
     SearchSpace(OperatorCost cost_type_);
+    SearchSpace(OperatorCost cost_type_, StateRegistry &state_registry_);
+    ~SearchSpace();
     SearchNode get_node(StateID id);
+    // Enables SearchNode::get_length. Must be called before opening nodes.
+    void track_lengths();
     void trace_path(const State &goal_state,
                     std::vector<const Operator *> &path) const;
 
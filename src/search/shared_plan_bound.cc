@@ -0,0 +1,54 @@
+#include "shared_plan_bound.h"
+
+#include "utilities.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <sys/mman.h>
+using namespace std;
+
+SharedPlanBound *g_shared_plan_bound = 0;
+
+SharedPlanBound::SharedPlanBound(bool number_plans_)
+    : number_plans(number_plans_) {
+    void *memory = mmap(0, sizeof(SharedData), PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        cerr << "Could not create shared memory: " << strerror(errno) << endl;
+        exit_with(EXIT_CRITICAL_ERROR);
+    }
+    data = static_cast<SharedData *>(memory);
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+    pthread_mutex_init(&data->lock, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+    data->best_plan_cost = numeric_limits<int>::max();
+    data->num_plans = 0;
+}
+
+SharedPlanBound::~SharedPlanBound() {
+    pthread_mutex_destroy(&data->lock);
+    munmap(data, sizeof(SharedData));
+}
+
+int SharedPlanBound::get_num_plans() const {
+    pthread_mutex_lock(&data->lock);
+    int num_plans = data->num_plans;
+    pthread_mutex_unlock(&data->lock);
+    return num_plans;
+}
+
+bool SharedPlanBound::register_plan(int plan_cost, int &plan_number) {
+    pthread_mutex_lock(&data->lock);
+    bool improved = plan_cost < data->best_plan_cost;
+    if (improved) {
+        data->best_plan_cost = plan_cost;
+        ++data->num_plans;
+        plan_number = number_plans ? data->num_plans : 0;
+    }
+    pthread_mutex_unlock(&data->lock);
+    return improved;
+}
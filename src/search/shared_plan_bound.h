@@ -0,0 +1,53 @@
+#ifndef SHARED_PLAN_BOUND_H
+#define SHARED_PLAN_BOUND_H
+
+#include <pthread.h>
+
+/*
+  The cost of the best plan found so far by the configurations of a
+  parallel portfolio (see Portfolio). It is stored in memory that the
+  portfolio process shares with the processes of all configurations, so
+  that a running search can prune with the cost of a plan found by
+  another configuration as soon as that plan has been saved.
+
+  Plans are only saved if they are better than all plans found before
+  (see save_plan). If plans are numbered, they are numbered in the order
+  in which they improved the best plan cost, so that the plan with the
+  highest number is the best one.
+
+  g_shared_plan_bound is created by the portfolio process before it starts
+  the configurations, and is 0 outside of parallel portfolios.
+*/
+class SharedPlanBound {
+    struct SharedData {
+        pthread_mutex_t lock;
+        int best_plan_cost;
+        int num_plans;
+    };
+    SharedData *data;
+    const bool number_plans;
+
+    // Not implemented.
+    SharedPlanBound(const SharedPlanBound &);
+    SharedPlanBound &operator=(const SharedPlanBound &);
+public:
+    explicit SharedPlanBound(bool number_plans);
+    ~SharedPlanBound();
+
+    // Cost of the best plan found so far, or "infinity" if there is none.
+    int get_best_plan_cost() const {
+        return *static_cast<volatile int *>(&data->best_plan_cost);
+    }
+    int get_num_plans() const;
+
+    /*
+      Returns false if the plan is not better than the best plan found so
+      far. Otherwise, records it as the best plan and sets plan_number to
+      its number (or 0 if plans are not numbered).
+    */
+    bool register_plan(int plan_cost, int &plan_number);
+};
+
+extern SharedPlanBound *g_shared_plan_bound;
+
+#endif
@@ -7,22 +7,25 @@
 class Operator;
 class StateRegistry;
 
+#include "int_packer.h"
 #include "state_id.h"
-#include "state_var_t.h"
 #include "globals.h"
 
+typedef IntPacker::Bin PackedStateBin;
+
 // For documentation on classes relevant to storing and working with registered
 // states see the file state_registry.h.
 class State {
     friend class StateRegistry;
-    // Values for vars. will later be converted to UnpackedStateData.
-    const state_var_t *vars;
+    friend class Operator;
+    // Packed values for vars, borrowed from the registry.
+    const PackedStateBin *buffer;
     StateID id;
     // Only used by the state registry.
-    explicit State(const state_var_t *buffer, StateID id_);
+    explicit State(const PackedStateBin *buffer_, StateID id_);
 
-    const state_var_t *get_buffer() const {
-        return vars;
+    const PackedStateBin *get_packed_buffer() const {
+        return buffer;
     }
 
     // No implementation to prevent default construction
@@ -35,7 +38,7 @@ public:
     }
 
     int operator[](int index) const {
-        return vars[index];
+        return g_state_packer->get(buffer, index);
     }
     void dump_pddl() const;
     void dump_fdr() const;
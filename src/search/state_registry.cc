@@ -1,17 +1,31 @@
 #include "state_registry.h"
 
 #include "axioms.h"
+#include "int_packer.h"
 #include "operator.h"
-#include "state_var_t.h"
+#include "rng.h"
+
+#include <algorithm>
+#include <iostream>
 
 using namespace std;
 
 StateRegistry::StateRegistry()
-    : state_data_pool(g_variable_domain.size()),
-      registered_states(0,
-                        StateIDSemanticHash(state_data_pool),
+    : axiom_evaluator(*g_axiom_evaluator),
+      state_data_pool(g_state_packer->get_num_bins()),
+      registered_states(StateIDSemanticHash(state_data_pool, state_hashes),
+                        StateIDSemanticEqual(state_data_pool)),
+      cached_initial_state(0),
+      use_incremental_hashing(false) {
+}
+
+StateRegistry::StateRegistry(AxiomEvaluator &axiom_evaluator_)
+    : axiom_evaluator(axiom_evaluator_),
+      state_data_pool(g_state_packer->get_num_bins()),
+      registered_states(StateIDSemanticHash(state_data_pool, state_hashes),
                         StateIDSemanticEqual(state_data_pool)),
-      cached_initial_state(0) {
+      cached_initial_state(0),
+      use_incremental_hashing(false) {
 }
 
 
@@ -19,6 +33,35 @@ StateRegistry::~StateRegistry() {
     delete cached_initial_state;
 }
 
+void StateRegistry::enable_incremental_hashing() {
+    if (use_incremental_hashing)
+        return;
+    if (size() != 0) {
+        cerr << "Incremental state hashing must be enabled before "
+             << "any state is registered." << endl;
+        exit_with(EXIT_CRITICAL_ERROR);
+    }
+    use_incremental_hashing = true;
+    // Use a private generator with a fixed seed, so that enabling
+    // incremental hashing does not change the random choices of the search.
+    RandomNumberGenerator rng(2014);
+    zobrist_keys.resize(g_variable_domain.size());
+    for (size_t var = 0; var < g_variable_domain.size(); ++var) {
+        zobrist_keys[var].resize(g_variable_domain[var]);
+        for (int value = 0; value < g_variable_domain[var]; ++value)
+            zobrist_keys[var][value] = rng.next32();
+        if (g_axiom_layers[var] != -1)
+            derived_variables.push_back(var);
+    }
+}
+
+unsigned int StateRegistry::compute_zobrist_hash(const PackedStateBin *buffer) const {
+    unsigned int hash = 0;
+    for (size_t var = 0; var < zobrist_keys.size(); ++var)
+        hash ^= zobrist_keys[var][g_state_packer->get(buffer, var)];
+    return hash;
+}
+
 StateID StateRegistry::insert_id_or_pop_state() {
     /*
       Attempt to insert a StateID for the last state of state_data_pool
@@ -26,14 +69,16 @@ StateID StateRegistry::insert_id_or_pop_state() {
       is present), we have to remove the duplicate entry from the
       state data pool.
     */
-    StateID id(state_data_pool.size() - 1);
-    pair<StateIDSet::iterator, bool> result = registered_states.insert(id);
+    int id = state_data_pool.size() - 1;
+    pair<int, bool> result = registered_states.insert(id);
     bool is_new_entry = result.second;
     if (!is_new_entry) {
         state_data_pool.pop_back();
+        if (use_incremental_hashing)
+            state_hashes.pop_back();
     }
     assert(registered_states.size() == state_data_pool.size());
-    return *result.first;
+    return StateID(result.first);
 }
 
 State StateRegistry::lookup_state(StateID id) const {
@@ -42,28 +87,92 @@ State StateRegistry::lookup_state(StateID id) const {
 
 const State &StateRegistry::get_initial_state() {
     if (cached_initial_state == 0) {
-        state_data_pool.push_back(g_initial_state_buffer);
-        state_var_t *vars = state_data_pool[state_data_pool.size() - 1];
-        g_axiom_evaluator->evaluate(vars);
-        StateID id = insert_id_or_pop_state();
-        cached_initial_state = new State(lookup_state(id));
+        PackedStateBin *buffer = new PackedStateBin[g_state_packer->get_num_bins()];
+        compute_initial_state_data(buffer);
+        State initial_state = register_state(buffer);
+        delete[] buffer;
+        cached_initial_state = new State(initial_state);
     }
     return *cached_initial_state;
 }
 
+void StateRegistry::compute_initial_state_data(PackedStateBin *buffer) {
+    // Bits of a bin that are not used by any variable must be zero,
+    // because hashing and comparing states works on whole bins.
+    fill_n(buffer, g_state_packer->get_num_bins(), 0);
+    for (size_t var = 0; var < g_variable_domain.size(); ++var) {
+        g_state_packer->set(buffer, var, g_initial_state_buffer[var]);
+    }
+    axiom_evaluator.evaluate(buffer);
+}
+
+void StateRegistry::apply_effects(const State &predecessor, const Operator &op,
+                                  PackedStateBin *buffer) const {
+    // buffer must contain a copy of the data of predecessor.
+    for (size_t i = 0; i < op.get_pre_post().size(); ++i) {
+        const PrePost &pre_post = op.get_pre_post()[i];
+        if (pre_post.does_fire(predecessor))
+            g_state_packer->set(buffer, pre_post.var, pre_post.post);
+    }
+}
+
+void StateRegistry::compute_successor_data(const State &predecessor,
+                                           const Operator &op,
+                                           PackedStateBin *buffer) {
+    assert(!op.is_axiom());
+    const PackedStateBin *predecessor_data = predecessor.get_packed_buffer();
+    copy(predecessor_data, predecessor_data + g_state_packer->get_num_bins(), buffer);
+    apply_effects(predecessor, op, buffer);
+    axiom_evaluator.evaluate(buffer);
+}
+
+State StateRegistry::register_state(const PackedStateBin *buffer) {
+    // buffer is copied by push_back
+    state_data_pool.push_back(buffer);
+    if (use_incremental_hashing)
+        state_hashes.push_back(compute_zobrist_hash(buffer));
+    StateID id = insert_id_or_pop_state();
+    return lookup_state(id);
+}
+
 //TODO it would be nice to move the actual state creation (and operator application)
 //     out of the StateRegistry. This could for example be done by global functions
-//     operating on state buffers (state_var_t *).
+//     operating on state buffers (PackedStateBin *).
 State StateRegistry::get_successor_state(const State &predecessor, const Operator &op) {
     assert(!op.is_axiom());
-    state_data_pool.push_back(predecessor.get_buffer());
-    state_var_t *vars = state_data_pool[state_data_pool.size() - 1];
-    for (size_t i = 0; i < op.get_pre_post().size(); ++i) {
-        const PrePost &pre_post = op.get_pre_post()[i];
-        if (pre_post.does_fire(predecessor))
-            vars[pre_post.var] = pre_post.post;
+    state_data_pool.push_back(predecessor.get_packed_buffer());
+    PackedStateBin *buffer = state_data_pool[state_data_pool.size() - 1];
+    if (!use_incremental_hashing) {
+        apply_effects(predecessor, op, buffer);
+        axiom_evaluator.evaluate(buffer);
+    } else {
+        unsigned int hash = state_hashes[predecessor.get_id().value];
+        for (size_t i = 0; i < op.get_pre_post().size(); ++i) {
+            const PrePost &pre_post = op.get_pre_post()[i];
+            if (pre_post.does_fire(predecessor)) {
+                // Read the old value from buffer rather than predecessor
+                // because several effects may change the same variable.
+                int var = pre_post.var;
+                int old_value = g_state_packer->get(buffer, var);
+                if (old_value != pre_post.post) {
+                    hash ^= zobrist_keys[var][old_value] ^ zobrist_keys[var][pre_post.post];
+                    g_state_packer->set(buffer, var, pre_post.post);
+                }
+            }
+        }
+        axiom_evaluator.evaluate(buffer);
+        // Operators never change derived variables, so their old values
+        // are those of the predecessor.
+        for (size_t i = 0; i < derived_variables.size(); ++i) {
+            int var = derived_variables[i];
+            int old_value = predecessor[var];
+            int new_value = g_state_packer->get(buffer, var);
+            if (old_value != new_value)
+                hash ^= zobrist_keys[var][old_value] ^ zobrist_keys[var][new_value];
+        }
+        assert(hash == compute_zobrist_hash(buffer));
+        state_hashes.push_back(hash);
     }
-    g_axiom_evaluator->evaluate(vars);
     StateID id = insert_id_or_pop_state();
     return lookup_state(id);
 }
@@ -2,20 +2,22 @@
 #define STATE_REGISTRY_H
 
 #include "globals.h"
+#include "int_hash_set.h"
+#include "int_packer.h"
 #include "segmented_vector.h"
 #include "state.h"
 #include "state_id.h"
-#include "state_var_t.h"
 #include "utilities.h"
 
-#include <hash_set>
+class AxiomEvaluator;
 
 /*
   Overview of classes relevant to storing and working with registered states.
 
   State
     This class is used for manipulating states.
-    It contains the (uncompressed) variable values for fast access by the heuristic.
+    It gives access to the variable values of a registered state. Values are
+    unpacked on the fly in State::operator[].
     A State is always registered in a StateRegistry and has a valid ID.
     States can be constructed from a StateRegistry by factory methods for the
     initial state and successor states.
@@ -28,11 +30,14 @@
     is why ids are intended for long term storage (e.g. in open lists).
     Internally, a StateID is just an integer, so it is cheap to store and copy.
 
-  state_var_t*
-    The actual state data is internally represented as a state_var_t array.
-    To minimize allocation overhead, the implementation stores the data of many
-    such states in a single large array (see SegmentedArrayVector)
-    Currently there is no difference between compressed and uncompressed states.
+  PackedStateBin*
+    The actual state data is internally represented as a PackedStateBin array.
+    Each variable v only uses ceil(log2(g_variable_domain[v])) bits of such an
+    array (see IntPacker and g_state_packer), so the state data of a task with
+    many binary variables only needs a fraction of the memory of an unpacked
+    representation. To minimize allocation overhead, the implementation stores
+    the data of many such states in a single large array
+    (see SegmentedArrayVector).
 
   -------------
 
@@ -42,7 +47,7 @@
     The StateRegistry also stores the actual state data in a memory friendly way.
     It uses the following class:
 
-  SegmentedArrayVector<state_var_t>
+  SegmentedArrayVector<PackedStateBin>
     This class is used to store the actual state data for all states
     while avoiding dynamically allocating each state individually.
     The index within this vector corresponds to the ID of the state.
@@ -94,47 +99,94 @@
 */
 
 class StateRegistry {
+    /*
+      Hashing and comparing work directly on the packed data. This is
+      sound because unused bits of a bin are always zero (see
+      get_initial_state).
+
+      With incremental hashing, state_hashes contains the hash value of
+      every state in state_data_pool (computed when the state is created),
+      otherwise it is empty and the packed data is hashed.
+    */
     struct StateIDSemanticHash {
-        const SegmentedArrayVector<state_var_t> &state_data_pool;
-        StateIDSemanticHash(const SegmentedArrayVector<state_var_t> &state_data_pool_)
-            : state_data_pool (state_data_pool_) {
+        const SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const SegmentedVector<unsigned int> &state_hashes;
+        StateIDSemanticHash(const SegmentedArrayVector<PackedStateBin> &state_data_pool_,
+                            const SegmentedVector<unsigned int> &state_hashes_)
+            : state_data_pool (state_data_pool_),
+              state_hashes (state_hashes_) {
         }
-        size_t operator() (StateID id) const {
-            return ::hash_number_sequence(state_data_pool[id.value], g_variable_domain.size());
+        size_t operator() (int id) const {
+            if (state_hashes.size() != 0)
+                return state_hashes[id];
+            return ::hash_number_sequence(state_data_pool[id],
+                                          g_state_packer->get_num_bins());
         }
     };
 
     struct StateIDSemanticEqual {
-        const SegmentedArrayVector<state_var_t> &state_data_pool;
-        StateIDSemanticEqual(const SegmentedArrayVector<state_var_t> &state_data_pool_)
+        const SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        StateIDSemanticEqual(const SegmentedArrayVector<PackedStateBin> &state_data_pool_)
             : state_data_pool (state_data_pool_) {
         }
 
-        size_t operator() (StateID lhs, StateID rhs) const {
-            size_t size = g_variable_domain.size();
-            const state_var_t *lhs_data = state_data_pool[lhs.value];
-            const state_var_t *rhs_data = state_data_pool[rhs.value];
+        bool operator() (int lhs, int rhs) const {
+            size_t size = g_state_packer->get_num_bins();
+            const PackedStateBin *lhs_data = state_data_pool[lhs];
+            const PackedStateBin *rhs_data = state_data_pool[rhs];
             return std::equal(lhs_data, lhs_data + size, rhs_data);
         }
     };
 
     /*
-      Hash set of StateIDs used to detect states that are already registered in
-      this registry and find their IDs. States are compared/hashed semantically,
-      i.e. the actual state data is compared, not the memory location.
+      Hash set of StateIDs (stored as ints) used to detect states that are
+      already registered in this registry and find their IDs. States are
+      compared/hashed semantically, i.e. the actual state data is compared,
+      not the memory location.
     */
-    typedef __gnu_cxx::hash_set<StateID,
-                                StateIDSemanticHash,
-                                StateIDSemanticEqual> StateIDSet;
+    typedef IntHashSet<StateIDSemanticHash, StateIDSemanticEqual> StateIDSet;
 
-    SegmentedArrayVector<state_var_t> state_data_pool;
+    AxiomEvaluator &axiom_evaluator;
+    SegmentedArrayVector<PackedStateBin> state_data_pool;
+    SegmentedVector<unsigned int> state_hashes;
     StateIDSet registered_states;
     State *cached_initial_state;
+
+    /*
+      Zobrist hashing: the hash value of a state is the XOR of one random
+      key per fact of the state, so the hash value of a successor can be
+      computed from the hash value of its predecessor by exchanging the
+      keys of the changed facts. zobrist_keys[var][value] is the key of
+      fact var=value. Only used with incremental hashing.
+    */
+    bool use_incremental_hashing;
+    std::vector<std::vector<unsigned int> > zobrist_keys;
+    std::vector<int> derived_variables;
+
+    unsigned int compute_zobrist_hash(const PackedStateBin *buffer) const;
+    void apply_effects(const State &predecessor, const Operator &op,
+                       PackedStateBin *buffer) const;
     StateID insert_id_or_pop_state();
 public:
     StateRegistry();
+    /*
+      Creates a registry that evaluates axioms with the given evaluator
+      instead of g_axiom_evaluator. Evaluating axioms modifies the
+      evaluator, so registries that are used by different threads need
+      separate evaluators.
+    */
+    explicit StateRegistry(AxiomEvaluator &axiom_evaluator_);
     ~StateRegistry();
 
+    /*
+      Switches from hashing the full state data of every new state to
+      Zobrist hashing, where the hash value of a successor state is updated
+      from the cached hash value of its predecessor in time linear in the
+      number of changed variables. This costs 4 bytes of memory per state.
+      Must be called before the first state is registered.
+    */
+    void enable_incremental_hashing();
+
     /*
       Returns the state that was registered at the given ID. The ID must refer
       to a state in this registry. Do not mix IDs from from different registries.
@@ -154,6 +206,21 @@ public:
     */
     State get_successor_state(const State &predecessor, const Operator &op);
 
+    /*
+      The following methods allow to create states without registering
+      them, e.g. to hand them over to a different registry. Buffers must
+      have room for g_state_packer->get_num_bins() bins.
+
+      compute_initial_state_data and compute_successor_data write the
+      packed data of the initial state or of the successor of predecessor
+      under op into buffer. register_state registers the state with the
+      given packed data if this was not done before and returns it.
+    */
+    void compute_initial_state_data(PackedStateBin *buffer);
+    void compute_successor_data(const State &predecessor, const Operator &op,
+                                PackedStateBin *buffer);
+    State register_state(const PackedStateBin *buffer);
+
     /*
       Returns the number of states registered so far.
     */
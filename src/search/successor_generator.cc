@@ -2,6 +2,7 @@
 #include "operator.h"
 #include "state.h"
 #include "successor_generator.h"
+#include "task_reader.h"
 #include "utilities.h"
 
 #include <cstdlib>
@@ -9,85 +10,139 @@
 #include <vector>
 using namespace std;
 
-class SuccessorGeneratorSwitch : public SuccessorGenerator {
-    int switch_var;
-    SuccessorGenerator *immediate_ops;
-    vector<SuccessorGenerator *> generator_for_value;
-    SuccessorGenerator *default_generator;
-public:
-    SuccessorGeneratorSwitch(istream &in);
-    virtual void generate_applicable_ops(const State &curr,
-                                         vector<const Operator *> &ops);
-    virtual void _dump(string indent);
-};
+static void exit_with_illegal_statement(const string &expected, const string &type)
+    __attribute__((noreturn));
 
-class SuccessorGeneratorGenerate : public SuccessorGenerator {
-    vector<const Operator *> op;
-public:
-    SuccessorGeneratorGenerate(istream &in);
-    virtual void generate_applicable_ops(const State &curr,
-                                         vector<const Operator *> &ops);
-    virtual void _dump(string indent);
-};
+static void exit_with_illegal_statement(const string &expected, const string &type) {
+    cout << "Illegal successor generator statement!" << endl;
+    cout << "Expected " << expected << ", got '" << type << "'." << endl;
+    exit_with(EXIT_INPUT_ERROR);
+}
 
-SuccessorGeneratorSwitch::SuccessorGeneratorSwitch(istream &in) {
-    in >> switch_var;
-    immediate_ops = read_successor_generator(in);
-    for (int i = 0; i < g_variable_domain[switch_var]; i++)
-        generator_for_value.push_back(read_successor_generator(in));
-    default_generator = read_successor_generator(in);
+SuccessorGenerator::SuccessorGenerator(TaskReader &in) {
+    root = read_node(in);
 }
 
-void SuccessorGeneratorSwitch::generate_applicable_ops(
-    const State &curr, vector<const Operator *> &ops) {
-    immediate_ops->generate_applicable_ops(curr, ops);
-    generator_for_value[curr[switch_var]]->generate_applicable_ops(curr, ops);
-    default_generator->generate_applicable_ops(curr, ops);
+SuccessorGenerator::~SuccessorGenerator() {
 }
 
-void SuccessorGeneratorSwitch::_dump(string indent) {
-    cout << indent << "switch on " << g_variable_name[switch_var] << endl;
-    cout << indent << "immediately:" << endl;
-    immediate_ops->_dump(indent + "  ");
-    for (int i = 0; i < g_variable_domain[switch_var]; i++) {
-        cout << indent << "case " << i << ":" << endl;
-        generator_for_value[i]->_dump(indent + "  ");
-    }
-    cout << indent << "always:" << endl;
-    default_generator->_dump(indent + "  ");
+int SuccessorGenerator::add_node(int switch_var, int first_op, int last_op,
+                                 int first_child, int default_child) {
+    Node node;
+    node.switch_var = switch_var;
+    node.first_op = first_op;
+    node.last_op = last_op;
+    node.first_child = first_child;
+    node.default_child = default_child;
+    nodes.push_back(node);
+    return nodes.size() - 1;
 }
 
-void SuccessorGeneratorGenerate::generate_applicable_ops(const State &,
-                                                         vector<const Operator *> &ops) {
-    ops.insert(ops.end(), op.begin(), op.end());
+int SuccessorGenerator::read_node(TaskReader &in) {
+    string type;
+    in >> type;
+    if (type == "switch") {
+        return read_switch(in);
+    } else if (type == "check") {
+        return read_leaf(in);
+    }
+    exit_with_illegal_statement("'switch' or 'check'", type);
 }
 
-SuccessorGeneratorGenerate::SuccessorGeneratorGenerate(istream &in) {
+int SuccessorGenerator::read_leaf(TaskReader &in) {
     int count;
     in >> count;
+    if (count == 0)
+        return NO_NODE;
+    int first_op = operators.size();
     for (int i = 0; i < count; i++) {
         int op_index;
         in >> op_index;
-        op.push_back(&g_operators[op_index]);
+        operators.push_back(&g_operators[op_index]);
     }
+    return add_node(NO_VARIABLE, first_op, operators.size(), -1, NO_NODE);
 }
 
-void SuccessorGeneratorGenerate::_dump(string indent) {
-    for (int i = 0; i < op.size(); i++) {
-        cout << indent;
-        op[i]->dump();
-    }
-}
+int SuccessorGenerator::read_switch(TaskReader &in) {
+    int switch_var;
+    in >> switch_var;
 
-SuccessorGenerator *read_successor_generator(istream &in) {
+    // The immediate operators of a switch are always given as a leaf.
     string type;
     in >> type;
-    if (type == "switch") {
-        return new SuccessorGeneratorSwitch(in);
-    } else if (type == "check") {
-        return new SuccessorGeneratorGenerate(in);
+    if (type != "check")
+        exit_with_illegal_statement("'check'", type);
+    int count;
+    in >> count;
+    int first_op = operators.size();
+    for (int i = 0; i < count; i++) {
+        int op_index;
+        in >> op_index;
+        operators.push_back(&g_operators[op_index]);
     }
-    cout << "Illegal successor generator statement!" << endl;
-    cout << "Expected 'switch' or 'check', got '" << type << "'." << endl;
-    exit_with(EXIT_INPUT_ERROR);
+    int last_op = operators.size();
+
+    vector<int> children;
+    bool has_value_children = false;
+    for (int i = 0; i < g_variable_domain[switch_var]; i++) {
+        children.push_back(read_node(in));
+        if (children.back() != NO_NODE)
+            has_value_children = true;
+    }
+    int default_child = read_node(in);
+
+    if (!has_value_children) {
+        // No need to look at switch_var.
+        if (first_op == last_op)
+            return default_child;
+        return add_node(NO_VARIABLE, first_op, last_op, -1, default_child);
+    }
+    int first_child = value_children.size();
+    value_children.insert(value_children.end(), children.begin(), children.end());
+    return add_node(switch_var, first_op, last_op, first_child, default_child);
+}
+
+void SuccessorGenerator::generate_applicable_ops_recursive(
+    int node_index, const State &curr, vector<const Operator *> &ops) const {
+    // Iterate instead of recursing into the default child.
+    do {
+        const Node &node = nodes[node_index];
+        if (node.first_op != node.last_op)
+            ops.insert(ops.end(),
+                       operators.begin() + node.first_op,
+                       operators.begin() + node.last_op);
+        if (node.switch_var != NO_VARIABLE) {
+            int child = value_children[node.first_child + curr[node.switch_var]];
+            if (child != NO_NODE)
+                generate_applicable_ops_recursive(child, curr, ops);
+        }
+        node_index = node.default_child;
+    } while (node_index != NO_NODE);
+}
+
+void SuccessorGenerator::dump_recursive(int node_index, const string &indent) const {
+    if (node_index == NO_NODE) {
+        cout << indent << "<empty>" << endl;
+        return;
+    }
+    const Node &node = nodes[node_index];
+    if (node.switch_var != NO_VARIABLE)
+        cout << indent << "switch on " << g_variable_name[node.switch_var] << endl;
+    cout << indent << "immediately:" << endl;
+    for (int i = node.first_op; i < node.last_op; i++) {
+        cout << indent << "  ";
+        operators[i]->dump();
+    }
+    if (node.switch_var != NO_VARIABLE) {
+        for (int i = 0; i < g_variable_domain[node.switch_var]; i++) {
+            cout << indent << "case " << i << ":" << endl;
+            dump_recursive(value_children[node.first_child + i], indent + "  ");
+        }
+    }
+    cout << indent << "always:" << endl;
+    dump_recursive(node.default_child, indent + "  ");
+}
+
+SuccessorGenerator *read_successor_generator(TaskReader &in) {
+    return new SuccessorGenerator(in);
 }
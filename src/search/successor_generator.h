@@ -2,20 +2,68 @@
 #define SUCCESSOR_GENERATOR_H
 
 #include <iostream>
+#include <string>
 #include <vector>
 
 class Operator;
 class State;
+class TaskReader;
 
+/*
+  The successor generator is a decision tree over the variables of the
+  task as computed by the preprocessor. Each inner node switches on the
+  value of one variable and contains the operators whose preconditions
+  are completely tested at this point ("immediate" operators), a child
+  for each value of the variable and a "default" child for the operators
+  that have no precondition on the variable.
+
+  The tree is compiled into a flat representation when it is read:
+  all nodes live in one array and refer to their children by index, the
+  operators of all nodes are stored consecutively in one array (each node
+  owns a range of it), and empty subtrees are removed. A switch node
+  without immediate operators and value children is replaced by its
+  default child.
+*/
 class SuccessorGenerator {
+    static const int NO_NODE = -1;
+    // Marks leaf nodes, i.e., nodes without children.
+    static const int NO_VARIABLE = -1;
+
+    struct Node {
+        int switch_var;
+        // The immediate operators are operators[first_op, last_op).
+        int first_op;
+        int last_op;
+        // The child for value v of switch_var is value_children[first_child + v].
+        int first_child;
+        int default_child;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<const Operator *> operators;
+    std::vector<int> value_children;
+    int root;
+
+    int read_node(TaskReader &in);
+    int read_leaf(TaskReader &in);
+    int read_switch(TaskReader &in);
+    int add_node(int switch_var, int first_op, int last_op,
+                 int first_child, int default_child);
+    void generate_applicable_ops_recursive(
+        int node_index, const State &curr, std::vector<const Operator *> &ops) const;
+    void dump_recursive(int node_index, const std::string &indent) const;
 public:
-    virtual ~SuccessorGenerator() {}
-    virtual void generate_applicable_ops(const State &curr,
-                                         std::vector<const Operator *> &ops) = 0;
-    void dump() {_dump("  "); }
-    virtual void _dump(std::string indent) = 0;
+    explicit SuccessorGenerator(TaskReader &in);
+    ~SuccessorGenerator();
+
+    void generate_applicable_ops(const State &curr,
+                                 std::vector<const Operator *> &ops) const {
+        if (root != NO_NODE)
+            generate_applicable_ops_recursive(root, curr, ops);
+    }
+    void dump() const {dump_recursive(root, "  "); }
 };
 
-SuccessorGenerator *read_successor_generator(std::istream &in);
+SuccessorGenerator *read_successor_generator(TaskReader &in);
 
 #endif
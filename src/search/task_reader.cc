@@ -0,0 +1,113 @@
+#include "task_reader.h"
+
+#include "utilities.h"
+
+#include <iostream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+// The header line of a binary image starts with this word.
+static const char IMAGE_MAGIC[] = "task_image";
+
+TaskReader::TaskReader(istream &in_)
+    : in(in_), pos(0), end(0), mapped_data(0), mapped_size(0) {
+    if (in.peek() == IMAGE_MAGIC[0])
+        open_binary_image();
+}
+
+TaskReader::~TaskReader() {
+    if (mapped_data)
+        munmap(mapped_data, mapped_size);
+}
+
+void TaskReader::exit_with_format_error(const string &message) const {
+    cerr << "Invalid task image: " << message << "." << endl;
+    exit_with(EXIT_INPUT_ERROR);
+}
+
+void TaskReader::open_binary_image() {
+    const char *data = 0;
+    size_t size = 0;
+    struct stat file_status;
+    if (&in == &cin && fstat(STDIN_FILENO, &file_status) == 0 &&
+        S_ISREG(file_status.st_mode) && file_status.st_size > 0) {
+        // Standard input is a file, which we map as a whole.
+        mapped_size = file_status.st_size;
+        mapped_data = mmap(0, mapped_size, PROT_READ, MAP_PRIVATE, STDIN_FILENO, 0);
+        if (mapped_data == MAP_FAILED) {
+            mapped_data = 0;
+        } else {
+            data = static_cast<const char *>(mapped_data);
+            size = mapped_size;
+        }
+    }
+    if (!data) {
+        char chunk[1 << 16];
+        while (in.read(chunk, sizeof(chunk)) || in.gcount() > 0)
+            buffer.insert(buffer.end(), chunk, chunk + in.gcount());
+        data = &buffer[0];
+        size = buffer.size();
+    }
+
+    const char *header_end = static_cast<const char *>(memchr(data, '\n', size));
+    if (!header_end)
+        exit_with_format_error("missing header");
+    istringstream header(string(data, header_end));
+    string magic;
+    int version = -1;
+    header >> magic >> version;
+    if (magic != IMAGE_MAGIC)
+        exit_with_format_error("missing header");
+    if (version != TASK_IMAGE_VERSION) {
+        ostringstream message;
+        message << "expected version " << TASK_IMAGE_VERSION << ", got " << version;
+        exit_with_format_error(message.str());
+    }
+
+    // The items start at the next multiple of 4 bytes after the header.
+    size_t offset = (header_end - data + 1 + 3) / 4 * 4;
+    if (offset > size)
+        exit_with_format_error("unexpected end of task image");
+    pos = data + offset;
+    end = data + size;
+    if (read_binary_int() != BYTE_ORDER_MARK)
+        exit_with_format_error("the image was written on a machine with a "
+                               "different byte order");
+}
+
+void TaskReader::read_binary_string(string &value) {
+    int length = read_binary_int();
+    int padded_length = (length + 3) / 4 * 4;
+    if (length < 0 || end - pos < padded_length)
+        exit_with_format_error("unexpected end of task image");
+    value.assign(pos, length);
+    pos += padded_length;
+}
+
+TaskReader &TaskReader::operator>>(bool &value) {
+    if (pos)
+        value = read_binary_int();
+    else
+        in >> value;
+    return *this;
+}
+
+TaskReader &TaskReader::operator>>(string &value) {
+    if (pos)
+        read_binary_string(value);
+    else
+        in >> value;
+    return *this;
+}
+
+void TaskReader::read_line(string &line) {
+    if (pos) {
+        read_binary_string(line);
+    } else {
+        in >> ws;
+        getline(in, line);
+    }
+}
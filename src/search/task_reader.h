@@ -0,0 +1,79 @@
+#ifndef TASK_READER_H
+#define TASK_READER_H
+
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <vector>
+
+/*
+  Reads the output of the preprocessor, which is either in the text
+  format or a binary task image (see TaskWriter in the preprocessor).
+  The format is detected from the first character of the input.
+
+  Both formats contain the same items in the same order, so the code
+  that reads the task only uses the operators >> and read_line and does
+  not depend on the format. Reading an item of a binary image only
+  copies an integer (or the characters of a string) instead of parsing
+  text, which makes loading large tasks much faster.
+
+  If the input is standard input redirected from a file (as in the
+  planner scripts), the image is mapped into memory with mmap instead of
+  being copied, so that the processes of a portfolio share the pages of
+  the task file in the page cache.
+*/
+class TaskReader {
+    std::istream &in;
+    // Position and end of the items of a binary image; 0 for text input.
+    const char *pos;
+    const char *end;
+    // Memory of a binary image: either mapped or copied into buffer.
+    void *mapped_data;
+    std::size_t mapped_size;
+    std::vector<char> buffer;
+
+    void open_binary_image();
+    void exit_with_format_error(const std::string &message) const
+        __attribute__((noreturn));
+
+    int read_binary_int() {
+        if (end - pos < static_cast<std::ptrdiff_t>(sizeof(int)))
+            exit_with_format_error("unexpected end of task image");
+        int value;
+        std::memcpy(&value, pos, sizeof(int));
+        pos += sizeof(int);
+        return value;
+    }
+    void read_binary_string(std::string &value);
+
+    // Not implemented.
+    TaskReader(const TaskReader &);
+    TaskReader &operator=(const TaskReader &);
+public:
+    static const int TASK_IMAGE_VERSION = 1;
+    static const int BYTE_ORDER_MARK = 0x01020304;
+
+    explicit TaskReader(std::istream &in);
+    ~TaskReader();
+
+    bool is_binary() const {
+        return pos != 0;
+    }
+
+    TaskReader &operator>>(int &value);
+    TaskReader &operator>>(bool &value);
+    TaskReader &operator>>(std::string &value);
+    // Reads the rest of the line after skipping whitespace (for names).
+    void read_line(std::string &line);
+};
+
+inline TaskReader &TaskReader::operator>>(int &value) {
+    if (pos)
+        value = read_binary_int();
+    else
+        in >> value;
+    return *this;
+}
+
+#endif
@@ -79,6 +79,9 @@ void exit_with(ExitCode exitcode) {
     case EXIT_TIMEOUT:
         cout << "Time limit has been reached." << endl;
         break;
+    case EXIT_TIMEOUT_AND_MEMORY:
+        cout << "Time limit and memory limit have been reached." << endl;
+        break;
     default:
         cerr << "Exitcode: " << exitcode << endl;
         ABORT("Unkown exitcode.");
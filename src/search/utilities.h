@@ -39,8 +39,11 @@ enum ExitCode {
     // Search ended without finding a solution.
     EXIT_UNSOLVED_INCOMPLETE = 5,
     EXIT_OUT_OF_MEMORY = 6,
-    // Currently unused.
-    EXIT_TIMEOUT = 7
+    // Only used by portfolios (see portfolio.h).
+    EXIT_TIMEOUT = 7,
+    // Some configurations of a portfolio ran out of time, the others
+    // out of memory.
+    EXIT_TIMEOUT_AND_MEMORY = 8
 };
 
 extern void exit_with(ExitCode returncode) __attribute__((noreturn));
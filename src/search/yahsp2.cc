@@ -145,25 +145,8 @@ State YAHSP2::lookahead(vector<const Operator *> &plan, const State &state, vect
 }
 
 void YAHSP2::trace_path(vector<const Operator *> &path, const State &state, SearchSpace &ssp) {
-    StateID current_state_id = state.get_id();
-    while (true) {
-        const SearchNodeInfo &info = ssp.get_node(current_state_id).get_info();
-
-        if (info.steps) { // add operator sequence to plan
-            for (int i = info.steps->size() - 1; i >= 0; i--) {
-                path.push_back((*info.steps)[i]);
-            }
-        } else { // add single operator to plan
-            const Operator *op = info.creating_operator;
-            if (op == 0) {
-                assert(info.parent_state_id == StateID::no_state);
-                break;
-            }
-            path.push_back(op);
-        }
-        current_state_id = info.parent_state_id;
-    }
-    reverse(path.begin(), path.end());
+    // The search space stores the operator sequences of lookahead nodes.
+    ssp.trace_path(state, path);
 }
 
 bool YAHSP2::intersect(vector<const Operator *> ops_add, vector<const Operator *> ops_pre) {